@@ -4,24 +4,22 @@ auto main() -> int
 {
     auto make_http_200_ok_server = [](std::unique_ptr<coro::io_scheduler>& scheduler) -> coro::task<void>
     {
-        auto make_on_connection_task = [](coro::net::tcp::client client) -> coro::task<void>
+        auto make_on_connection_task = [](coro::net::buffer_pool& pool, coro::net::tcp::client client)
+            -> coro::task<void>
         {
             std::string response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
-            std::string buf(1024, '\0');
 
             while (true)
             {
-                // Wait for data to be available to read.
-                co_await client.poll(coro::poll_op::read);
-                auto [rstatus, rspan] = client.recv(buf);
+                // Wait for data to arrive, a receive buffer is only taken from the shared pool once it has.  If
+                // every buffer is busy this waits for another connection to return one.
+                auto [rstatus, buffer] = co_await client.async_recv(pool);
                 switch (rstatus)
                 {
                     case coro::net::recv_status::ok:
-                        // Make sure the client socket can be written to.
-                        co_await client.poll(coro::poll_op::write);
-                        client.send(std::span<const char>{response});
-                        break;
-                    case coro::net::recv_status::would_block:
+                        // Return the buffer to the pool before waiting on the client again.
+                        buffer.release();
+                        co_await client.async_send(response);
                         break;
                     case coro::net::recv_status::closed:
                     default:
@@ -30,6 +28,9 @@ auto main() -> int
             }
         };
 
+        // Idle keep-alive connections share this scheduler's receive buffers instead of each pinning their own.
+        coro::net::buffer_pool pool{
+            scheduler, coro::net::buffer_pool::options{.buffer_size = 1024, .buffer_count = 1024}};
         coro::net::tcp::server server{scheduler, coro::net::tcp::server::options{.port = 8888}};
 
         while (true)
@@ -43,7 +44,7 @@ auto main() -> int
                     auto client = server.accept();
                     if (client.socket().is_valid())
                     {
-                        scheduler->spawn_detached(make_on_connection_task(std::move(client)));
+                        scheduler->spawn_detached(make_on_connection_task(pool, std::move(client)));
                     } // else report error or something if the socket was invalid or could not be accepted.
                 }
                 break;
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "coro/concepts/executor.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+namespace detail
+{
+/// The default barrier completion function, nothing runs between phases.
+struct barrier_no_completion
+{
+    auto operator()() noexcept -> void {}
+};
+
+} // namespace detail
+
+/**
+ * The barrier is a reusable thread safe synchronization point for a fixed number of tasks, each phase
+ * completes once every participating task has arrived at the barrier.  The final task to arrive runs the
+ * optional completion function and then resumes every other task waiting on the phase, the barrier then
+ * resets itself for the next phase.
+ *
+ * This is useful for iterative parallel algorithms where a set of workers must all finish step N before
+ * any of them can begin step N + 1, unlike a coro::latch it does not need to be re-created each round.
+ *
+ * @tparam completion_fn_type A callable that is invoked exactly once per phase by the final task to arrive,
+ *                            before any of the waiting tasks are resumed.
+ */
+template<std::invocable completion_fn_type = detail::barrier_no_completion>
+class barrier
+{
+private:
+    struct awaiter_node
+    {
+        awaiter_node*           m_next{nullptr};
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+    };
+
+public:
+    /**
+     * The operation returned by arrive_and_wait(), if this task completes the phase it does not suspend.
+     * @tparam executor_type The executor to resume the phase's waiters on, void resumes them inline.
+     */
+    template<typename executor_type>
+    class arrive_and_wait_operation : private awaiter_node
+    {
+    public:
+        arrive_and_wait_operation(barrier& b, executor_type* executor) noexcept : m_barrier(b), m_executor(executor)
+        {
+        }
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            this->m_awaiting_coroutine = awaiting_coroutine;
+            // The final task to arrive completes the phase and continues without suspending.
+            return !m_barrier.arrive(this, false, m_executor);
+        }
+
+        auto await_resume() const noexcept -> void {}
+
+    private:
+        barrier&       m_barrier;
+        executor_type* m_executor{nullptr};
+    };
+
+    /**
+     * Creates a barrier for the given number of participating tasks.
+     * @param expected The number of tasks that must arrive to complete each phase.
+     * @param completion The function to run once per phase when the final task arrives.
+     * @throw std::invalid_argument If expected is not positive.
+     */
+    explicit barrier(std::ptrdiff_t expected, completion_fn_type completion = completion_fn_type{})
+        : m_expected(expected),
+          m_remaining(expected),
+          m_completion(std::move(completion))
+    {
+        if (expected <= 0)
+        {
+            throw std::invalid_argument{"coro::barrier expected must be greater than zero"};
+        }
+    }
+    ~barrier() = default;
+
+    barrier(const barrier&)                    = delete;
+    barrier(barrier&&)                         = delete;
+    auto operator=(const barrier&) -> barrier& = delete;
+    auto operator=(barrier&&) -> barrier&      = delete;
+
+    /**
+     * Arrives at the barrier and suspends until every participating task has arrived for this phase.  If this
+     * task completes the phase then the waiters are resumed inline on this thread before it continues.
+     */
+    [[nodiscard]] auto arrive_and_wait() noexcept -> arrive_and_wait_operation<void>
+    {
+        return arrive_and_wait_operation<void>{*this, nullptr};
+    }
+
+    /**
+     * Arrives at the barrier and suspends until every participating task has arrived for this phase.  If this
+     * task completes the phase then the waiters are handed to the executor in a single batch and this task
+     * continues immediately.
+     * @param executor The executor to resume the phase's waiters on.
+     */
+    template<concepts::executor executor_type>
+    [[nodiscard]] auto arrive_and_wait(std::unique_ptr<executor_type>& executor) noexcept
+        -> arrive_and_wait_operation<executor_type>
+    {
+        return arrive_and_wait_operation<executor_type>{*this, executor.get()};
+    }
+
+    /**
+     * Arrives at the barrier for the current phase without waiting and removes this task from all future
+     * phases.  If this completes the phase the waiters are resumed inline on this thread.
+     */
+    auto arrive_and_drop() noexcept -> void { arrive<void>(nullptr, true, nullptr); }
+
+    /**
+     * Arrives at the barrier for the current phase without waiting and removes this task from all future
+     * phases.  If this completes the phase the waiters are resumed on the given executor.
+     * @param executor The executor to resume the phase's waiters on.
+     */
+    template<concepts::executor executor_type>
+    auto arrive_and_drop(std::unique_ptr<executor_type>& executor) noexcept -> void
+    {
+        arrive<executor_type>(nullptr, true, executor.get());
+    }
+
+    /**
+     * @return The number of phases that have completed.
+     */
+    auto phase() const noexcept -> std::uint64_t { return m_phase.load(std::memory_order::acquire); }
+
+    /**
+     * @return The number of tasks participating in each phase.
+     */
+    auto expected() const noexcept -> std::ptrdiff_t
+    {
+        std::scoped_lock lk{m_mutex};
+        return m_expected;
+    }
+
+private:
+    /// Guards the arrival counts and the waiter list, it is never held while resuming a waiter.
+    mutable std::mutex m_mutex{};
+    /// The number of tasks that must arrive to complete a phase.
+    std::ptrdiff_t m_expected;
+    /// The number of tasks that still need to arrive to complete the current phase.
+    std::ptrdiff_t m_remaining;
+    /// The tasks waiting on the current phase.
+    awaiter_node* m_waiters{nullptr};
+    /// The number of completed phases.
+    std::atomic<std::uint64_t> m_phase{0};
+    /// Runs once per phase before the waiters are resumed.
+    completion_fn_type m_completion;
+
+    /**
+     * Arrives at the barrier, queueing the waiter if the phase is not complete yet.
+     * @return True if this arrival completed the phase, the completion function has run and the waiters
+     *         have been resumed.
+     */
+    template<typename executor_type>
+    auto arrive(awaiter_node* waiter, bool drop, executor_type* executor) noexcept -> bool
+    {
+        awaiter_node* waiters{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            if (drop)
+            {
+                --m_expected;
+            }
+
+            if (--m_remaining > 0)
+            {
+                if (waiter != nullptr)
+                {
+                    waiter->m_next = m_waiters;
+                    m_waiters      = waiter;
+                }
+                return false;
+            }
+
+            // Every task has arrived, reset for the next phase.  Nobody can arrive for the next phase
+            // until the waiters are resumed so the completion function can run without the lock.
+            waiters     = std::exchange(m_waiters, nullptr);
+            m_remaining = m_expected;
+        }
+
+        m_completion();
+        m_phase.fetch_add(1, std::memory_order::acq_rel);
+
+        if constexpr (std::is_void_v<executor_type>)
+        {
+            while (waiters != nullptr)
+            {
+                auto* next = waiters->m_next;
+                waiters->m_awaiting_coroutine.resume();
+                waiters = next;
+            }
+        }
+        else
+        {
+            resume_waiters(*executor, waiters);
+        }
+
+        return true;
+    }
+
+    /**
+     * Hands the phase's waiters to the executor in a single batch.  Any waiter the executor refuses (e.g. it is
+     * shutting down) is resumed inline, if the batch cannot be allocated the waiters are handed over one by one.
+     */
+    template<typename executor_type>
+    static auto resume_waiters(executor_type& executor, awaiter_node* waiters) noexcept -> void
+    {
+        std::size_t count{0};
+        for (auto* w = waiters; w != nullptr; w = w->m_next)
+        {
+            ++count;
+        }
+
+        std::vector<std::coroutine_handle<>> handles{};
+        try
+        {
+            handles.reserve(count);
+        }
+        catch (const std::bad_alloc&)
+        {
+            while (waiters != nullptr)
+            {
+                auto* next = waiters->m_next;
+                if (!executor.resume(waiters->m_awaiting_coroutine))
+                {
+                    waiters->m_awaiting_coroutine.resume();
+                }
+                waiters = next;
+            }
+            return;
+        }
+
+        for (auto* w = waiters; w != nullptr; w = w->m_next)
+        {
+            handles.emplace_back(w->m_awaiting_coroutine);
+        }
+
+        if (executor.resume(handles) == 0)
+        {
+            for (auto& handle : handles)
+            {
+                handle.resume();
+            }
+        }
+    }
+};
+
+} // namespace coro
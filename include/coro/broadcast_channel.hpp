@@ -0,0 +1,774 @@
+#pragma once
+
+#include "coro/detail/asymmetric_fence.hpp"
+#include "coro/expected.hpp"
+#include "coro/ring_buffer.hpp"
+#include "coro/task.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+/**
+ * The policy a coro::broadcast_channel applies when it is full because its slowest subscriber has not
+ * consumed the oldest element yet.
+ */
+enum class broadcast_lag_policy
+{
+    /// @brief The oldest element is overwritten, lagging subscribers skip it and record it in dropped().
+    drop_oldest,
+    /// @brief The producer suspends until the slowest subscriber has consumed the oldest element.
+    block_producer
+};
+
+/**
+ * A bounded multi-producer broadcast channel, every element produced is delivered to every subscriber.
+ * The elements are stored exactly once in a single ring and each subscriber keeps its own read cursor
+ * into the ring, consuming an element copies it out of the ring so `element` must be copy constructible.
+ *
+ * Consuming never takes the channel's lock.  Every subscriber owns an atomic cursor and every slot carries the
+ * sequence number of the element it holds, so a subscriber that lagged behind notices the overwritten slot
+ * itself and producers never walk the subscribers to move them forward.  The lock only guards the list of
+ * subscribers and the suspended producers and consumers.
+ *
+ * Subscribers only observe the elements produced after they subscribed.  A subscriber must not outlive
+ * the channel it is subscribed to.
+ *
+ * @tparam element The type of element the channel will store.
+ * @tparam num_elements The maximum number of elements the channel can hold before the lag policy applies,
+ *         must be >= 1.
+ */
+template<typename element, std::size_t num_elements>
+class broadcast_channel
+{
+    static_assert(num_elements != 0, "num_elements cannot be zero");
+
+    /// The assumed cache line size, the producers' and consumers' hot counters are kept on separate lines.
+    static constexpr std::size_t cache_line_size = 64;
+
+public:
+    class subscriber;
+
+    struct consume_operation
+    {
+        explicit consume_operation(subscriber& s) : m_subscriber(s) {}
+
+        auto await_ready() -> bool { return m_subscriber.m_channel.try_complete(*this); }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+            return m_subscriber.m_channel.park(*this);
+        }
+
+        /**
+         * @return The consumed element or ring_buffer_result::consume::stopped if the channel has been
+         *         shutdown and this subscriber has consumed every remaining element.
+         */
+        auto await_resume() -> expected<element, ring_buffer_result::consume>
+        {
+            if (m_e.has_value())
+            {
+                return expected<element, ring_buffer_result::consume>(std::move(m_e).value());
+            }
+            return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
+        }
+
+    private:
+        friend broadcast_channel<element, num_elements>;
+
+        /// The subscriber consuming the element.
+        subscriber& m_subscriber;
+        /// The consumed element.
+        std::optional<element> m_e{std::nullopt};
+        /// The coroutine to resume when an element has been produced.
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        /// The next waiting consumer.
+        consume_operation* m_next{nullptr};
+    };
+
+    /**
+     * A read cursor into a coro::broadcast_channel, the subscriber is registered with the channel for its
+     * entire lifetime.  A single subscriber must only be consumed from by one coroutine at a time.
+     */
+    class subscriber
+    {
+    public:
+        /**
+         * Subscribes to the channel, only elements produced from this point on are observed.
+         * @param channel The channel to subscribe to.
+         */
+        explicit subscriber(broadcast_channel<element, num_elements>& channel) : m_channel(channel)
+        {
+            std::scoped_lock lk{m_channel.m_mutex};
+            m_cursor.store(m_channel.m_claimed.load(std::memory_order::acquire), std::memory_order::relaxed);
+            m_channel.m_subscribers.emplace_back(this);
+        }
+
+        ~subscriber()
+        {
+            produce_operation* producers{nullptr};
+            {
+                std::scoped_lock lk{m_channel.m_mutex};
+                std::erase(m_channel.m_subscribers, this);
+                // This subscriber might have been the one holding back a blocked producer.
+                producers = m_channel.take_ready_producers_locked();
+            }
+            m_channel.resume_all(producers);
+        }
+
+        subscriber(const subscriber&)                    = delete;
+        subscriber(subscriber&&)                         = delete;
+        auto operator=(const subscriber&) -> subscriber& = delete;
+        auto operator=(subscriber&&) -> subscriber&      = delete;
+
+        /**
+         * Consumes the next element for this subscriber, suspending until one is produced if this
+         * subscriber has already consumed every element in the channel.
+         */
+        [[nodiscard]] auto consume() -> consume_operation { return consume_operation{*this}; }
+
+        /**
+         * @return The number of elements this subscriber has not yet consumed that are still in the ring.
+         */
+        [[nodiscard]] auto size() const -> std::size_t
+        {
+            return static_cast<std::size_t>(std::min<std::uint64_t>(behind(), num_elements));
+        }
+
+        /**
+         * @return The number of elements this subscriber skipped, or will skip, because it lagged behind the
+         *         producers under broadcast_lag_policy::drop_oldest.
+         */
+        [[nodiscard]] auto dropped() const -> std::uint64_t
+        {
+            auto lag = behind();
+            return m_dropped.load(std::memory_order::relaxed) + (lag > num_elements ? lag - num_elements : 0);
+        }
+
+    private:
+        friend broadcast_channel<element, num_elements>;
+        friend consume_operation;
+
+        auto behind() const -> std::uint64_t
+        {
+            // The cursor can briefly pass the tail, a slot is written before the tail moves past it.
+            auto tail   = m_channel.m_tail.load(std::memory_order::acquire);
+            auto cursor = m_cursor.load(std::memory_order::acquire);
+            return tail > cursor ? tail - cursor : 0;
+        }
+
+        /// The channel this subscriber reads from.
+        broadcast_channel<element, num_elements>& m_channel;
+        /// The sequence number of the next element this subscriber will consume, only written by the
+        /// subscriber and read by blocked producers.
+        alignas(cache_line_size) std::atomic<std::uint64_t> m_cursor{0};
+        /// The number of elements skipped due to lagging, only written by the subscriber.
+        std::atomic<std::uint64_t> m_dropped{0};
+    };
+
+    /**
+     * @param policy The policy to apply when the slowest subscriber lags a full ring behind the producers.
+     */
+    explicit broadcast_channel(broadcast_lag_policy policy = broadcast_lag_policy::block_producer) : m_policy(policy)
+    {
+    }
+
+    ~broadcast_channel()
+    {
+        // Wake up anyone still using the channel.
+        shutdown();
+    }
+
+    broadcast_channel(const broadcast_channel<element, num_elements>&) = delete;
+    broadcast_channel(broadcast_channel<element, num_elements>&&)      = delete;
+
+    auto operator=(const broadcast_channel<element, num_elements>&) noexcept
+        -> broadcast_channel<element, num_elements>& = delete;
+    auto operator=(broadcast_channel<element, num_elements>&&) noexcept
+        -> broadcast_channel<element, num_elements>& = delete;
+
+    /**
+     * @return A new subscriber that observes every element produced from now on.
+     */
+    [[nodiscard]] auto subscribe() -> subscriber { return subscriber{*this}; }
+
+    /**
+     * Produces the given element to every subscriber.
+     * @param e The element to produce.
+     * @return ring_buffer_result::produce::stopped if the channel has been shutdown.
+     */
+    auto produce(element e) -> coro::task<ring_buffer_result::produce>
+    {
+        co_return co_await produce_range(std::views::single(std::move(e)));
+    }
+
+    /**
+     * Produces every element of the range to every subscriber.  Each element claims the next sequence number
+     * and is written into its slot without taking the channel's lock, the waiting subscribers are resumed in
+     * a single pass once as many elements as fit have been written.  Under broadcast_lag_policy::block_producer
+     * the producer suspends whenever the slowest subscriber is a full ring behind.  If the range is an rvalue
+     * its elements are moved into the ring, otherwise they are copied.
+     *
+     * @param elements The elements being produced.
+     * @return ring_buffer_result::produce::stopped if the channel was shutdown before every element was produced.
+     */
+    template<std::ranges::input_range range_type>
+        requires std::constructible_from<element, std::ranges::range_reference_t<range_type>>
+    auto produce_range(range_type&& elements) -> coro::task<ring_buffer_result::produce>
+    {
+        auto it  = std::ranges::begin(elements);
+        auto end = std::ranges::end(elements);
+
+        while (it != end)
+        {
+            bool full{false};
+            bool produced{false};
+            try
+            {
+                for (; it != end; ++it)
+                {
+                    if (m_stopped.load(std::memory_order::acquire))
+                    {
+                        break;
+                    }
+
+                    auto sequence = claim();
+                    if (!sequence.has_value())
+                    {
+                        full = true;
+                        break;
+                    }
+
+                    if constexpr (std::is_lvalue_reference_v<range_type>)
+                    {
+                        write(sequence.value(), *it);
+                    }
+                    else
+                    {
+                        write(sequence.value(), std::ranges::iter_move(it));
+                    }
+                    produced = true;
+                }
+            }
+            catch (...)
+            {
+                if (produced)
+                {
+                    wake_consumers();
+                }
+                throw;
+            }
+
+            if (produced)
+            {
+                wake_consumers();
+            }
+
+            if (full)
+            {
+                co_await produce_operation{*this};
+            }
+            else if (it != end)
+            {
+                co_return ring_buffer_result::produce::stopped;
+            }
+        }
+
+        co_return ring_buffer_result::produce::produced;
+    }
+
+    /**
+     * Shuts down the channel, suspended producers are woken up with produce::stopped and no more elements
+     * can be produced.  Subscribers can still consume the elements remaining in the channel, once a subscriber
+     * has consumed every element it is woken up with consume::stopped.
+     */
+    auto shutdown() -> void
+    {
+        consume_operation* consumers{nullptr};
+        produce_operation* producers{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            if (m_stopped.exchange(true, std::memory_order::seq_cst))
+            {
+                return;
+            }
+            consumers = std::exchange(m_consumer_waiters, nullptr);
+            producers = std::exchange(m_producer_waiters, nullptr);
+            m_consumers_waiting.store(false, std::memory_order::relaxed);
+            m_producers_waiting.store(false, std::memory_order::relaxed);
+        }
+
+        resume_all(producers);
+        complete_all(consumers);
+    }
+
+    /**
+     * @return True if shutdown() has been called on this coro::broadcast_channel.
+     */
+    [[nodiscard]] auto is_shutdown() const -> bool { return m_stopped.load(std::memory_order::acquire); }
+
+    /**
+     * @return The number of currently registered subscribers.
+     */
+    [[nodiscard]] auto subscriber_count() const -> std::size_t
+    {
+        std::scoped_lock lk{m_mutex};
+        return m_subscribers.size();
+    }
+
+private:
+    struct produce_operation
+    {
+        explicit produce_operation(broadcast_channel<element, num_elements>& channel) : m_channel(channel) {}
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool
+        {
+            // A consumer may resume this producer as soon as it is queued, only locals are used from then on.
+            auto& channel        = m_channel;
+            m_awaiting_coroutine = awaiting_coroutine;
+            {
+                std::scoped_lock lk{channel.m_mutex};
+                m_next = std::exchange(channel.m_producer_waiters, this);
+                channel.m_producers_waiting.store(true, std::memory_order::relaxed);
+            }
+
+            // Pairs with the light fence a consumer issues after moving its cursor.
+            detail::asymmetric_fence_heavy();
+
+            std::scoped_lock lk{channel.m_mutex};
+            // The slowest subscriber could have caught up since the producer was queued.
+            if (!channel.m_stopped.load(std::memory_order::acquire) && !channel.has_space_locked())
+            {
+                return true;
+            }
+            if (!channel.unlink_locked(channel.m_producer_waiters, this))
+            {
+                // A consumer already took this producer and is resuming it.
+                return true;
+            }
+            if (channel.m_producer_waiters == nullptr)
+            {
+                channel.m_producers_waiting.store(false, std::memory_order::relaxed);
+            }
+            return false;
+        }
+
+        auto await_resume() const noexcept -> void {}
+
+        /// The channel being produced into.
+        broadcast_channel<element, num_elements>& m_channel;
+        /// The coroutine to resume once there is space in the ring.
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        /// The next waiting producer.
+        produce_operation* m_next{nullptr};
+    };
+
+    /// A single element of the ring.
+    struct slot
+    {
+        /// One past the sequence number of the element in the slot, zero until the first element is written.
+        std::atomic<std::uint64_t> m_sequence{0};
+        /// Under broadcast_lag_policy::drop_oldest the number of subscribers copying the element, plus
+        /// slot_writer while a producer overwrites it.
+        std::atomic<std::uint32_t> m_guard{0};
+        /// The element, empty if constructing it threw.
+        std::optional<element> m_element{std::nullopt};
+    };
+
+    /// The m_guard bit a producer holds while overwriting a slot.
+    static constexpr std::uint32_t slot_writer = std::uint32_t{1} << 31;
+
+    friend consume_operation;
+    friend subscriber;
+
+    /**
+     * Claims the next sequence number to produce into.
+     * @return The sequence number, or empty under broadcast_lag_policy::block_producer if the slowest
+     *         subscriber is a full ring behind.
+     */
+    auto claim() -> std::optional<std::uint64_t>
+    {
+        auto sequence = m_claimed.load(std::memory_order::relaxed);
+        while (true)
+        {
+            // The cached minimum cursor is only a lower bound since cursors only move forward, it is
+            // recomputed when the ring appears full.
+            if (m_policy == broadcast_lag_policy::block_producer &&
+                sequence - m_min_cursor.load(std::memory_order::acquire) >= num_elements)
+            {
+                std::scoped_lock lk{m_mutex};
+                sequence = m_claimed.load(std::memory_order::relaxed);
+                if (!has_space_locked())
+                {
+                    return std::nullopt;
+                }
+            }
+
+            if (m_claimed.compare_exchange_weak(
+                    sequence, sequence + 1, std::memory_order::acq_rel, std::memory_order::relaxed))
+            {
+                return sequence;
+            }
+        }
+    }
+
+    /**
+     * Writes the element for the claimed sequence number into its slot and publishes it.  A producer never
+     * suspends between claiming and publishing, so the waits here only cover other producers (and, under
+     * broadcast_lag_policy::drop_oldest, subscribers) that are in the middle of touching the same slot.
+     */
+    template<typename value_type>
+    auto write(std::uint64_t sequence, value_type&& value) -> void
+    {
+        auto& s       = m_slots[sequence % num_elements];
+        auto  guarded = m_policy == broadcast_lag_policy::drop_oldest;
+
+        // The producer a lap behind could still be writing this slot.
+        auto previous = sequence < num_elements ? 0 : sequence - num_elements + 1;
+        while (s.m_sequence.load(std::memory_order::acquire) < previous)
+        {
+            std::this_thread::yield();
+        }
+
+        if (guarded)
+        {
+            // Lagging subscribers copying the old element finish first, new readers see the writer and skip it.
+            std::uint32_t expected{0};
+            while (!s.m_guard.compare_exchange_weak(
+                expected, slot_writer, std::memory_order::acquire, std::memory_order::relaxed))
+            {
+                expected = 0;
+                std::this_thread::yield();
+            }
+        }
+
+        auto publish = [&]()
+        {
+            s.m_sequence.store(sequence + 1, std::memory_order::release);
+            if (guarded)
+            {
+                s.m_guard.fetch_sub(slot_writer, std::memory_order::release);
+            }
+
+            // Publish in sequence order so every element before the tail has been written.
+            while (m_tail.load(std::memory_order::acquire) != sequence)
+            {
+                std::this_thread::yield();
+            }
+            m_tail.store(sequence + 1, std::memory_order::release);
+        };
+
+        try
+        {
+            s.m_element.emplace(std::forward<value_type>(value));
+        }
+        catch (...)
+        {
+            // The slot is left empty and skipped by the subscribers, later producers must not wait on it forever.
+            publish();
+            throw;
+        }
+        publish();
+    }
+
+    /**
+     * Consumes the subscriber's next element into the operation without taking the channel's lock.
+     * @return True if the operation completed with an element or because the channel is shutdown.
+     */
+    auto try_complete(consume_operation& op) -> bool
+    {
+        auto& sub     = op.m_subscriber;
+        auto  guarded = m_policy == broadcast_lag_policy::drop_oldest;
+        auto  cursor  = sub.m_cursor.load(std::memory_order::relaxed);
+        while (true)
+        {
+            auto& s = m_slots[cursor % num_elements];
+            if (guarded && (s.m_guard.fetch_add(1, std::memory_order::acquire) & slot_writer) != 0)
+            {
+                // A producer is overwriting the slot, the element it held is lost to this subscriber.
+                s.m_guard.fetch_sub(1, std::memory_order::release);
+                cursor = skip_lagged(sub, cursor);
+                continue;
+            }
+
+            auto sequence = s.m_sequence.load(std::memory_order::acquire);
+            if (sequence == cursor + 1 && s.m_element.has_value())
+            {
+                try
+                {
+                    op.m_e.emplace(s.m_element.value());
+                }
+                catch (...)
+                {
+                    if (guarded)
+                    {
+                        s.m_guard.fetch_sub(1, std::memory_order::release);
+                    }
+                    throw;
+                }
+            }
+            if (guarded)
+            {
+                s.m_guard.fetch_sub(1, std::memory_order::release);
+            }
+
+            if (sequence > cursor + 1)
+            {
+                cursor = skip_lagged(sub, cursor);
+                continue;
+            }
+
+            if (sequence < cursor + 1)
+            {
+                // Nothing produced yet, elements claimed before a shutdown are still written and consumable.
+                return m_stopped.load(std::memory_order::acquire) &&
+                       m_tail.load(std::memory_order::acquire) == m_claimed.load(std::memory_order::acquire);
+            }
+
+            // The cursor is only moved once the element has been copied out, a blocked producer may reuse the
+            // slot as soon as it observes the new cursor.
+            sub.m_cursor.store(++cursor, std::memory_order::release);
+            if (op.m_e.has_value())
+            {
+                wake_producers();
+                return true;
+            }
+            // A producer failed to construct this element, move on to the next.
+        }
+    }
+
+    /**
+     * Moves a subscriber that lagged behind the producers to the oldest element still in the ring.
+     * @return The subscriber's new cursor.
+     */
+    auto skip_lagged(subscriber& sub, std::uint64_t cursor) -> std::uint64_t
+    {
+        auto tail   = m_tail.load(std::memory_order::acquire);
+        auto oldest = tail > num_elements ? tail - num_elements : 0;
+        auto next   = std::max(cursor + 1, oldest);
+        auto dropped = sub.m_dropped.load(std::memory_order::relaxed) + (next - cursor);
+        sub.m_dropped.store(dropped, std::memory_order::relaxed);
+        sub.m_cursor.store(next, std::memory_order::release);
+        return next;
+    }
+
+    /**
+     * @return True if the subscriber's next element has been produced, or overwritten, or the channel has been
+     *         shutdown with nothing left to write.
+     */
+    auto consumer_ready(subscriber& sub) const -> bool
+    {
+        auto cursor = sub.m_cursor.load(std::memory_order::relaxed);
+        return m_slots[cursor % num_elements].m_sequence.load(std::memory_order::acquire) > cursor ||
+               (m_stopped.load(std::memory_order::acquire) &&
+                m_tail.load(std::memory_order::acquire) == m_claimed.load(std::memory_order::acquire));
+    }
+
+    /**
+     * Queues the operation until its subscriber's next element is produced.
+     * @return True if the operation was queued, false if it completed instead and its coroutine must be resumed.
+     */
+    auto park(consume_operation& op) -> bool
+    {
+        while (true)
+        {
+            if (try_complete(op))
+            {
+                return false;
+            }
+
+            // A producer may complete and resume the operation as soon as it is queued, only locals are used
+            // from then on unless the operation can be taken back.
+            auto& sub = op.m_subscriber;
+            {
+                std::scoped_lock lk{m_mutex};
+                op.m_next = std::exchange(m_consumer_waiters, &op);
+                m_consumers_waiting.store(true, std::memory_order::relaxed);
+            }
+
+            // Pairs with the light fence a producer issues after publishing.
+            detail::asymmetric_fence_heavy();
+            if (!consumer_ready(sub))
+            {
+                return true;
+            }
+
+            std::scoped_lock lk{m_mutex};
+            if (!unlink_locked(m_consumer_waiters, &op))
+            {
+                // A producer already took the operation and completes it.
+                return true;
+            }
+            if (m_consumer_waiters == nullptr)
+            {
+                m_consumers_waiting.store(false, std::memory_order::relaxed);
+            }
+        }
+    }
+
+    auto wake_consumers() -> void
+    {
+        detail::asymmetric_fence_light();
+        if (!m_consumers_waiting.load(std::memory_order::relaxed))
+        {
+            return;
+        }
+
+        consume_operation* ready{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            auto**           link = &m_consumer_waiters;
+            while (*link != nullptr)
+            {
+                auto* op = *link;
+                if (consumer_ready(op->m_subscriber))
+                {
+                    *link     = op->m_next;
+                    op->m_next = std::exchange(ready, op);
+                }
+                else
+                {
+                    link = &op->m_next;
+                }
+            }
+            if (m_consumer_waiters == nullptr)
+            {
+                m_consumers_waiting.store(false, std::memory_order::relaxed);
+            }
+        }
+
+        complete_all(ready);
+    }
+
+    auto wake_producers() -> void
+    {
+        if (m_policy != broadcast_lag_policy::block_producer)
+        {
+            return;
+        }
+
+        detail::asymmetric_fence_light();
+        if (!m_producers_waiting.load(std::memory_order::relaxed))
+        {
+            return;
+        }
+
+        produce_operation* producers{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            producers = take_ready_producers_locked();
+        }
+        resume_all(producers);
+    }
+
+    /**
+     * @return The minimum cursor of all the subscribers, or the next sequence number if there are none.
+     */
+    auto min_cursor_locked() -> std::uint64_t
+    {
+        auto minimum = m_claimed.load(std::memory_order::acquire);
+        for (auto* s : m_subscribers)
+        {
+            minimum = std::min(minimum, s->m_cursor.load(std::memory_order::acquire));
+        }
+        m_min_cursor.store(minimum, std::memory_order::release);
+        return minimum;
+    }
+
+    auto has_space_locked() -> bool
+    {
+        return m_claimed.load(std::memory_order::acquire) - min_cursor_locked() < num_elements;
+    }
+
+    auto take_ready_producers_locked() -> produce_operation*
+    {
+        if (m_producer_waiters != nullptr && has_space_locked())
+        {
+            m_producers_waiting.store(false, std::memory_order::relaxed);
+            return std::exchange(m_producer_waiters, nullptr);
+        }
+        return nullptr;
+    }
+
+    /**
+     * Removes the operation from the list without dereferencing it.
+     * @return True if the operation was still in the list.
+     */
+    template<typename operation_type>
+    static auto unlink_locked(operation_type*& head, operation_type* op) -> bool
+    {
+        for (auto** link = &head; *link != nullptr; link = &(*link)->m_next)
+        {
+            if (*link == op)
+            {
+                *link = op->m_next;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto complete_all(consume_operation* op) -> void
+    {
+        while (op != nullptr)
+        {
+            auto* next = op->m_next;
+            if (!park(*op))
+            {
+                op->m_awaiting_coroutine.resume();
+            }
+            op = next;
+        }
+    }
+
+    template<typename operation_type>
+    static auto resume_all(operation_type* op) -> void
+    {
+        while (op != nullptr)
+        {
+            auto* next = op->m_next;
+            op->m_awaiting_coroutine.resume();
+            op = next;
+        }
+    }
+
+    /// The policy applied when the slowest subscriber is a full ring behind.
+    broadcast_lag_policy m_policy;
+    /// The sequence number the next producer claims.
+    alignas(cache_line_size) std::atomic<std::uint64_t> m_claimed{0};
+    /// Every element before this sequence number has been written.
+    alignas(cache_line_size) std::atomic<std::uint64_t> m_tail{0};
+    /// Lower bound of all the subscribers' cursors.
+    alignas(cache_line_size) std::atomic<std::uint64_t> m_min_cursor{0};
+    /// Has the channel been shutdown?
+    alignas(cache_line_size) std::atomic<bool> m_stopped{false};
+    /// Are any consumers queued in m_consumer_waiters?  Only written while holding m_mutex.
+    std::atomic<bool> m_consumers_waiting{false};
+    /// Are any producers queued in m_producer_waiters?  Only written while holding m_mutex.
+    std::atomic<bool> m_producers_waiting{false};
+    /// Protects the subscribers and the waiting producers and consumers.
+    alignas(cache_line_size) mutable std::mutex m_mutex{};
+    /// The registered subscribers.
+    std::vector<subscriber*> m_subscribers{};
+    /// LIFO list of subscribers waiting for an element to be produced.
+    consume_operation* m_consumer_waiters{nullptr};
+    /// LIFO list of producers waiting for the slowest subscriber to catch up.
+    produce_operation* m_producer_waiters{nullptr};
+    /// The element slots, each element is stored exactly once regardless of the number of subscribers.
+    std::array<slot, num_elements> m_slots{};
+};
+
+} // namespace coro
@@ -12,6 +12,7 @@
 #include <concepts>
 #include <coroutine>
 #include <utility>
+#include <vector>
 
 namespace coro::concepts
 {
@@ -25,6 +26,7 @@ concept executor = requires(executor_type e, std::coroutine_handle<> c)
     { e.spawn_joinable(std::declval<coro::task<void>>()) } -> std::same_as<coro::task<void>>;
     { e.yield() } -> coro::concepts::awaiter;
     { e.resume(c) } -> std::same_as<bool>;
+    { e.resume(std::declval<const std::vector<std::coroutine_handle<>>&>()) } -> std::same_as<std::size_t>;
     { e.size() } -> std::same_as<std::size_t>;
     { e.empty() } -> std::same_as<bool>;
     { e.shutdown() } -> std::same_as<void>;
@@ -34,7 +36,7 @@ concept executor = requires(executor_type e, std::coroutine_handle<> c)
 template<typename executor_type>
 concept io_executor = executor<executor_type> and requires(executor_type e, std::coroutine_handle<> c, fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout)
 {
-    { e.poll(fd, op, timeout) } -> std::same_as<coro::task<poll_status>>;
+    { e.poll(fd, op, timeout) } -> coro::concepts::awaitable;
 };
 #endif // #ifdef LIBCORO_FEATURE_NETWORKING
 
@@ -1,20 +1,20 @@
 #pragma once
 
 #include "coro/concepts/executor.hpp"
-#include "coro/detail/awaiter_list.hpp"
 #include "coro/detail/task_self_deleting.hpp"
-#include "coro/event.hpp"
 #include "coro/mutex.hpp"
 #include "coro/task.hpp"
-#include "coro/when_any.hpp"
 
-#include <atomic>
 #include <chrono>
+#include <concepts>
 #include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 #ifdef LIBCORO_FEATURE_NETWORKING
+    #include "coro/detail/poll_info.hpp"
     #include <stop_token>
 #endif
 
@@ -33,8 +33,8 @@ private:
         ready,
         /// @brief The waiter is not ready to be resumed
         not_ready,
-        /// @brief The waiter is a hook and has timed out and is dead.
-        awaiter_dead,
+        /// @brief The waiter is not ready to be resumed and has already put itself back on the waiter list.
+        requeued,
     };
 
     struct awaiter_base
@@ -49,6 +49,10 @@ private:
 
         /// @brief The next waiting awaiter.
         awaiter_base* m_next{nullptr};
+        /// @brief The previous waiting awaiter, this lets timed out waiters unlink themselves.
+        awaiter_base* m_prev{nullptr};
+        /// @brief Is this awaiter currently on the waiter list? Guarded by the waiter list mutex.
+        bool m_queued{false};
         /// @brief The coroutine to resume the waiter.
         std::coroutine_handle<> m_awaiting_coroutine{nullptr};
         /// @brief The condition variable this waiter is waiting on.
@@ -56,9 +60,17 @@ private:
         /// @brief The lock that the wait() was called with.
         coro::scoped_lock& m_lock;
 
-        /// @brief Each awaiter type defines its own notify behavior.
+        /// @brief Each awaiter type defines its own notify behavior. This is called by the notifier while it holds
+        ///        the waiter's lock, so predicates are evaluated inline without a coroutine frame. A ready waiter is
+        ///        then resumed by the notifier with the lock held, otherwise the lock is released.
         /// @return The status of if the waiter's notify result.
-        virtual auto on_notify() -> coro::task<notify_status_t> = 0;
+        virtual auto on_notify() -> notify_status_t = 0;
+    };
+
+    /// @brief The predicate of waits that do not have one.
+    struct no_predicate
+    {
+        auto operator()() const noexcept -> bool { return true; }
     };
 
     struct awaiter : public awaiter_base
@@ -75,12 +87,18 @@ private:
         auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
         auto await_resume() noexcept {}
 
-        auto on_notify() -> coro::task<notify_status_t> override;
+        auto on_notify() -> notify_status_t override;
     };
 
+    /// @brief Waits on a predicate, the callable is stored inline rather than type erased.
+    template<std::predicate predicate_fn_type>
     struct awaiter_with_predicate : public awaiter_base
     {
-        awaiter_with_predicate(coro::condition_variable& cv, coro::scoped_lock& l, predicate_type p) noexcept;
+        awaiter_with_predicate(coro::condition_variable& cv, coro::scoped_lock& l, predicate_fn_type p) noexcept
+            : awaiter_base(cv, l),
+              m_predicate(std::move(p))
+        {
+        }
         ~awaiter_with_predicate() override = default;
 
         awaiter_with_predicate(const awaiter_with_predicate&)                    = delete;
@@ -88,22 +106,42 @@ private:
         auto operator=(const awaiter_with_predicate&) -> awaiter_with_predicate& = delete;
         auto operator=(awaiter_with_predicate&&) -> awaiter_with_predicate&      = delete;
 
-        auto await_ready() const noexcept -> bool;
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
+        auto await_ready() noexcept -> bool { return m_predicate(); }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+            m_condition_variable.push_awaiter(this);
+            m_lock.m_mutex->unlock();
+            return true;
+        }
+
         auto await_resume() noexcept {}
 
-        auto on_notify() -> coro::task<notify_status_t> override;
+        auto on_notify() -> notify_status_t override
+        {
+            return m_predicate() ? notify_status_t::ready : notify_status_t::not_ready;
+        }
 
         /// @brief The wait predicate to execute on notify.
-        predicate_type m_predicate;
+        predicate_fn_type m_predicate;
     };
 
 #ifndef EMSCRIPTEN
 
+    template<std::predicate predicate_fn_type>
     struct awaiter_with_predicate_stop_token : public awaiter_base
     {
         awaiter_with_predicate_stop_token(
-            coro::condition_variable& cv, coro::scoped_lock& l, predicate_type p, std::stop_token stop_token) noexcept;
+            coro::condition_variable& cv,
+            coro::scoped_lock&        l,
+            predicate_fn_type         p,
+            std::stop_token           stop_token) noexcept
+            : awaiter_base(cv, l),
+              m_predicate(std::move(p)),
+              m_stop_token(std::move(stop_token))
+        {
+        }
         ~awaiter_with_predicate_stop_token() override = default;
 
         awaiter_with_predicate_stop_token(const awaiter_with_predicate_stop_token&)                    = delete;
@@ -111,14 +149,36 @@ private:
         auto operator=(const awaiter_with_predicate_stop_token&) -> awaiter_with_predicate_stop_token& = delete;
         auto operator=(awaiter_with_predicate_stop_token&&) -> awaiter_with_predicate_stop_token&      = delete;
 
-        auto await_ready() noexcept -> bool;
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
+        auto await_ready() noexcept -> bool
+        {
+            m_predicate_result = m_predicate();
+            return m_predicate_result;
+        }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+            m_condition_variable.push_awaiter(this);
+            m_lock.m_mutex->unlock();
+            return true;
+        }
+
         auto await_resume() noexcept -> bool { return m_predicate_result; }
 
-        auto on_notify() -> coro::task<notify_status_t> override;
+        auto on_notify() -> notify_status_t override
+        {
+            m_predicate_result = m_predicate();
+
+            // If the predicate is ready or a stop has been requested resume.
+            if (m_predicate_result || m_stop_token.stop_requested())
+            {
+                return notify_status_t::ready;
+            }
+            return notify_status_t::not_ready;
+        }
 
         /// @brief The wait predicate to execute on notify.
-        predicate_type m_predicate;
+        predicate_fn_type m_predicate;
         /// @brief The stop token that will guarantee the next notify will wake the awaiter regardless of the predicate.
         std::stop_token m_stop_token;
         /// @brief The last predicate's call result.
@@ -129,74 +189,35 @@ private:
 
 #ifdef LIBCORO_FEATURE_NETWORKING
 
-    /// @brief This structure encapsulates the data from the controller task.
-    struct controller_data
-    {
-        controller_data(
-            std::optional<std::cv_status>&       status,
-            bool&                                predicate_result,
-            std::optional<predicate_type>        predicate,
-            std::optional<const std::stop_token> stop_token) noexcept;
-        ~controller_data() = default;
-
-        controller_data(const controller_data&)                    = delete;
-        controller_data(controller_data&&)                         = delete;
-        auto operator=(const controller_data&) -> controller_data& = delete;
-        auto operator=(controller_data&&) -> controller_data&      = delete;
-
-        /// @brief Mutex for notify or timeout mutual exclusion.
-        coro::mutex m_event_mutex{};
-        /// @brief Event to notify the no timeout task.
-        coro::event m_notify_callback{};
-        /// @brief Flag to notify if the awaiter has completed via no_timeout or timeout.
-        std::atomic<bool> m_awaiter_completed{false};
-        /// @brief The status of the wait() call, this is _ONLY_ valid if the m_awaiter_completed flag was obtained,
-        /// otherwise its a dangling reference.
-        std::optional<std::cv_status>& m_status;
-        /// @brief The last result of the predicate call.
-        bool& m_predicate_result;
-        /// @brief The predicate, this can be no predicate, default predicate or stop token predicate.
-        std::optional<predicate_type> m_predicate{std::nullopt};
-        /// @brief The stop token.
-        std::optional<const std::stop_token> m_stop_token{std::nullopt};
-    };
-
     /**
-     * @brief This awaiter is a facade to hook in between the wait_[for|unitl]() caller and the actual awaiter object.
-     * This allows the hook to either call the no_timeout or timeout results correctly based on which one completes
-     * first.
-     *
-     * This class mimics the awaiter_base class so it can silently sit in the coro:condition_variable.m_awaiters to look
-     * like its the actual awaiter, but just proxies to the real awaiter when appropriate.
-     *
-     * If the wait_[for|until] does timeout, then this will do nothing except delete itself from the list on a
-     * notify_[one|all] call.
+     * @brief A timed wait, the awaiter itself is the timer entry registered with the io executor so waiting does
+     * not require any coroutine frames. Whichever of the notify or the timer reaches the awaiter first resumes the
+     * waiter, a notify disarms the timer immediately.
      */
-    struct awaiter_with_wait_hook : public awaiter_base
-    {
-        awaiter_with_wait_hook(coro::condition_variable& cv, coro::scoped_lock& l, controller_data& data) noexcept;
-        ~awaiter_with_wait_hook() override = default;
-
-        auto on_notify() -> coro::task<notify_status_t> override;
-
-        controller_data& m_data;
-    };
-
-    template<concepts::io_executor io_executor_type, typename return_type>
+    template<concepts::io_executor io_executor_type, typename return_type, std::predicate predicate_fn_type = no_predicate>
     struct awaiter_with_wait : public awaiter_base
     {
+        /// @brief The timer entry handed to the io executor, it points back at its awaiter.
+        struct timer_entry : public detail::poll_info
+        {
+            explicit timer_entry(awaiter_with_wait& awaiter) : m_awaiter(awaiter) {}
+            awaiter_with_wait& m_awaiter;
+        };
+
         awaiter_with_wait(
             std::unique_ptr<io_executor_type>& executor,
             coro::condition_variable&          cv,
             coro::scoped_lock&                 l,
             const std::chrono::nanoseconds     wait_for,
-            std::optional<predicate_type>      predicate  = std::nullopt,
+            predicate_fn_type                  predicate  = {},
             std::optional<std::stop_token>     stop_token = std::nullopt) noexcept
             : awaiter_base(cv, l),
               m_executor(executor),
               m_wait_for(wait_for),
               m_predicate(std::move(predicate)),
-              m_stop_token(std::move(stop_token))
+              m_stop_token(std::move(stop_token)),
+              m_relock(*l.m_mutex),
+              m_timer(*this)
         {
         }
         ~awaiter_with_wait() override = default;
@@ -206,89 +227,16 @@ private:
         auto operator=(const awaiter_with_wait&) -> awaiter_with_wait& = delete;
         auto operator=(awaiter_with_wait&&) -> awaiter_with_wait&      = delete;
 
-        /**
-         * @brief Task to handle the no_timeout case, however it is resumed even after a timeout since it needs to exit
-         * for the controller task.
-         *
-         * @param data The controller task's data.
-         * @return coro::task<void>
-         */
-        auto make_on_notify_callback_task(controller_data& data) -> coro::task<void>
-        {
-            co_await data.m_notify_callback;
-
-            // If this is the condition and not a timeout resume from this task.
-            if (m_status.value() == std::cv_status::no_timeout)
-            {
-                // The condition coroutine is resumed from here instead of the awaiter hook task to
-                // guarantee the controller is still alive until the caller's coroutine is completed.
-                m_awaiting_coroutine.resume();
-            }
-
-            // This was a timeout, do nothing but exit to let the controller task know it can safely exit now.
-            co_return;
-        }
-
-        /**
-         * @brief Task to handle the timeout case, this will always wait the duration of the timeout before exiting.
-         *
-         * @param data The controller task data.
-         * @return coro::task<void>
-         */
-        auto make_timeout_task(controller_data& data) -> coro::task<void>
-        {
-            co_await m_executor->schedule_after(m_wait_for);
-            auto lock = co_await data.m_event_mutex.scoped_lock();
-            bool expected{false};
-            if (data.m_awaiter_completed.compare_exchange_strong(
-                    expected, true, std::memory_order::release, std::memory_order::relaxed))
-            {
-                m_status = {std::cv_status::timeout};
-                lock.unlock();
-
-                // This means the timeout has occurred first. Before resuming the wait_[for|until]() caller the lock
-                // must be re-acquired.
-                co_await m_lock.m_mutex->lock();
-                m_predicate_result = data.m_predicate.has_value() ? data.m_predicate.value()() : true;
-                m_awaiting_coroutine.resume();
-                co_return;
-            }
-
-            // The no_timeout has occurred first, exit so the controller task can complete.
-            co_return;
-        }
-
-        /**
-         * @brief Task to manage the no_timeout and timeout tasks, this holds the state for both tasks since they need
-         * to reference the actual wait_[for|until]() awaiter, but need to do so safely while it is still alive. To
-         * access the true awaiter the awaiter_completed atomic bool must be acquired, if it is not acquired the calling
-         * awaiter is invalid since it has already been resumed with the first event of timeout or no_timeout.
-         *
-         * @return coro::detail::task_self_deleting This task is self deleting since it has an indeterminate lifetime.
-         */
-        auto make_controller_task() -> coro::detail::task_self_deleting
-        {
-            controller_data data{m_status, m_predicate_result, std::move(m_predicate), std::move(m_stop_token)};
-            // We enqueue the hook_task since we can make it live until the notify occurs and will properly resume the
-            // actual coroutine only once.
-            awaiter_with_wait_hook hook_task{m_condition_variable, m_lock, data};
-            detail::awaiter_list_push(m_condition_variable.m_awaiters, static_cast<awaiter_base*>(&hook_task));
-            m_lock.m_mutex->unlock(); // Unlock the actual lock now that we are setup, not the fake hook task.
-
-            co_await coro::when_all(make_on_notify_callback_task(data), make_timeout_task(data));
-            co_return;
-        }
-
         auto await_ready() noexcept -> bool
         {
             // If there is no predicate then we are not ready.
-            if (!m_predicate.has_value())
+            if constexpr (std::is_same_v<predicate_fn_type, no_predicate>)
             {
                 return false;
             }
 
-            m_predicate_result = m_predicate.value()();
-            if (m_predicate_result && m_stop_token.has_value() && m_stop_token.value().stop_requested())
+            m_predicate_result = m_predicate();
+            if (m_predicate_result)
             {
                 m_status = std::cv_status::no_timeout;
             }
@@ -297,16 +245,28 @@ private:
 
         auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
         {
-            m_awaiting_coroutine = awaiting_coroutine; // This is the real coroutine to resume.
-
-            // Make the background controller which proxies between the notify task and the timeout task.
-            auto controller = make_controller_task();
-            controller.resume();
+            m_awaiting_coroutine  = awaiting_coroutine;
+            m_timer.m_on_timeout = &awaiter_with_wait::on_timeout;
+
+            // The caller still holds the lock, a notify cannot process this awaiter until it is released
+            // so the timer is guaranteed to be armed by then.
+            m_condition_variable.push_awaiter(this);
+            m_executor->add_timer(clock::now() + m_wait_for, m_timer);
+            m_lock.m_mutex->unlock();
             return true;
         }
 
         auto await_resume() noexcept -> return_type
         {
+            if constexpr (!std::is_same_v<predicate_fn_type, no_predicate>)
+            {
+                if (m_status.value() == std::cv_status::timeout)
+                {
+                    // The lock is held again, give the predicate a final chance.
+                    m_predicate_result = m_predicate();
+                }
+            }
+
             if constexpr (std::is_same_v<return_type, bool>)
             {
                 return m_predicate_result;
@@ -317,7 +277,61 @@ private:
             }
         }
 
-        auto on_notify() -> coro::task<notify_status_t> override { throw std::runtime_error("should never be called"); }
+        auto on_notify() -> notify_status_t override
+        {
+            m_predicate_result = m_predicate();
+            const bool ready =
+                m_predicate_result || (m_stop_token.has_value() && m_stop_token.value().stop_requested());
+
+            {
+                std::scoped_lock lk{m_condition_variable.m_awaiters_mutex};
+                // The timer fires but leaves the awaiter alone while a notify owns it.
+                if (!ready && !m_timed_out)
+                {
+                    m_condition_variable.push_awaiter_locked(this);
+                    return notify_status_t::requeued;
+                }
+            }
+
+            if (ready)
+            {
+                m_executor->cancel_timer(m_timer);
+                m_status = std::cv_status::no_timeout;
+            }
+            else
+            {
+                m_status = std::cv_status::timeout;
+            }
+            return notify_status_t::ready;
+        }
+
+        /**
+         * @brief Called by the io executor when the timer expires while holding its timer lock.
+         * @return The waiter to resume if it timed out and re-acquired the lock immediately.
+         */
+        static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+        {
+            auto& self = static_cast<timer_entry&>(pi).m_awaiter;
+            {
+                std::scoped_lock lk{self.m_condition_variable.m_awaiters_mutex};
+                if (!self.m_queued)
+                {
+                    // A notify is currently evaluating this waiter, it will see the timeout.
+                    self.m_timed_out = true;
+                    return nullptr;
+                }
+                self.m_condition_variable.remove_awaiter_locked(&self);
+            }
+
+            self.m_status = std::cv_status::timeout;
+
+            // Re-acquire the lock before resuming, if it is contended the unlocker resumes us.
+            if (self.m_relock.await_ready() || !self.m_relock.await_suspend(self.m_awaiting_coroutine))
+            {
+                return self.m_awaiting_coroutine;
+            }
+            return nullptr;
+        }
 
         /// @brief The io_executor used to wait for the timeout.
         std::unique_ptr<io_executor_type>& m_executor;
@@ -327,11 +341,16 @@ private:
         std::optional<std::cv_status> m_status{std::nullopt};
         /// @brief The last m_predicate() call result.
         bool m_predicate_result{false};
-        /// @brief The predicate, this can be no predicate, default predicate or stop token predicate. This value is
-        /// only valid until the awaiter data object takes ownership.
-        std::optional<predicate_type> m_predicate{std::nullopt};
-        /// @brief The stop token. This value is only valid until the awater data object takes onwership.
+        /// @brief The predicate, no_predicate for waits without one.
+        predicate_fn_type m_predicate;
+        /// @brief The stop token.
         std::optional<const std::stop_token> m_stop_token{std::nullopt};
+        /// @brief Re-acquires the caller's lock when the timer wins.
+        detail::lock_operation<void> m_relock;
+        /// @brief Set if the timer expired while a notify owned this awaiter. Guarded by the waiter list mutex.
+        bool m_timed_out{false};
+        /// @brief This awaiter's entry in the io executor's timers.
+        timer_entry m_timer;
     };
 
 #endif
@@ -380,19 +399,27 @@ public:
     template<coro::concepts::executor executor_type>
     auto notify_all(std::unique_ptr<executor_type>& executor) -> void
     {
-        auto* waiter = detail::awaiter_list_pop_all(m_awaiters);
+        auto* waiter = pop_all_awaiters();
 
+        std::vector<std::coroutine_handle<>> handles{};
         while (waiter != nullptr)
         {
             // Need to grab next before notifying since the notifier will self destruct after completing.
             awaiter_base* next = waiter->m_next;
-            // This will kick off each task in parallel on the scheduler, they will fight over the lock
-            // but will give the best parallelism scheduling them immediately.
-            executor->spawn_detached(make_notify_all_executor_individual_task(waiter));
+            handles.emplace_back(make_notify_all_executor_individual_task(waiter).handle());
             waiter = next;
         }
 
-        return;
+        // This will kick off each task in parallel on the scheduler in a single submission, they will fight
+        // over the lock but will give the best parallelism scheduling them immediately.  If the executor refuses
+        // the batch (e.g. it is shutting down) the waiters are resumed inline so none of them are lost.
+        if (!handles.empty() && executor->resume(handles) == 0)
+        {
+            for (auto& handle : handles)
+            {
+                handle.resume();
+            }
+        }
     }
 
     /**
@@ -407,10 +434,15 @@ public:
      * @brief Waits until notified but only wakes up if the predicate passes.
      *
      * @param lock A lock that must be locked by the caller.
-     * @param predicate The predicate to check whether the waiting can be completed.
+     * @param predicate The predicate to check whether the waiting can be completed, it is stored in the awaiter.
      * @return awaiter_with_predicate
      */
-    [[nodiscard]] auto wait(coro::scoped_lock& lock, predicate_type predicate) -> awaiter_with_predicate;
+    template<std::predicate predicate_fn_type>
+    [[nodiscard]] auto wait(coro::scoped_lock& lock, predicate_fn_type predicate)
+        -> awaiter_with_predicate<predicate_fn_type>
+    {
+        return awaiter_with_predicate<predicate_fn_type>{*this, lock, std::move(predicate)};
+    }
 
 #ifndef EMSCRIPTEN
     /**
@@ -421,8 +453,13 @@ public:
      * @param predicate The predicate to check whether the waiting can be completed.
      * @return awaiter_with_predicate_stop_token The final predicate call result.
      */
-    [[nodiscard]] auto wait(coro::scoped_lock& lock, std::stop_token stop_token, predicate_type predicate)
-        -> awaiter_with_predicate_stop_token;
+    template<std::predicate predicate_fn_type>
+    [[nodiscard]] auto wait(coro::scoped_lock& lock, std::stop_token stop_token, predicate_fn_type predicate)
+        -> awaiter_with_predicate_stop_token<predicate_fn_type>
+    {
+        return awaiter_with_predicate_stop_token<predicate_fn_type>{
+            *this, lock, std::move(predicate), std::move(stop_token)};
+    }
 #endif
 
 #ifdef LIBCORO_FEATURE_NETWORKING
@@ -438,14 +475,19 @@ public:
             executor, *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
     }
 
-    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    template<
+        concepts::io_executor io_executor_type,
+        class rep_type,
+        class period_type,
+        std::predicate predicate_fn_type>
     [[nodiscard]] auto wait_for(
         std::unique_ptr<io_executor_type>&                 executor,
         coro::scoped_lock&                                 lock,
         const std::chrono::duration<rep_type, period_type> wait_for,
-        predicate_type                                     predicate) -> awaiter_with_wait<io_executor_type, bool>
+        predicate_fn_type                                  predicate)
+        -> awaiter_with_wait<io_executor_type, bool, predicate_fn_type>
     {
-        return awaiter_with_wait<io_executor_type, bool>{
+        return awaiter_with_wait<io_executor_type, bool, predicate_fn_type>{
             executor,
             *this,
             lock,
@@ -453,15 +495,20 @@ public:
             std::move(predicate)};
     }
 
-    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    template<
+        concepts::io_executor io_executor_type,
+        class rep_type,
+        class period_type,
+        std::predicate predicate_fn_type>
     [[nodiscard]] auto wait_for(
         std::unique_ptr<io_executor_type>&                 executor,
         coro::scoped_lock&                                 lock,
         std::stop_token                                    stop_token,
         const std::chrono::duration<rep_type, period_type> wait_for,
-        predicate_type                                     predicate) -> awaiter_with_wait<io_executor_type, bool>
+        predicate_fn_type                                  predicate)
+        -> awaiter_with_wait<io_executor_type, bool, predicate_fn_type>
     {
-        return awaiter_with_wait<io_executor_type, bool>{
+        return awaiter_with_wait<io_executor_type, bool, predicate_fn_type>{
             executor,
             *this,
             lock,
@@ -483,16 +530,21 @@ public:
             executor, *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
     }
 
-    template<concepts::io_executor io_executor_type, class clock_type, class duration_type>
+    template<
+        concepts::io_executor io_executor_type,
+        class clock_type,
+        class duration_type,
+        std::predicate predicate_fn_type>
     auto wait_until(
         std::unique_ptr<io_executor_type>&                       executor,
         coro::scoped_lock&                                       lock,
         const std::chrono::time_point<clock_type, duration_type> wait_until_time,
-        predicate_type                                           predicate) -> awaiter_with_wait<io_executor_type, bool>
+        predicate_fn_type                                        predicate)
+        -> awaiter_with_wait<io_executor_type, bool, predicate_fn_type>
     {
         auto now      = std::chrono::time_point<clock_type, duration_type>::clock::now();
         auto wait_for = (now < wait_until_time) ? (wait_until_time - now) : std::chrono::nanoseconds{1};
-        return awaiter_with_wait<io_executor_type, bool>{
+        return awaiter_with_wait<io_executor_type, bool, predicate_fn_type>{
             executor,
             *this,
             lock,
@@ -500,17 +552,22 @@ public:
             std::move(predicate)};
     }
 
-    template<concepts::io_executor io_executor_type, class clock_type, class duration_type>
+    template<
+        concepts::io_executor io_executor_type,
+        class clock_type,
+        class duration_type,
+        std::predicate predicate_fn_type>
     auto wait_until(
         std::unique_ptr<io_executor_type>&                       executor,
         coro::scoped_lock&                                       lock,
         std::stop_token                                          stop_token,
         const std::chrono::time_point<clock_type, duration_type> wait_until_time,
-        predicate_type                                           predicate) -> awaiter_with_wait<io_executor_type, bool>
+        predicate_fn_type                                        predicate)
+        -> awaiter_with_wait<io_executor_type, bool, predicate_fn_type>
     {
         auto now      = std::chrono::time_point<clock_type, duration_type>::clock::now();
         auto wait_for = (now < wait_until_time) ? (wait_until_time - now) : std::chrono::nanoseconds{1};
-        return awaiter_with_wait<io_executor_type, bool>{
+        return awaiter_with_wait<io_executor_type, bool, predicate_fn_type>{
             executor,
             *this,
             lock,
@@ -521,22 +578,24 @@ public:
 #endif
 
 private:
-    /// @brief The list of waiters.
-    std::atomic<awaiter_base*> m_awaiters{nullptr};
-
-    auto make_notify_all_executor_individual_task(awaiter_base* waiter) -> coro::task<void>
+    /// @brief Guards the waiter list, timed waiters remove themselves from the middle of it on timeout.
+    std::mutex m_awaiters_mutex{};
+    /// @brief The list of waiters, most recent waiter first.
+    awaiter_base* m_awaiters{nullptr};
+
+    auto push_awaiter(awaiter_base* waiter) -> void;
+    auto push_awaiter_locked(awaiter_base* waiter) -> void;
+    auto pop_awaiter() -> awaiter_base*;
+    /// @brief Takes the entire waiter list, the returned waiters are linked through m_next.
+    auto pop_all_awaiters() -> awaiter_base*;
+    auto remove_awaiter_locked(awaiter_base* waiter) -> void;
+    /// @brief Notifies a waiter whose lock the caller has acquired, either resuming it or releasing the lock.
+    auto notify_locked(awaiter_base* waiter) -> void;
+
+    auto make_notify_all_executor_individual_task(awaiter_base* waiter) -> detail::task_self_deleting
     {
-        switch (co_await waiter->on_notify())
-        {
-            case notify_status_t::not_ready:
-                // Re-enqueue since the predicate isn't ready and return since the notify has been satisfied.
-                detail::awaiter_list_push(m_awaiters, waiter);
-                break;
-            case notify_status_t::ready:
-            case notify_status_t::awaiter_dead:
-                // Don't re-enqueue any awaiters that are ready or dead.
-                break;
-        }
+        co_await waiter->m_lock.m_mutex->lock();
+        notify_locked(waiter);
     }
 };
 
@@ -13,6 +13,7 @@
     #include "coro/net/dns/resolver.hpp"
     #include "coro/net/tcp/client.hpp"
     #include "coro/net/tcp/server.hpp"
+    #include "coro/object_pool.hpp"
     #include "coro/poll.hpp"
     #ifdef LIBCORO_FEATURE_TLS
         #include "coro/net/tls/client.hpp"
@@ -20,6 +21,7 @@
         #include "coro/net/tls/context.hpp"
         #include "coro/net/tls/server.hpp"
     #endif
+    #include "coro/net/buffer_pool.hpp"
     #include "coro/net/connect.hpp"
     #include "coro/net/hostname.hpp"
     #include "coro/net/ip_address.hpp"
@@ -29,6 +31,8 @@
     #include "coro/net/udp/peer.hpp"
 #endif
 
+#include "coro/barrier.hpp"
+#include "coro/broadcast_channel.hpp"
 #include "coro/condition_variable.hpp"
 #include "coro/default_executor.hpp"
 #include "coro/event.hpp"
@@ -37,8 +41,12 @@
 #include "coro/mutex.hpp"
 #include "coro/queue.hpp"
 #include "coro/ring_buffer.hpp"
+#include "coro/select.hpp"
 #include "coro/semaphore.hpp"
 #include "coro/shared_mutex.hpp"
+#include "coro/shared_task.hpp"
+#include "coro/single_flight.hpp"
+#include "coro/spsc_channel.hpp"
 #include "coro/sync_wait.hpp"
 #include "coro/task.hpp"
 #include "coro/task_group.hpp"
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+
+namespace coro::detail
+{
+/// True once asymmetric_fence_heavy() forces a barrier on every running thread of the process.
+extern std::atomic<bool> asymmetric_fence_expedited;
+
+/**
+ * The fast side of a Dekker style handshake where one side runs far more often than the other, e.g. a
+ * producer that only has to wake a consumer that is rarely suspended.  Paired with asymmetric_fence_heavy()
+ * on the slow side the two order like a pair of seq_cst fences.  This is only a compiler barrier on Linux
+ * where the heavy fence uses membarrier(2), elsewhere it is a seq_cst fence.
+ */
+inline auto asymmetric_fence_light() noexcept -> void
+{
+    if (asymmetric_fence_expedited.load(std::memory_order::relaxed))
+    {
+        std::atomic_signal_fence(std::memory_order::seq_cst);
+    }
+    else
+    {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+    }
+}
+
+/**
+ * The slow side of the handshake, see asymmetric_fence_light().  This is a system call on Linux.
+ */
+auto asymmetric_fence_heavy() noexcept -> void;
+
+} // namespace coro::detail
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "coro/fd.hpp"
+
+#if !defined(__linux__)
+    #include "coro/detail/pipe.hpp"
+#endif
+
+namespace coro::detail
+{
+/**
+ * A doorbell to wake up an event loop from another thread.  On Linux this is a single eventfd so ringing it is
+ * one 8 byte write and clearing it one read no matter how many times it was rung, other platforms emulate it
+ * with a non-blocking pipe.
+ */
+class event_fd_t
+{
+public:
+    explicit event_fd_t();
+    ~event_fd_t();
+
+    event_fd_t(const event_fd_t&)                    = delete;
+    event_fd_t(event_fd_t&&)                         = delete;
+    auto operator=(const event_fd_t&) -> event_fd_t& = delete;
+    auto operator=(event_fd_t&&) -> event_fd_t&      = delete;
+
+    /**
+     * @return The file descriptor to watch for read events, it is readable while the doorbell is rung.
+     */
+    [[nodiscard]] auto read_fd() const -> fd_t;
+
+    /**
+     * Rings the doorbell, this is safe to call from any thread.
+     */
+    auto notify() noexcept -> void;
+
+    /**
+     * Clears every ring of the doorbell so it is no longer readable.
+     */
+    auto drain() noexcept -> void;
+
+    auto close() -> void;
+
+private:
+#if defined(__linux__)
+    fd_t m_fd{-1};
+#else
+    pipe_t m_pipe{};
+#endif
+};
+
+} // namespace coro::detail
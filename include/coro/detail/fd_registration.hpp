@@ -0,0 +1,98 @@
+#pragma once
+
+#include "coro/detail/poll_info.hpp"
+#include "coro/fd.hpp"
+#include "coro/poll.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace coro::detail
+{
+/**
+ * A file descriptor registered with the io notifier once for its lifetime, edge triggered for both read and write
+ * readiness.  The readiness the io notifier reports is latched until an operation on the file descriptor would
+ * block and clear() is called, so polling a registered file descriptor never re-registers it with the io notifier.
+ *
+ * Each direction has a single waiter slot, a reader and a writer can wait on the file descriptor concurrently.
+ */
+struct fd_registration
+{
+    /// The readiness reported by the io notifier, see notify().
+    enum readiness : std::uint8_t
+    {
+        /// Reading will not block.
+        readable = 1 << 0,
+        /// Writing will not block.
+        writable = 1 << 1,
+        /// The peer shut down its writing side, reads return end of file.
+        read_closed = 1 << 2,
+        /// The file descriptor hung up in both directions.
+        closed = 1 << 3,
+        /// The file descriptor has a pending error.
+        error = 1 << 4
+    };
+
+    explicit fd_registration(fd_t fd) noexcept : m_fd(fd) {}
+
+    fd_registration(const fd_registration&)                    = delete;
+    fd_registration(fd_registration&&)                         = delete;
+    auto operator=(const fd_registration&) -> fd_registration& = delete;
+    auto operator=(fd_registration&&) -> fd_registration&      = delete;
+
+    ~fd_registration() = default;
+
+    /**
+     * Waits for the poll info's operation unless the latched readiness already satisfies it.
+     * @param pi The poll info to resume once the file descriptor is ready.
+     * @return True if pi now waits, false if the poll completed immediately and its result is in pi.m_poll_status.
+     *         The poll fails with poll_status::error if another poll already waits in the same direction.
+     */
+    auto wait(poll_info& pi) -> bool;
+
+    /**
+     * Removes the poll info from its waiter slots if it is still waiting, e.g. because its timeout won.
+     * @param pi The poll info to remove.
+     */
+    auto cancel(poll_info& pi) -> void;
+
+    /**
+     * Forgets the latched readiness for the operation, call this once the operation would block.  Readiness
+     * reported since the last poll in this direction completed is kept so it can never be lost.
+     * @param op The direction(s) to forget the readiness of.
+     */
+    auto clear(coro::poll_op op) -> void;
+
+    /**
+     * Latches the readiness reported by the io notifier and wakes the waiters it satisfies.
+     * @param ready The readiness bits reported by the io notifier.
+     * @param ready_events The woken waiters are appended to this.
+     */
+    auto notify(std::uint8_t ready, std::vector<std::pair<poll_info*, coro::poll_status>>& ready_events) -> void;
+
+    /// The registered file descriptor.
+    fd_t m_fd{-1};
+    /// The io notifier's registration of the file descriptor, io_uring needs it to remove the registration.
+    std::uint64_t m_registration_id{0};
+
+private:
+    /// Guards the readiness and the waiters, the event loop notifies while pollers wait from any thread.
+    std::mutex m_mutex{};
+    /// The latched readiness bits.
+    std::uint8_t m_ready{0};
+    /// Incremented on every notify() so clear() can tell if readiness arrived since the last completed poll.
+    std::uint64_t m_tick{0};
+    /// The tick at which the last poll in each direction completed.
+    std::uint64_t m_read_tick{0};
+    std::uint64_t m_write_tick{0};
+    /// The waiter slots.
+    poll_info* m_reader{nullptr};
+    poll_info* m_writer{nullptr};
+
+    auto ready_for_locked(const poll_info& pi) const noexcept -> bool;
+    auto complete_locked(poll_info& pi) noexcept -> coro::poll_status;
+};
+
+} // namespace coro::detail
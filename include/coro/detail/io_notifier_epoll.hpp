@@ -3,6 +3,8 @@
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 #include <sys/epoll.h>
@@ -10,6 +12,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "coro/detail/fd_registration.hpp"
 #include "coro/detail/poll_info.hpp"
 #include "coro/fd.hpp"
 #include "coro/poll.hpp"
@@ -23,13 +26,59 @@ class timer_handle;
 
 class io_notifier_epoll
 {
-    static const constexpr std::size_t m_max_events = 16;
-    fd_t                               m_fd;
+    fd_t m_fd;
+
+    /// The events epoll_wait() fills, re-used across calls and grown up to m_max_event_batch_size.
+    std::vector<event_t> m_events;
+    std::size_t          m_max_event_batch_size;
+
+    /// Events of polled and registered file descriptors carry the file descriptor tagged in the low bits instead
+    /// of a pointer, they are looked up in m_polled or m_registered so an event racing an unwatch() never reaches
+    /// a destroyed poll info or registration.  Other events carry a pointer to a suitably aligned object.
+    static const constexpr std::uint64_t m_tag_bits       = 2;
+    static const constexpr std::uint64_t m_tag_mask       = (1 << m_tag_bits) - 1;
+    static const constexpr std::uint64_t m_polled_tag     = 1;
+    static const constexpr std::uint64_t m_registered_tag = 2;
+
+    /// The polls waiting on a file descriptor, a reader and a writer can wait concurrently.  A read_write poll
+    /// occupies both slots.  The file descriptor is in the epoll set exactly while a slot is occupied.
+    struct polled_fd
+    {
+        detail::poll_info* m_reader{nullptr};
+        detail::poll_info* m_writer{nullptr};
+    };
+    std::mutex             m_polled_mutex{};
+    std::vector<polled_fd> m_polled{};
+
+    std::mutex                            m_registered_mutex{};
+    std::vector<detail::fd_registration*> m_registered{};
+
+    /**
+     * Arms the file descriptor for the merged interest of its waiting polls, or removes it from the epoll set if
+     * no poll waits on it anymore.  m_polled_mutex must be held.
+     * @param add True if the file descriptor is not in the epoll set yet.
+     */
+    auto arm_polled_locked(fd_t fd, const polled_fd& polled, bool add) -> bool;
 
     friend class detail::timer_handle;
 
 public:
-    io_notifier_epoll();
+    /// The backends this notifier supports, it only has one.
+    enum class backend_t
+    {
+        /// Polls use epoll and timers use a timerfd.
+        epoll
+    };
+
+    /// The number of events per batch unless resize_event_batch() is called.
+    static const constexpr std::size_t default_event_batch_size{16};
+    /// The backend used unless another one is requested.
+    static const constexpr backend_t default_backend{backend_t::epoll};
+
+    /**
+     * @param preferred The backend to use, epoll is the only choice.
+     */
+    explicit io_notifier_epoll(backend_t preferred = default_backend);
 
     io_notifier_epoll(const io_notifier_epoll&)                    = delete;
     io_notifier_epoll(io_notifier_epoll&&)                         = delete;
@@ -38,21 +87,68 @@ public:
 
     ~io_notifier_epoll();
 
+    /**
+     * @return The backend in use.
+     */
+    [[nodiscard]] auto backend() const noexcept -> backend_t { return backend_t::epoll; }
+
     auto watch_timer(const detail::timer_handle& timer, std::chrono::nanoseconds duration) -> bool;
 
     auto watch(fd_t fd, coro::poll_op op, void* data, bool keep = false) -> bool;
 
+    /**
+     * Watches the file descriptor for the poll info's operation.  One poll reading and one poll writing can wait on
+     * the same file descriptor concurrently, they are woken independently.
+     * @param pi The poll info to report once the file descriptor is ready.
+     * @return True if the poll info is watched, false if another poll already waits in the same direction.
+     */
     auto watch(detail::poll_info& pi) -> bool;
 
+    /**
+     * Stops watching for the poll info, it is a no-op if the poll info's event has already been reported.
+     * @param pi The poll info to stop watching for.
+     */
     auto unwatch(detail::poll_info& pi) -> bool;
 
+    /**
+     * Registers the file descriptor for its lifetime, edge triggered for both read and write readiness.
+     * @param registration The registration to notify, it must stay alive until unwatch() returns.
+     * @return True if the file descriptor was registered.
+     */
+    auto watch(detail::fd_registration& registration) -> bool;
+
+    /**
+     * Removes the registration, once this returns the registration is never notified again.
+     * @param registration The registration to remove.
+     */
+    auto unwatch(detail::fd_registration& registration) -> bool;
+
     auto unwatch_timer(const detail::timer_handle& timer) -> bool;
 
+    /**
+     * Sizes the batch of events a single next_events() call waits for, this must not be called concurrently with
+     * next_events().
+     * @param size The number of events per batch, at least one.
+     * @param max_size The batch doubles up to this many events while batches come back full, a max_size not
+     *                 above size keeps the batch at a fixed size.
+     */
+    auto resize_event_batch(std::size_t size, std::size_t max_size) -> void;
+
     auto next_events(
         std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
         -> void;
 
     static auto event_to_poll_status(const event_t& event) -> poll_status;
+
+    /**
+     * @return The status of a poll for the given operation, or empty if the event does not concern the operation.
+     */
+    static auto event_to_poll_status(const event_t& event, coro::poll_op op) -> std::optional<poll_status>;
+
+    /**
+     * @return The epoll (or poll) event bits as fd_registration::readiness bits.
+     */
+    static auto events_to_readiness(std::uint32_t events) -> std::uint8_t;
 };
 
 } // namespace coro::detail
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <mutex>
 #include <vector>
 
 #include <sys/event.h>
@@ -10,6 +11,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "coro/detail/fd_registration.hpp"
 #include "coro/detail/poll_info.hpp"
 #include "coro/fd.hpp"
 #include "coro/poll.hpp"
@@ -23,13 +25,37 @@ class timer_handle;
 
 class io_notifier_kqueue
 {
-    static const constexpr std::size_t m_max_events = 16;
-    fd_t                               m_fd;
+    fd_t m_fd;
+
+    /// The events kevent() fills, re-used across calls and grown up to m_max_event_batch_size.
+    std::vector<event_t> m_events;
+    std::size_t          m_max_event_batch_size;
+
+    /// Events of registered file descriptors carry this tag instead of a pointer, they are looked up by their
+    /// ident in m_registered so an event racing an unwatch() never reaches a destroyed registration.
+    static const constexpr std::uintptr_t m_registered_tag = 1;
+    std::mutex                            m_registered_mutex{};
+    std::vector<detail::fd_registration*> m_registered{};
 
     friend class detail::timer_handle;
 
 public:
-    io_notifier_kqueue();
+    /// The backends this notifier supports, it only has one.
+    enum class backend_t
+    {
+        /// Polls and timers use kqueue.
+        kqueue
+    };
+
+    /// The number of events per batch unless resize_event_batch() is called.
+    static const constexpr std::size_t default_event_batch_size{16};
+    /// The backend used unless another one is requested.
+    static const constexpr backend_t default_backend{backend_t::kqueue};
+
+    /**
+     * @param preferred The backend to use, kqueue is the only choice.
+     */
+    explicit io_notifier_kqueue(backend_t preferred = default_backend);
 
     io_notifier_kqueue(const io_notifier_kqueue&)                    = delete;
     io_notifier_kqueue(io_notifier_kqueue&&)                         = delete;
@@ -38,6 +64,11 @@ public:
 
     ~io_notifier_kqueue();
 
+    /**
+     * @return The backend in use.
+     */
+    [[nodiscard]] auto backend() const noexcept -> backend_t { return backend_t::kqueue; }
+
     auto watch_timer(const detail::timer_handle& timer, std::chrono::nanoseconds duration) -> bool;
 
     auto watch(fd_t fd, coro::poll_op op, void* data, bool keep = false) -> bool;
@@ -46,8 +77,30 @@ public:
 
     auto unwatch(detail::poll_info& pi) -> bool;
 
+    /**
+     * Registers the file descriptor for its lifetime, edge triggered for both read and write readiness.
+     * @param registration The registration to notify, it must stay alive until unwatch() returns.
+     * @return True if the file descriptor was registered.
+     */
+    auto watch(detail::fd_registration& registration) -> bool;
+
+    /**
+     * Removes the registration, once this returns the registration is never notified again.
+     * @param registration The registration to remove.
+     */
+    auto unwatch(detail::fd_registration& registration) -> bool;
+
     auto unwatch_timer(const detail::timer_handle& timer) -> bool;
 
+    /**
+     * Sizes the batch of events a single next_events() call waits for, this must not be called concurrently with
+     * next_events().
+     * @param size The number of events per batch, at least one.
+     * @param max_size The batch doubles up to this many events while batches come back full, a max_size not
+     *                 above size keeps the batch at a fixed size.
+     */
+    auto resize_event_batch(std::size_t size, std::size_t max_size) -> void;
+
     auto next_events(
         std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
         -> void;
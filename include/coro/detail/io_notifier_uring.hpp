@@ -0,0 +1,246 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <linux/time_types.h>
+
+#include "coro/detail/fd_registration.hpp"
+#include "coro/detail/io_notifier_epoll.hpp"
+#include "coro/detail/io_operation.hpp"
+#include "coro/detail/poll_info.hpp"
+#include "coro/fd.hpp"
+#include "coro/poll.hpp"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+
+namespace coro::detail
+{
+
+class timer_handle;
+
+/**
+ * The io_uring io notifier submits polls and timeouts through the kernel's submission ring and reaps their
+ * completions in batches.  Unlike epoll a one shot poll does not need to be removed after it triggers, and
+ * submissions made on the event loop thread are handed to the kernel together with the next wait, so a poll
+ * that triggers costs no syscalls beyond the event loop's single io_uring_enter per batch.
+ *
+ * If the kernel does not support io_uring, or lacks the features this requires (Linux 5.13+), the notifier
+ * transparently falls back to epoll, see backend().
+ */
+class io_notifier_uring
+{
+public:
+    enum class backend_t
+    {
+        /// Polls and timeouts are submitted through io_uring.
+        io_uring,
+        /// The kernel lacks io_uring support, polls and timeouts use epoll and timerfd.
+        epoll
+    };
+
+    /// The backend used unless another one is requested.
+    static const constexpr backend_t default_backend{backend_t::io_uring};
+
+    /**
+     * @param preferred The backend to use, io_uring falls back to epoll if the kernel does not support it.
+     */
+    explicit io_notifier_uring(backend_t preferred = backend_t::io_uring);
+
+    io_notifier_uring(const io_notifier_uring&)                    = delete;
+    io_notifier_uring(io_notifier_uring&&)                         = delete;
+    auto operator=(const io_notifier_uring&) -> io_notifier_uring& = delete;
+    auto operator=(io_notifier_uring&&) -> io_notifier_uring&      = delete;
+
+    ~io_notifier_uring();
+
+    /**
+     * @return The backend in use.
+     */
+    [[nodiscard]] auto backend() const noexcept -> backend_t
+    {
+        return (m_epoll != nullptr) ? backend_t::epoll : backend_t::io_uring;
+    }
+
+    auto watch_timer(const detail::timer_handle& timer, std::chrono::nanoseconds duration) -> bool;
+
+    auto watch(fd_t fd, coro::poll_op op, void* data, bool keep = false) -> bool;
+
+    auto watch(detail::poll_info& pi) -> bool;
+
+    auto unwatch(detail::poll_info& pi) -> bool;
+
+    /**
+     * Registers the file descriptor for its lifetime with a multishot poll for both read and write readiness.
+     * @param registration The registration to notify, it must stay alive until unwatch() returns.
+     * @return True if the file descriptor was registered.
+     */
+    auto watch(detail::fd_registration& registration) -> bool;
+
+    /**
+     * Removes the registration, once this returns the registration is never notified again.
+     * @param registration The registration to remove.
+     */
+    auto unwatch(detail::fd_registration& registration) -> bool;
+
+    auto unwatch_timer(const detail::timer_handle& timer) -> bool;
+
+    /**
+     * Submits the operation to be performed by the kernel, `pi` is reported as ready when it completes and its
+     * `m_result` holds the operation's result.  The poll info and the operation's buffers must stay alive until
+     * then, the operation is not cancellable other than by its timeout.
+     * @param pi The poll info to report, it is not watched for readiness.
+     * @param op The operation to perform.
+     * @param timeout If non zero the kernel cancels the operation after this long, it then completes with
+     *                -ECANCELED.
+     * @return True if the operation was submitted, false if the io_uring backend is not in use.
+     */
+    auto submit(detail::poll_info& pi, const detail::io_operation& op, std::chrono::nanoseconds timeout) -> bool;
+
+    /**
+     * Registers a ring of provided buffers that receive operations can have the kernel select their buffer from,
+     * so memory is only committed to sockets once data arrives, see detail::io_operation::m_buffer_group.  Every
+     * buffer is initially provided to the kernel.
+     * @param base The `count` buffers of `buffer_size` bytes each, they must outlive the registration.
+     * @param buffer_size The size of each buffer.
+     * @param count The number of buffers, the kernel limits a provided buffer ring to 32768 entries.
+     * @return The buffer group, or -1 if the io_uring backend is not in use, the kernel does not support
+     *         provided buffer rings (Linux 5.19+) or count exceeds its limit.
+     */
+    auto register_buffers(void* base, std::size_t buffer_size, std::uint16_t count) -> std::int32_t;
+
+    /**
+     * Provides the buffer back to the kernel after a receive operation selected it.
+     * @param group The buffer group returned by register_buffers().
+     * @param id The id of the buffer to provide, see detail::poll_info::m_selected_buffer.
+     */
+    auto provide_buffer(std::int32_t group, std::uint16_t id) -> void;
+
+    /**
+     * Unregisters the buffers, no receive operation selecting from the group may be pending.
+     * @param group The buffer group returned by register_buffers().
+     */
+    auto unregister_buffers(std::int32_t group) -> void;
+
+    /**
+     * Completions are reaped straight from the completion ring so only the epoll fallback has a batch to size.
+     * Sizes the batch of events a single next_events() call waits for, this must not be called concurrently with
+     * next_events().
+     * @param size The number of events per batch, at least one.
+     * @param max_size The batch doubles up to this many events while batches come back full, a max_size not
+     *                 above size keeps the batch at a fixed size.
+     */
+    auto resize_event_batch(std::size_t size, std::size_t max_size) -> void;
+
+    auto next_events(
+        std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+        -> void;
+
+    static auto events_to_poll_status(std::int32_t events) -> poll_status;
+
+private:
+    /// A submission that can complete, the completion's user data identifies the registration.
+    struct registration
+    {
+        enum class kind_t : std::uint8_t
+        {
+            /// The slot is free.
+            free,
+            /// A one shot poll for a poll_info.
+            poll,
+            /// A multishot poll that is kept for the lifetime of the notifier.
+            persistent,
+            /// A multishot poll for a registered file descriptor, see detail::fd_registration.
+            registered,
+            /// The io_scheduler's timer.
+            timer,
+            /// A completion based io operation for a poll_info.
+            operation
+        };
+
+        void*         m_data{nullptr};
+        fd_t          m_fd{-1};
+        std::uint32_t m_events{0};
+        /// Incremented on every release so completions for a released registration are discarded.
+        std::uint32_t m_generation{1};
+        kind_t        m_kind{kind_t::free};
+    };
+
+    /// A ring of provided buffers shared with the kernel, its index is its buffer group.
+    struct buffer_ring
+    {
+        io_uring_buf*  m_bufs{nullptr};
+        std::size_t    m_ring_size{0};
+        std::uint16_t* m_tail_ptr{nullptr};
+        std::uint16_t  m_tail{0};
+        std::uint16_t  m_mask{0};
+        char*          m_base{nullptr};
+        std::size_t    m_buffer_size{0};
+    };
+
+    /// The fallback when io_uring is not available.
+    std::unique_ptr<io_notifier_epoll> m_epoll{nullptr};
+
+    /// The io_uring file descriptor.
+    fd_t m_fd{-1};
+    /// The mmap'ed submission and completion rings and submission queue entries.
+    void*         m_sq_ring{nullptr};
+    std::size_t   m_sq_ring_size{0};
+    void*         m_cq_ring{nullptr};
+    std::size_t   m_cq_ring_size{0};
+    io_uring_sqe* m_sqes{nullptr};
+    std::size_t   m_sqes_size{0};
+
+    unsigned*     m_sq_head{nullptr};
+    unsigned*     m_sq_tail_ptr{nullptr};
+    unsigned      m_sq_mask{0};
+    unsigned      m_sq_entries{0};
+    unsigned*     m_cq_head{nullptr};
+    unsigned*     m_cq_tail{nullptr};
+    unsigned      m_cq_mask{0};
+    io_uring_cqe* m_cqes{nullptr};
+
+    /// Guards the submission ring, the registrations and the timer, submissions can come from any thread.
+    std::mutex m_mutex{};
+    /// The next submission queue entry to fill, it is published to the kernel's tail after it is written.
+    unsigned m_sq_tail{0};
+    /// Timeouts are read by the kernel when their entry is submitted, each entry has its own timespec.
+    std::vector<__kernel_timespec> m_timespecs{};
+    /// Registrations are addressed by index and generation so no allocation is needed per poll.
+    std::vector<registration> m_registrations{};
+    std::vector<std::uint32_t> m_free_registrations{};
+    /// The registration of the armed timer, zero if the timer is not armed.
+    std::uint64_t m_timer_id{0};
+    /// The registered provided buffer rings by buffer group, unregistered rings are left empty.
+    std::vector<buffer_ring> m_buffer_rings{};
+
+    /// Submissions made on the event loop thread are handed to the kernel by the next wait.
+    std::atomic<std::thread::id> m_event_loop_thread{};
+
+    auto setup() -> bool;
+    auto teardown() -> void;
+
+    auto next_sqe_locked(unsigned count = 1) -> io_uring_sqe*;
+    auto publish_locked(unsigned count = 1) -> void;
+    auto submit_locked() -> void;
+    auto pending_locked() const -> unsigned;
+
+    auto add_registration_locked(registration::kind_t kind, void* data, fd_t fd, std::uint32_t events)
+        -> std::uint64_t;
+    auto find_registration_locked(std::uint64_t id) -> registration*;
+    auto release_registration_locked(std::uint64_t id) -> void;
+    auto provide_buffer_locked(buffer_ring& ring, std::uint16_t id) -> void;
+    auto prepare_poll_locked(std::uint64_t id, fd_t fd, std::uint32_t events, bool multishot) -> bool;
+    auto prepare_poll_remove_locked(std::uint64_t id) -> bool;
+
+    auto reap(std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events) -> void;
+};
+
+} // namespace coro::detail
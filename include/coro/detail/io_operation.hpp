@@ -0,0 +1,62 @@
+#pragma once
+
+#include "coro/fd.hpp"
+#include "coro/poll.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+
+namespace coro::detail
+{
+/**
+ * A completion based socket operation, on io_uring the kernel performs the operation and completes it, otherwise
+ * the io_scheduler performs the syscall and polls the socket until it is ready when it would block.
+ */
+struct io_operation
+{
+    enum class opcode_t : std::uint8_t
+    {
+        /// recv() into m_buffer up to m_length bytes.
+        recv,
+        /// send() from m_buffer up to m_length bytes.
+        send,
+        /// accept() a connection, the peer's address is written into m_buffer and m_address_length.
+        accept,
+        /// connect() to the address in m_buffer of m_length bytes.
+        connect
+    };
+
+    opcode_t m_opcode{opcode_t::recv};
+    /// The socket to perform the operation on.
+    fd_t m_fd{-1};
+    /// The data to send or receive, or the socket address for accept and connect.
+    void* m_buffer{nullptr};
+    /// The number of bytes in m_buffer.
+    std::size_t m_length{0};
+    /// The length of the accepted peer's address, it must be initialized to the size of m_buffer.
+    socklen_t* m_address_length{nullptr};
+    /// A recv with a buffer group has the io notifier select the buffer from the group's provided buffers when
+    /// data arrives instead of receiving into m_buffer, only the io_uring backend supports this.
+    std::int32_t m_buffer_group{-1};
+    /// The id of the buffer selected from m_buffer_group, or -1 if none was selected.
+    std::int32_t* m_selected_buffer{nullptr};
+
+    /**
+     * @return The readiness to poll for when the operation would block.
+     */
+    auto poll_operation() const noexcept -> coro::poll_op
+    {
+        return (m_opcode == opcode_t::send || m_opcode == opcode_t::connect) ? coro::poll_op::write
+                                                                              : coro::poll_op::read;
+    }
+
+    /**
+     * Performs the operation with a non-blocking syscall.  A recv from a buffer group fails with -ENOBUFS.
+     * @return The syscall's result, the number of bytes transferred, the accepted file descriptor or zero on
+     *         success, or the negated errno on failure.
+     */
+    auto execute() const noexcept -> std::int64_t;
+};
+
+} // namespace coro::detail
@@ -6,11 +6,13 @@
 
 #include <atomic>
 #include <coroutine>
-#include <map>
-#include <optional>
+#include <cstdint>
+#include <limits>
 
 namespace coro::detail
 {
+struct fd_registration;
+
 /**
  * Poll Info encapsulates everything about a poll operation for the event as well as its paired
  * timeout.  This is important since coroutines that are waiting on an event or timeout do not
@@ -26,7 +28,8 @@ namespace coro::detail
  */
 struct poll_info
 {
-    using timed_events = std::multimap<coro::time_point, detail::poll_info*>;
+    /// The m_timer_slot of a poll info that is not in a timer_wheel.
+    static constexpr std::uint16_t timer_unlinked{std::numeric_limits<std::uint16_t>::max()};
 
     poll_info()  = default;
     ~poll_info() = default;
@@ -55,15 +58,30 @@ struct poll_info
 
     auto operator co_await() noexcept -> poll_awaiter { return poll_awaiter{*this}; }
 
+    /**
+     * @return True if this poll info's timeout is pending in the io scheduler's timer_wheel.
+     */
+    [[nodiscard]] auto timer_armed() const noexcept -> bool { return m_timer_slot != timer_unlinked; }
+
     /// The file descriptor being polled on.  This is needed so that if the timeout occurs first then
     /// the event loop can immediately disable the event within epoll.
     fd_t m_fd{-1};
     /// The operation that is being waited for to be performed on the file descriptor.
     coro::poll_op m_op;
-    /// The timeout's position in the timeout map.  A poll() with no timeout or yield() this is empty.
-    /// This is needed so that if the event occurs first then the event loop can immediately disable
-    /// the timeout within epoll.
-    std::optional<timed_events::iterator> m_timer_pos{std::nullopt};
+    /// The registration when polling a registered file descriptor, its waiter slots are used instead of
+    /// watching the file descriptor with the io notifier.
+    fd_registration* m_fd_registration{nullptr};
+    /// The intrusive links of the timeout in the io scheduler's timer_wheel.  A poll() with no timeout
+    /// is never linked, this is needed so that if the event occurs first then the event loop can
+    /// immediately remove the timeout.
+    poll_info* m_timer_next{nullptr};
+    poll_info* m_timer_prev{nullptr};
+    /// The timeout's exact deadline, the timer_wheel only uses its tick to pick the timeout's list.
+    time_point m_timer_deadline{};
+    /// The timer_wheel tick the timeout's deadline falls within.
+    std::uint64_t m_timer_tick{0};
+    /// The timer_wheel list the timeout is linked into, or timer_unlinked.
+    std::uint16_t m_timer_slot{timer_unlinked};
     /// The awaiting coroutine for this poll info to resume upon event or timeout.
     std::coroutine_handle<> m_awaiting_coroutine;
     /// The status of the poll operation.
@@ -71,6 +89,22 @@ struct poll_info
     /// Did the timeout and event trigger at the same time on the same epoll_wait call?
     /// Once this is set to true all future events on this poll info are null and void.
     bool m_processed{false};
+    /// The io notifier's registration of this poll, io_uring needs it to cancel the poll if the timeout
+    /// wins and to discard the cancelled poll's completion.
+    std::uint64_t m_registration_id{0};
+    /// The result of a completion based io operation performed by the io notifier, see detail::io_operation.
+    std::int64_t m_result{0};
+    /// The provided buffer the io notifier selected for a completion based receive, or -1 if none was selected.
+    std::int32_t m_selected_buffer{-1};
+    /// Timers armed through io_scheduler::add_timer() call this upon expiring instead of resuming
+    /// m_awaiting_coroutine, the returned coroutine (if any) is then resumed by the scheduler.  It is
+    /// called while holding the scheduler's timer lock so a racing io_scheduler::cancel_timer() either
+    /// removes the timer first or waits for the callback to return.
+    std::coroutine_handle<> (*m_on_timeout)(poll_info&){nullptr};
+    /// Polls armed by io_scheduler::perform() call this from the event loop once the file descriptor is ready,
+    /// before m_awaiting_coroutine is resumed.  It retries the operation and returns false if the retry would
+    /// still block, in which case it has re-armed the poll and the awaiting coroutine stays suspended.
+    bool (*m_on_event)(poll_info&){nullptr};
 };
 
 } // namespace coro::detail
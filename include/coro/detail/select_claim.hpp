@@ -0,0 +1,32 @@
+#pragma once
+
+#include "coro/event.hpp"
+
+#include <atomic>
+
+namespace coro::detail
+{
+/**
+ * Shared by every waiter a single coro::select() registers with its sources.  Only the first source to
+ * claim it may complete the select, every other source must discard its waiter instead of resuming it.
+ */
+struct select_claim
+{
+    /**
+     * @param waiter The source's waiter that is attempting to complete the select.
+     * @return True if the caller won the claim and must signal m_ready once the waiter has its result.
+     */
+    auto try_claim(const void* waiter) noexcept -> bool
+    {
+        const void* expected = nullptr;
+        return m_winner.compare_exchange_strong(
+            expected, waiter, std::memory_order::acq_rel, std::memory_order::acquire);
+    }
+
+    /// The waiter that completed the select, nullptr until a source claims it.
+    std::atomic<const void*> m_winner{nullptr};
+    /// Set by the winning source once its waiter has been handed its result.
+    coro::event m_ready{};
+};
+
+} // namespace coro::detail
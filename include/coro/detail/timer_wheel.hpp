@@ -0,0 +1,113 @@
+#pragma once
+
+#include "coro/detail/poll_info.hpp"
+#include "coro/time.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace coro::detail
+{
+/**
+ * A hierarchical timing wheel storing the io_scheduler's timed events.  Timers are bucketed by the whole
+ * millisecond (tick) their deadline falls within, and each poll_info carries its own intrusive links so adding
+ * and removing a timer is O(1) and never allocates.  The wheel only buckets the timers, every timer keeps its
+ * exact deadline: the timers of the current tick are expired one by one once their deadline has passed and
+ * next_expiry() returns the exact earliest deadline, so sub-millisecond timers are not rounded up to a tick.
+ *
+ * Level 0 has a slot per tick, every higher level has a slot per full turn of the level below it.  A timer is
+ * placed on the lowest level whose slot covers its deadline relative to the current tick, as the current tick
+ * enters a higher level slot its timers are cascaded down until they reach level 0 and expire.  Deadlines
+ * beyond the top level are parked on an overflow list that is re-examined each time the top level wraps.
+ *
+ * The timing wheel is not thread safe, the io_scheduler guards it with its timer lock.
+ */
+class timer_wheel
+{
+public:
+    /// The resolution of the timing wheel.
+    using tick_duration = std::chrono::milliseconds;
+
+    /**
+     * @param epoch The time point of tick zero, deadlines before it expire on the first expire() call.
+     */
+    explicit timer_wheel(time_point epoch = clock::now()) noexcept;
+
+    timer_wheel(const timer_wheel&)                    = delete;
+    timer_wheel(timer_wheel&&)                         = delete;
+    auto operator=(const timer_wheel&) -> timer_wheel& = delete;
+    auto operator=(timer_wheel&&) -> timer_wheel&      = delete;
+
+    ~timer_wheel() = default;
+
+    /**
+     * Adds the poll info's timer, it must not already be in a timing wheel.
+     * @param pi The poll info to expire once the deadline has passed.
+     * @param deadline The time point to expire the poll info at.
+     */
+    auto add(poll_info& pi, time_point deadline) noexcept -> void;
+
+    /**
+     * Removes the poll info's timer.
+     * @param pi The poll info to remove.
+     * @return True if the poll info was in the timing wheel, false if it has already expired or was never added.
+     */
+    auto remove(poll_info& pi) noexcept -> bool;
+
+    /**
+     * Removes every timer whose deadline has passed.
+     * @param now The current time.
+     * @return The expired poll infos chained through their m_timer_next, or nullptr if none expired.
+     */
+    auto expire(time_point now) noexcept -> poll_info*;
+
+    /**
+     * @return The time point the timing wheel next needs to expire() at, this is either the exact earliest
+     *         deadline or the point at which the timers of a higher level slot are cascaded down.  Empty if there
+     *         are no timers.
+     */
+    [[nodiscard]] auto next_expiry() const noexcept -> std::optional<time_point>;
+
+    /**
+     * @return The number of timers in the timing wheel.
+     */
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return m_size; }
+
+    /**
+     * @return True if there are no timers in the timing wheel.
+     */
+    [[nodiscard]] auto empty() const noexcept -> bool { return m_size == 0; }
+
+private:
+    static constexpr std::uint64_t slot_bits{6};
+    static constexpr std::uint64_t slot_count{std::uint64_t{1} << slot_bits};
+    static constexpr std::uint64_t slot_mask{slot_count - 1};
+    static constexpr std::uint64_t level_count{6};
+    /// The list index of the overflow list, deadlines at or beyond 2^36 ticks (~2 years) from the current tick.
+    static constexpr std::uint16_t overflow_slot{level_count * slot_count};
+
+    /// The time point of tick zero.
+    time_point m_epoch;
+    /// The current tick, every tick before it has been expired.  Its own timers expire individually.
+    std::uint64_t m_current{0};
+    /// The number of timers in the timing wheel.
+    std::size_t m_size{0};
+    /// The heads of the circular timer lists, one per slot of each level followed by the overflow list.
+    std::array<poll_info*, level_count * slot_count + 1> m_slots{};
+    /// A bit per slot of each level set when the slot's list is not empty.
+    std::array<std::uint64_t, level_count> m_occupied{};
+
+    auto to_tick(time_point tp) const noexcept -> std::uint64_t;
+    auto to_time_point(std::uint64_t tick) const noexcept -> time_point;
+    auto link(poll_info& pi) noexcept -> void;
+    auto unlink(poll_info& pi) noexcept -> void;
+    auto take(std::uint16_t slot) noexcept -> poll_info*;
+    auto take_due(std::uint16_t slot, time_point now) noexcept -> poll_info*;
+    auto cascade() noexcept -> void;
+    auto next_cascade() const noexcept -> std::uint64_t;
+};
+
+} // namespace coro::detail
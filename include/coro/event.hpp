@@ -100,10 +100,13 @@ public:
 
     /**
      * Sets this event and resumes all awaiters onto the given executor.  This will distribute
-     * the waiters across the executor's threads.
+     * the waiters across the executor's threads.  The waiters are handed to the executor as a
+     * single batch so waking many waiters only takes the executor's queue lock once.  If the executor
+     * refuses the batch (e.g. it is shutting down) the waiters are resumed inline on this thread.
+     * @throw std::bad_alloc If the batch of waiters cannot be allocated.
      */
     template<concepts::executor executor_type>
-    auto set(std::unique_ptr<executor_type>& e, resume_order_policy policy = resume_order_policy::lifo) noexcept -> void
+    auto set(std::unique_ptr<executor_type>& e, resume_order_policy policy = resume_order_policy::lifo) -> void
     {
         void* old_value = m_state.exchange(this, std::memory_order::acq_rel);
         if (old_value != this)
@@ -115,12 +118,25 @@ public:
             }
             // else lifo nothing to do
 
-            auto* waiters = static_cast<awaiter*>(old_value);
-            while (waiters != nullptr)
+            std::size_t count{0};
+            for (auto* waiter = static_cast<awaiter*>(old_value); waiter != nullptr; waiter = waiter->m_next)
             {
-                auto* next = waiters->m_next;
-                e->resume(waiters->m_awaiting_coroutine);
-                waiters = next;
+                ++count;
+            }
+
+            std::vector<std::coroutine_handle<>> handles{};
+            handles.reserve(count);
+            for (auto* waiter = static_cast<awaiter*>(old_value); waiter != nullptr; waiter = waiter->m_next)
+            {
+                handles.emplace_back(waiter->m_awaiting_coroutine);
+            }
+
+            if (e->resume(handles) == 0)
+            {
+                for (auto& handle : handles)
+                {
+                    handle.resume();
+                }
             }
         }
     }
@@ -3,7 +3,11 @@
 #if defined(__FreeBSD__) || defined(__APPLE__) || defined(__OpenBSD__) || defined(__NetBSD__)
     #include "coro/detail/io_notifier_kqueue.hpp"
 #elif defined(__linux__)
-    #include "coro/detail/io_notifier_epoll.hpp"
+    #if defined(LIBCORO_FEATURE_IO_URING)
+        #include "coro/detail/io_notifier_uring.hpp"
+    #else
+        #include "coro/detail/io_notifier_epoll.hpp"
+    #endif
 #endif
 
 namespace coro
@@ -12,7 +16,11 @@ namespace coro
 #if defined(__FreeBSD__) || defined(__APPLE__) || defined(__OpenBSD__) || defined(__NetBSD__)
 using io_notifier = detail::io_notifier_kqueue;
 #elif defined(__linux__)
+    #if defined(LIBCORO_FEATURE_IO_URING)
+using io_notifier = detail::io_notifier_uring;
+    #else
 using io_notifier = detail::io_notifier_epoll;
+    #endif
 #endif
 
 } // namespace coro
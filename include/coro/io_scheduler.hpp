@@ -1,7 +1,10 @@
 #pragma once
 
+#include "coro/detail/fd_registration.hpp"
+#include "coro/detail/io_operation.hpp"
 #include "coro/detail/poll_info.hpp"
 #include "coro/detail/timer_handle.hpp"
+#include "coro/detail/timer_wheel.hpp"
 #include "coro/expected.hpp"
 #include "coro/fd.hpp"
 #include "coro/io_notifier.hpp"
@@ -14,11 +17,10 @@
     #include "coro/net/socket.hpp"
 #endif
 
-#include "detail/pipe.hpp"
+#include "detail/event_fd.hpp"
 
 #include <chrono>
 #include <functional>
-#include <map>
 #include <memory>
 #include <stop_token>
 #include <thread>
@@ -34,8 +36,6 @@ enum timeout_status
 
 class io_scheduler
 {
-    using timed_events = detail::poll_info::timed_events;
-
     struct private_constructor
     {
         explicit private_constructor() = default;
@@ -44,6 +44,14 @@ class io_scheduler
 public:
     class schedule_operation;
     friend schedule_operation;
+    class yield_operation;
+    friend yield_operation;
+    class poll_operation;
+    friend poll_operation;
+    class perform_operation;
+    friend perform_operation;
+    class registered_fd;
+    friend registered_fd;
 
     enum class thread_strategy_t
     {
@@ -83,6 +91,21 @@ public:
         /// If inline task processing is enabled then the io worker will resume tasks on its thread
         /// rather than scheduling them to be picked up by the thread pool.
         execution_strategy_t execution_strategy{execution_strategy_t::process_tasks_on_thread_pool};
+
+        /// The number of io events the event loop takes from the io notifier per wait.
+        std::size_t event_batch_size{16};
+        /// While waits keep filling the whole batch it doubles up to this many events, a value not above
+        /// event_batch_size keeps the batch at a fixed size.
+        std::size_t max_event_batch_size{16};
+
+        /// If greater than zero the dedicated event processor busy polls, it keeps checking for io events and
+        /// inline scheduled tasks without blocking until this long has passed without any, only then does it
+        /// block waiting for events.  This trades a core for lower wake-up latency.
+        std::chrono::microseconds busy_poll_budget{0};
+
+        /// The io notifier backend to drive the event loop with.  Only Linux builds with LIBCORO_FEATURE_IO_URING
+        /// have a choice, io_uring (default) or epoll, and io_uring falls back to epoll if the kernel lacks support.
+        io_notifier::backend_t backend{io_notifier::default_backend};
     };
 
     /**
@@ -106,7 +129,11 @@ public:
                      ((std::thread::hardware_concurrency() > 1) ? (std::thread::hardware_concurrency() - 1) : 1),
                  .on_thread_start_functor = nullptr,
                  .on_thread_stop_functor  = nullptr},
-            .execution_strategy = execution_strategy_t::process_tasks_on_thread_pool}) -> std::unique_ptr<io_scheduler>;
+            .execution_strategy   = execution_strategy_t::process_tasks_on_thread_pool,
+            .event_batch_size     = 16,
+            .max_event_batch_size = 16,
+            .busy_poll_budget     = std::chrono::microseconds{0},
+            .backend              = io_notifier::default_backend}) -> std::unique_ptr<io_scheduler>;
 
     io_scheduler(const io_scheduler&)                    = delete;
     io_scheduler(io_scheduler&&)                         = delete;
@@ -154,14 +181,10 @@ public:
 
                 // Trigger the event to wake-up the scheduler if this event isn't currently triggered.
                 bool expected{false};
-                if (m_scheduler.m_schedule_pipe_triggered.compare_exchange_strong(
+                if (m_scheduler.m_schedule_fd_triggered.compare_exchange_strong(
                         expected, true, std::memory_order::release, std::memory_order::relaxed))
                 {
-                    constexpr int control = 1;
-                    ::write(
-                        m_scheduler.m_schedule_pipe.write_fd(),
-                        reinterpret_cast<const void*>(&control),
-                        sizeof(control));
+                    m_scheduler.m_schedule_fd.notify();
                 }
             }
             else
@@ -185,6 +208,256 @@ public:
      */
     auto schedule() -> schedule_operation { return schedule_operation{*this}; }
 
+    /**
+     * Resumes the awaiting coroutine on this io_scheduler once a time point has passed.  The timer's poll
+     * info lives inline in the awaiting coroutine's frame so waiting never allocates, the timer is only
+     * armed once the operation is co_await'ed.
+     */
+    class yield_operation
+    {
+        friend class io_scheduler;
+        yield_operation(io_scheduler& scheduler, time_point time, std::chrono::nanoseconds amount) noexcept
+            : m_scheduler(scheduler),
+              m_time(time),
+              m_amount(amount)
+        {
+        }
+
+    public:
+        /**
+         * Operations always pause so the executing thread can be switched.
+         */
+        auto await_ready() noexcept -> bool { return false; }
+
+        /**
+         * Arms the timer, or schedules the awaiting coroutine immediately if the time point has already passed.
+         */
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void;
+
+        auto await_resume() noexcept -> void;
+
+    private:
+        /// The io_scheduler the awaiting coroutine is resumed on.
+        io_scheduler& m_scheduler;
+        /// The time point to resume at, used when m_amount is not positive.
+        time_point m_time;
+        /// The amount of time to yield for from the point the operation is co_await'ed.
+        std::chrono::nanoseconds m_amount;
+        /// The timer's poll info, it has no file descriptor.
+        detail::poll_info m_pi{};
+        /// Did this operation arm a timer rather than scheduling immediately?
+        bool m_timed{false};
+    };
+
+    /**
+     * Polls a file descriptor and resumes the awaiting coroutine once it is ready or the timeout expires.  The
+     * poll info lives inline in the awaiting coroutine's frame so polling never allocates, the file descriptor is
+     * only watched once the operation is co_await'ed.  The operation must be co_await'ed at most once.
+     */
+    class poll_operation
+    {
+        friend class io_scheduler;
+        poll_operation(io_scheduler& scheduler, fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout) noexcept
+            : m_scheduler(scheduler),
+              m_pi(fd, op),
+              m_timeout(timeout)
+        {
+        }
+
+        poll_operation(
+            io_scheduler&             scheduler,
+            detail::fd_registration&  registration,
+            coro::poll_op             op,
+            std::chrono::milliseconds timeout) noexcept
+            : m_scheduler(scheduler),
+              m_pi(registration.m_fd, op),
+              m_timeout(timeout)
+        {
+            m_pi.m_fd_registration = &registration;
+        }
+
+    public:
+        /**
+         * Operations always pause so the event loop can resume the awaiting coroutine.
+         */
+        auto await_ready() noexcept -> bool { return false; }
+
+        /**
+         * Arms the timeout, if one was requested, and watches the file descriptor.  A registered file descriptor
+         * whose latched readiness already satisfies the poll resumes the awaiting coroutine immediately.
+         */
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
+
+        /**
+         * @return The result of the poll operation.
+         */
+        auto await_resume() noexcept -> poll_status;
+
+    private:
+        /// The io_scheduler polling the file descriptor.
+        io_scheduler& m_scheduler;
+        /// The poll's event and timeout.
+        detail::poll_info m_pi;
+        /// The amount of time to wait for the event, zero waits indefinitely.
+        std::chrono::milliseconds m_timeout;
+        /// Did the awaiting coroutine suspend?
+        bool m_suspended{false};
+    };
+
+    /**
+     * Performs a socket operation to completion, see io_scheduler::perform().  The operation and its poll info live
+     * inline in the awaiting coroutine's frame so performing it never allocates.  Without io_uring the syscall is
+     * attempted in await_ready() and the socket is only polled if it would block, the event loop then retries the
+     * syscall once the socket is ready and keeps polling without resuming the awaiting coroutine while the retry
+     * would still block.  The operation must be co_await'ed at most once.
+     */
+    class perform_operation
+    {
+        friend class io_scheduler;
+        perform_operation(io_scheduler& scheduler, detail::io_operation op, std::chrono::milliseconds timeout) noexcept
+            : m_scheduler(scheduler),
+              m_op(op),
+              m_timeout(timeout),
+              m_pi(*this)
+        {
+        }
+
+    public:
+        /**
+         * Attempts the syscall unless the kernel performs the operation.
+         */
+        auto await_ready() noexcept -> bool;
+
+        /**
+         * Submits the operation to the kernel, or polls the socket until the operation no longer would block.
+         */
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
+
+        /**
+         * @return The operation's result, see io_scheduler::perform().
+         */
+        auto await_resume() noexcept -> std::int64_t;
+
+    private:
+        /// The poll info handed to on_event(), it links back to its operation.
+        struct entry : detail::poll_info
+        {
+            explicit entry(perform_operation& operation) noexcept : m_operation(operation) {}
+
+            perform_operation& m_operation;
+        };
+
+        /**
+         * Performs the syscall into m_result.
+         * @return True if the operation completed, false if it would block.
+         */
+        auto execute() noexcept -> bool;
+
+        /**
+         * Called by the event loop once the polled socket is ready, see detail::poll_info::m_on_event.
+         */
+        static auto on_event(detail::poll_info& pi) -> bool;
+
+        /// The io_scheduler performing the operation.
+        io_scheduler& m_scheduler;
+        /// The operation to perform.
+        detail::io_operation m_op;
+        /// The amount of time to wait for the operation to complete, zero waits indefinitely.
+        std::chrono::milliseconds m_timeout;
+        /// The point in time the timeout expires at, set when the operation is co_await'ed.
+        time_point m_deadline{};
+        /// The submission's or the poll's state.
+        entry m_pi;
+        /// The result of the last syscall.
+        std::int64_t m_result{0};
+        /// Did the awaiting coroutine suspend?
+        bool m_suspended{false};
+        /// Is the socket being polled for readiness rather than the kernel performing the operation?
+        bool m_polled{false};
+    };
+
+    /**
+     * A file descriptor registered with this io_scheduler once for its lifetime rather than on every poll.  It is
+     * watched edge triggered for both read and write readiness and the readiness is latched until clear() is called,
+     * so polling it costs no io notifier syscalls.  One reader and one writer can poll it concurrently.
+     *
+     * Since readiness is latched a poll completes immediately until clear() is called for its direction, call it
+     * once a recv or send on the file descriptor fails with EAGAIN/EWOULDBLOCK and then poll again.
+     * \code
+auto registered = scheduler->register_fd(client.socket().native_handle());
+while (true)
+{
+    co_await scheduler->poll(registered, coro::poll_op::read);
+    auto [rstatus, rspan] = client.recv(buffer);
+    if (rstatus == coro::net::recv_status::would_block)
+    {
+        registered.clear(coro::poll_op::read);
+        continue;
+    }
+    ...
+}
+     * \endcode
+     * The registration must be destroyed before the file descriptor is closed and no poll may be pending on it.
+     */
+    class registered_fd
+    {
+        friend class io_scheduler;
+        registered_fd(io_scheduler& scheduler, std::unique_ptr<detail::fd_registration> registration) noexcept
+            : m_scheduler(&scheduler),
+              m_registration(std::move(registration))
+        {
+        }
+
+    public:
+        registered_fd(const registered_fd&) = delete;
+        registered_fd(registered_fd&& other) noexcept
+            : m_scheduler(std::exchange(other.m_scheduler, nullptr)),
+              m_registration(std::move(other.m_registration))
+        {
+        }
+        auto operator=(const registered_fd&) -> registered_fd& = delete;
+        auto operator=(registered_fd&& other) noexcept -> registered_fd&
+        {
+            if (std::addressof(other) != this)
+            {
+                reset();
+                m_scheduler    = std::exchange(other.m_scheduler, nullptr);
+                m_registration = std::move(other.m_registration);
+            }
+            return *this;
+        }
+        ~registered_fd() { reset(); }
+
+        /**
+         * @return The registered file descriptor, or -1 if this was moved from.
+         */
+        [[nodiscard]] auto fd() const noexcept -> fd_t
+        {
+            return (m_registration != nullptr) ? m_registration->m_fd : -1;
+        }
+
+        /**
+         * Forgets the latched readiness for the given direction(s), call this once an operation would block.
+         * Readiness reported since the last poll in that direction completed is kept so it is never lost.
+         * @param op The direction(s) that would block.
+         */
+        auto clear(coro::poll_op op) -> void
+        {
+            if (m_registration != nullptr)
+            {
+                m_registration->clear(op);
+            }
+        }
+
+    private:
+        /// The io_scheduler the file descriptor is registered with.
+        io_scheduler* m_scheduler{nullptr};
+        /// The registration's readiness and waiters, it lives on the heap since the io notifier refers to it.
+        std::unique_ptr<detail::fd_registration> m_registration{nullptr};
+
+        auto reset() noexcept -> void;
+    };
+
     /**
      * Spawns a task into the io_scheduler and moves ownership of the task to the io_scheduler.
      * Only void return type tasks can be spawned in this manner since the task submitter will no
@@ -327,9 +600,9 @@ public:
      *               Given zero or negative amount of time this behaves identical to schedule().
      */
     template<class rep_type, class period_type>
-    [[nodiscard]] auto schedule_after(std::chrono::duration<rep_type, period_type> amount) -> coro::task<void>
+    [[nodiscard]] auto schedule_after(std::chrono::duration<rep_type, period_type> amount) -> yield_operation
     {
-        return yield_for_internal(std::chrono::duration_cast<std::chrono::nanoseconds>(amount));
+        return yield_operation{*this, time_point::min(), std::chrono::duration_cast<std::chrono::nanoseconds>(amount)};
     }
 
     /**
@@ -337,7 +610,10 @@ public:
      * @param time The time point to resume execution of this task.  Given 'now' or a time point
      *             in the past this behaves identical to schedule().
      */
-    [[nodiscard]] auto schedule_at(time_point time) -> coro::task<void>;
+    [[nodiscard]] auto schedule_at(time_point time) -> yield_operation
+    {
+        return yield_operation{*this, time, std::chrono::nanoseconds{0}};
+    }
 
     /**
      * Yields the current task to the end of the queue of waiting tasks.
@@ -350,9 +626,9 @@ public:
      *               Given zero or negative amount of time this behaves identical to yield().
      */
     template<class rep_type, class period_type>
-    [[nodiscard]] auto yield_for(std::chrono::duration<rep_type, period_type> amount) -> coro::task<void>
+    [[nodiscard]] auto yield_for(std::chrono::duration<rep_type, period_type> amount) -> yield_operation
     {
-        return yield_for_internal(std::chrono::duration_cast<std::chrono::nanoseconds>(amount));
+        return yield_operation{*this, time_point::min(), std::chrono::duration_cast<std::chrono::nanoseconds>(amount)};
     }
 
     /**
@@ -360,7 +636,10 @@ public:
      * @param time The time point to resume execution of this task.  Given 'now' or a time point in the
      *             in the past this behaves identical to yield().
      */
-    [[nodiscard]] auto yield_until(time_point time) -> coro::task<void>;
+    [[nodiscard]] auto yield_until(time_point time) -> yield_operation
+    {
+        return yield_operation{*this, time, std::chrono::nanoseconds{0}};
+    }
 
     /**
      * Polls the given file descriptor for the given operations.
@@ -371,7 +650,36 @@ public:
      * @return The result of the poll operation.
      */
     [[nodiscard]] auto poll(fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>;
+        -> poll_operation
+    {
+        return poll_operation{*this, fd, op, timeout};
+    }
+
+    /**
+     * Registers the file descriptor with this io_scheduler for its lifetime, see io_scheduler::registered_fd.
+     * @throw std::runtime_error If the io notifier fails to watch the file descriptor.
+     * @param fd The file descriptor to register, it must not be polled through poll(fd_t ...) while registered.
+     * @return The registration, it must be destroyed before the file descriptor is closed.
+     */
+    [[nodiscard]] auto register_fd(fd_t fd) -> registered_fd;
+
+    /**
+     * Polls the given registered file descriptor for the given operations.  This completes immediately if the
+     * registration's latched readiness already satisfies the operations.
+     * @param registered The registered file descriptor to poll for events.
+     * @param op The operations to poll for.
+     * @param timeout The amount of time to wait for the events to trigger.  A timeout of zero will
+     *                block indefinitely until the event triggers.
+     * @return The result of the poll operation.  poll_status::error if another poll is already waiting on the
+     *         registration in the same direction.
+     */
+    [[nodiscard]] auto poll(
+        registered_fd&            registered,
+        coro::poll_op             op,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> poll_operation
+    {
+        return poll_operation{*this, *registered.m_registration, op, timeout};
+    }
 
 #ifdef LIBCORO_FEATURE_NETWORKING
     /**
@@ -385,32 +693,92 @@ public:
     [[nodiscard]] auto poll(
         const net::socket&        sock,
         coro::poll_op             op,
-        std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<poll_status>
+        std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> poll_operation
     {
         return poll(sock.native_handle(), op, timeout);
     }
 #endif
 
+    /**
+     * Performs the socket operation to completion.  With the io_uring backend the kernel performs the operation
+     * with a single submission, otherwise the syscall is attempted optimistically and the socket is polled for
+     * readiness only if it would block.
+     * @param op The operation to perform, its buffers must stay alive until the returned operation completes.
+     * @param timeout The amount of time to wait for the operation to complete.  A timeout of zero will
+     *                block indefinitely until the operation completes.
+     * @return The operation's result, the number of bytes transferred, the accepted file descriptor or zero for
+     *         a connect, or the negated errno on failure.  -ETIMEDOUT if the timeout expired first.
+     */
+    [[nodiscard]] auto perform(detail::io_operation op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> perform_operation
+    {
+        return perform_operation{*this, op, timeout};
+    }
+
+    /**
+     * Arms a timer that calls `pi.m_on_timeout` from the event loop once the given time point has passed,
+     * this lets awaiters wait on a timeout without a coroutine frame of their own. The poll info must stay
+     * alive until the callback has been called or cancel_timer() returns true.
+     * @param time The time point to fire the timer at.
+     * @param pi The poll info to arm, `m_on_timeout` must be set.
+     */
+    auto add_timer(time_point time, detail::poll_info& pi) -> void;
+
+    /**
+     * Disarms a timer armed via add_timer(). If the timer is concurrently firing this waits for its
+     * callback to return.
+     * @param pi The poll info that was armed.
+     * @return True if the timer was removed before it fired.
+     */
+    auto cancel_timer(detail::poll_info& pi) -> bool;
+
     /**
      * Resumes execution of a direct coroutine handle on this io scheduler.
      * @param handle The coroutine handle to resume execution.
      */
     auto resume(std::coroutine_handle<> handle) -> bool;
 
+    /**
+     * Resumes execution of a set of coroutine handles on this io scheduler as a single batch.
+     * @param handles The coroutine handles to resume, null or completed handles are discarded.
+     * @return The number of handles resumed.
+     */
     template<coro::concepts::sized_range_of<std::coroutine_handle<>> range_type>
     auto resume(const range_type& handles) noexcept -> std::size_t
     {
-        auto        size = std::size(handles);
-        std::size_t invalid_handles{0};
-        for (const auto& handle : handles)
+        if (m_shutdown_requested.load(std::memory_order::acquire))
+        {
+            return 0;
+        }
+
+        if (m_opts.execution_strategy != execution_strategy_t::process_tasks_inline)
+        {
+            return m_thread_pool->resume(handles);
+        }
+
+        std::size_t total{0};
         {
-            if (!resume(handle))
+            std::scoped_lock lk{m_scheduled_tasks_mutex};
+            for (const auto& handle : handles)
             {
-                ++invalid_handles;
+                if (handle != nullptr && !handle.done())
+                {
+                    m_scheduled_tasks.emplace_back(handle);
+                    ++total;
+                }
             }
+            m_size.fetch_add(total, std::memory_order::release);
+        }
+
+        // One wake-up of the event loop for the entire batch.
+        bool expected{false};
+        if (total > 0 && m_schedule_fd_triggered.compare_exchange_strong(
+                             expected, true, std::memory_order::release, std::memory_order::relaxed))
+        {
+            m_schedule_fd.notify();
         }
 
-        return size - invalid_handles;
+        return total;
     }
 
     /**
@@ -441,6 +809,11 @@ public:
 
     [[nodiscard]] auto is_shutdown() const -> bool { return m_shutdown_requested.load(std::memory_order::acquire); }
 
+    /**
+     * @return The io notifier driving this scheduler, for io primitives that integrate with its backend directly.
+     */
+    [[nodiscard]] auto notifier() noexcept -> io_notifier& { return m_io_notifier; }
+
 private:
     /// The configuration options.
     options m_opts;
@@ -449,11 +822,11 @@ private:
     io_notifier m_io_notifier;
     /// The timer handle for timed events, e.g. yield_for() or scheduler_after().
     detail::timer_handle m_timer;
-    /// The event loop pipe to trigger a shutdown.
-    detail::pipe_t m_shutdown_pipe{};
-    /// The event loop schedule task pipe.
-    detail::pipe_t    m_schedule_pipe{};
-    std::atomic<bool> m_schedule_pipe_triggered{false};
+    /// The event loop's doorbell, rung to schedule tasks inline or to wake it up for a shutdown.
+    detail::event_fd_t m_schedule_fd{};
+    std::atomic<bool>  m_schedule_fd_triggered{false};
+    /// Is the event loop busy polling?  The doorbell is then held triggered so scheduling does not ring it.
+    bool m_busy_polling{false};
 
     /// The number of tasks executing or awaiting events in this io scheduler.
     std::atomic<std::size_t> m_size{0};
@@ -464,28 +837,27 @@ private:
     std::unique_ptr<thread_pool> m_thread_pool{nullptr};
 
     std::mutex m_timed_events_mutex{};
-    /// The map of time point's to poll infos for tasks that are yielding for a period of time
-    /// or for tasks that are polling with timeouts.
-    timed_events m_timed_events{};
+    /// The timing wheel of poll infos for tasks that are yielding for a period of time or for
+    /// tasks that are polling with timeouts.
+    detail::timer_wheel m_timed_events{};
+    /// The time point the timer is armed to fire at, time_point::max() when it is disarmed.
+    time_point m_timer_deadline{time_point::max()};
 
     /// Has the io_scheduler been requested to shut down?
     std::atomic<bool> m_shutdown_requested{false};
 
-    auto yield_for_internal(std::chrono::nanoseconds amount) -> coro::task<void>;
-
     std::atomic<bool> m_io_processing{false};
     auto              process_events_manual(std::chrono::milliseconds timeout) -> void;
     auto              process_events_dedicated_thread() -> void;
+    auto              process_events_busy_poll() -> void;
     auto              process_events_execute(std::chrono::milliseconds timeout) -> void;
     static auto       event_to_poll_status(uint32_t events) -> poll_status;
 
     auto                                 process_scheduled_execute_inline() -> void;
+    auto                                 process_scheduled_execute_busy_poll() -> bool;
     std::mutex                           m_scheduled_tasks_mutex{};
     std::vector<std::coroutine_handle<>> m_scheduled_tasks{};
 
-    static constexpr const int   m_shutdown_object{0};
-    static constexpr const void* m_shutdown_ptr = &m_shutdown_object;
-
     static constexpr const int   m_timer_object{0};
     static constexpr const void* m_timer_ptr = &m_timer_object;
 
@@ -494,16 +866,18 @@ private:
 
     static const constexpr std::chrono::milliseconds              m_default_timeout{1000};
     static const constexpr std::chrono::milliseconds              m_no_timeout{0};
-    static const constexpr std::size_t                            m_max_events = 16;
     std::vector<std::pair<detail::poll_info*, coro::poll_status>> m_recent_events{};
     std::vector<std::coroutine_handle<>>                          m_handles_to_resume{};
 
     auto process_event_execute(detail::poll_info* pi, poll_status status) -> void;
     auto process_timeout_execute() -> void;
 
-    auto add_timer_token(time_point tp, detail::poll_info& pi) -> timed_events::iterator;
-    auto remove_timer_token(timed_events::iterator pos) -> void;
+    auto add_timer_token(time_point tp, detail::poll_info& pi) -> void;
+    auto remove_timer_token(detail::poll_info& pi) -> void;
+    /// Arms the timer for the timing wheel's next expiry, or disarms it if there are no timers.
     auto update_timeout(time_point now) -> void;
+    /// Arms the timer for the given deadline if it is earlier than the one the timer is armed for.
+    auto arm_timer(time_point deadline, time_point now) -> void;
 
     auto make_timeout_task(std::chrono::milliseconds timeout) -> coro::task<timeout_status>
     {
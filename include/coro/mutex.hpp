@@ -1,12 +1,21 @@
 #pragma once
 
+#include "coro/concepts/executor.hpp"
+#include "coro/event.hpp"
 #include "coro/task.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <coroutine>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <utility>
 
+#ifdef LIBCORO_FEATURE_NETWORKING
+    #include "coro/detail/poll_info.hpp"
+#endif
+
 namespace coro
 {
 class mutex;
@@ -19,7 +28,7 @@ namespace detail
 struct lock_operation_base
 {
     explicit lock_operation_base(coro::mutex& m) : m_mutex(m) {}
-    virtual ~lock_operation_base() = default;
+    ~lock_operation_base() = default;
 
     lock_operation_base(const lock_operation_base&) = delete;
     lock_operation_base(lock_operation_base&&) = delete;
@@ -29,8 +38,17 @@ struct lock_operation_base
     auto await_ready() const noexcept -> bool;
     auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
 
+    /**
+     * Only set by timed waiters and locked callbacks, plain waiters are resumed directly.  Called by the unlocker
+     * once this waiter has been popped and the lock transferred to it.
+     * @return The coroutine to resume, a null handle if nothing needs to be resumed, or std::nullopt if
+     *         this waiter is done with the lock and it must be handed to the next waiter instead.
+     */
+    using handoff_hook = auto (*)(lock_operation_base&) noexcept -> std::optional<std::coroutine_handle<>>;
+
     std::coroutine_handle<> m_awaiting_coroutine;
     lock_operation_base*    m_next{nullptr};
+    handoff_hook            m_on_handoff{nullptr};
 
 protected:
     friend class coro::mutex;
@@ -42,7 +60,7 @@ template<typename return_type>
 struct lock_operation : public lock_operation_base
 {
     explicit lock_operation(coro::mutex& m) : lock_operation_base(m) {}
-    ~lock_operation() override = default;
+    ~lock_operation() = default;
 
     lock_operation(const lock_operation&) = delete;
     lock_operation(lock_operation&&) = delete;
@@ -62,6 +80,114 @@ struct lock_operation : public lock_operation_base
     }
 };
 
+/**
+ * Runs a callback while holding the mutex without a coroutine of its own, the timed waiters of primitives that
+ * are guarded by a coro::mutex use it to unlink themselves from their timer callback.  The callback runs inline
+ * if the mutex is free, otherwise it is queued like any other waiter and run by the unlocker that hands it the
+ * lock.  The lock is passed on to the next waiter once the callback returns, so the callback must not resume
+ * anything inline and must not touch this operation after handing its owner back to an executor.
+ */
+struct locked_callback : public lock_operation_base
+{
+    /// Called with the mutex held, `ran_inline` is true if run() found the mutex free and calls it directly.
+    using callback_type = auto (*)(locked_callback&, bool ran_inline) noexcept -> void;
+
+    locked_callback(coro::mutex& m, callback_type callback) : lock_operation_base(m), m_callback(callback)
+    {
+        m_on_handoff = &locked_callback::on_handoff;
+    }
+
+    /**
+     * Runs the callback now if the mutex is free, otherwise once the lock is handed to it.
+     * @param e The executor the next waiter is resumed on if the callback runs inline.
+     * @return True if the callback ran inline.
+     */
+    template<concepts::executor executor_type>
+    auto run(std::unique_ptr<executor_type>& e) -> bool;
+
+    static auto on_handoff(lock_operation_base& base) noexcept -> std::optional<std::coroutine_handle<>>
+    {
+        auto& self = static_cast<locked_callback&>(base);
+        self.m_callback(self, false);
+        return std::nullopt;
+    }
+
+    callback_type m_callback;
+};
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+/**
+ * Acquires the mutex or gives up once the timeout expires.  The awaiter is queued in the mutex's lock-free waiter
+ * list like any other waiter.  On timeout the timer callback unlinks it again, while any timed waiter is queued
+ * the lock holder only takes waiters from the list while holding the mutex's internal m_timed_mutex so the two
+ * never race.
+ */
+template<concepts::io_executor io_executor_type>
+struct timed_lock_operation : public lock_operation_base
+{
+    enum class state_t : uint8_t
+    {
+        /// The awaiter is being queued and the timer armed, it has not suspended yet.
+        registering,
+        /// The awaiter is suspended waiting on the lock or the timer.
+        waiting,
+        /// The lock has been handed to the awaiter.
+        acquired,
+        /// The timer fired while registering and unlinked the awaiter.
+        registering_timed_out,
+        /// The timer fired first and unlinked the awaiter.
+        timed_out
+    };
+
+    /// @brief The timer entry handed to the io executor, it points back at its awaiter.
+    struct timer_entry : public detail::poll_info
+    {
+        explicit timer_entry(timed_lock_operation& operation) : m_operation(operation) {}
+        timed_lock_operation& m_operation;
+    };
+
+    timed_lock_operation(coro::mutex& m, std::unique_ptr<io_executor_type>& executor, std::chrono::nanoseconds timeout)
+        : lock_operation_base(m),
+          m_executor(executor),
+          m_timeout(timeout),
+          m_timer(*this)
+    {
+        m_on_handoff         = &timed_lock_operation::on_handoff;
+        m_timer.m_on_timeout = &timed_lock_operation::on_timeout;
+    }
+
+    timed_lock_operation(const timed_lock_operation&)                    = delete;
+    timed_lock_operation(timed_lock_operation&&)                         = delete;
+    auto operator=(const timed_lock_operation&) -> timed_lock_operation& = delete;
+    auto operator=(timed_lock_operation&&) -> timed_lock_operation&      = delete;
+
+    auto await_ready() noexcept -> bool;
+
+    auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool;
+
+    /**
+     * @return True if the lock was acquired, false if the timeout expired first.
+     */
+    auto await_resume() noexcept -> bool { return m_acquired; }
+
+    static auto on_handoff(lock_operation_base& base) noexcept -> std::optional<std::coroutine_handle<>>;
+
+    /**
+     * @brief Called by the io executor when the timer expires while holding its timer lock.
+     * @return The awaiting coroutine if it was suspended and has been unlinked.
+     */
+    static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>;
+
+    std::unique_ptr<io_executor_type>& m_executor;
+    std::chrono::nanoseconds           m_timeout;
+    std::atomic<state_t>               m_state{state_t::registering};
+    timer_entry                        m_timer;
+    bool                               m_acquired{false};
+};
+
+#endif
+
 } // namespace detail
 
 /**
@@ -109,6 +235,14 @@ public:
      */
     auto unlock() -> void;
 
+    /**
+     * Unlocks the scoped lock prior to it going out of scope, the next waiter (if any) is resumed on
+     * the given executor instead of inline on this thread.
+     * @param e The executor to resume the next waiter on.
+     */
+    template<concepts::executor executor_type>
+    auto unlock(std::unique_ptr<executor_type>& e) -> void;
+
 private:
     class coro::mutex* m_mutex{nullptr};
 };
@@ -116,7 +250,16 @@ private:
 class mutex
 {
 public:
-    explicit mutex() noexcept : m_state(const_cast<void*>(unlocked_value())) {}
+    /**
+     * @param policy The order in which waiters acquire the lock.  LIFO is the default since it is the
+     *               cheapest, FIFO hands the lock to waiters in the order they suspended at the cost of
+     *               reversing each newly acquired batch of waiters.
+     */
+    explicit mutex(resume_order_policy policy = resume_order_policy::lifo) noexcept
+        : m_state(const_cast<void*>(unlocked_value())),
+          m_policy(policy)
+    {
+    }
     ~mutex() = default;
 
     mutex(const mutex&)                    = delete;
@@ -144,18 +287,91 @@ public:
      */
     [[nodiscard]] auto try_lock() -> bool;
 
+#ifdef LIBCORO_FEATURE_NETWORKING
     /**
-     * Releases the mutex's lock.
+     * Attempts to lock the mutex, giving up if the lock has not been acquired before the timeout expires.
+     * A waiter that times out stops waiting immediately, the lock will never be handed to it.
+     * @param executor The io executor that drives the timeout.
+     * @param timeout How long to wait for the lock.
+     * @return A co_await'able operation that returns true if the lock was acquired.  The caller must unlock()
+     *         the mutex if it was acquired.
+     */
+    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    [[nodiscard]] auto try_lock_for(
+        std::unique_ptr<io_executor_type>& executor, const std::chrono::duration<rep_type, period_type> timeout)
+        -> detail::timed_lock_operation<io_executor_type>
+    {
+        return detail::timed_lock_operation<io_executor_type>{
+            *this, executor, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)};
+    }
+#endif
+
+    /**
+     * Releases the mutex's lock.  The next waiter (if any) acquires the lock and is resumed inline on
+     * this thread before unlock() returns.
      */
     auto unlock() -> void;
 
+    /**
+     * Releases the mutex's lock.  The next waiter (if any) acquires the lock and is resumed on the given
+     * executor, this thread returns immediately instead of running the waiter's critical section.  If the
+     * executor refuses the waiter (e.g. it is shutting down) the waiter is resumed inline.
+     * @param e The executor to resume the next waiter on.
+     */
+    template<concepts::executor executor_type>
+    auto unlock(std::unique_ptr<executor_type>& e) -> void
+    {
+        if (auto handle = handoff(); handle != nullptr)
+        {
+            std::atomic_thread_fence(std::memory_order::acq_rel);
+            if (!e->resume(handle))
+            {
+                handle.resume();
+            }
+        }
+    }
+
 private:
     friend struct detail::lock_operation_base;
+#ifdef LIBCORO_FEATURE_NETWORKING
+    template<concepts::io_executor io_executor_type>
+    friend struct detail::timed_lock_operation;
+#endif
+
+    /**
+     * Transfers the lock to the next waiter that has not abandoned it, or unlocks the mutex if there is none.
+     * @return The coroutine that now owns the lock and must be resumed by the caller, or nullptr.
+     */
+    auto handoff() -> std::coroutine_handle<>;
+
+    /**
+     * Unlocks the mutex if there are no waiters, otherwise the lock is transferred to the next waiter
+     * which is returned and must be resumed by the caller.
+     * @return The waiter that now owns the lock, or nullptr if the mutex is now unlocked.
+     */
+    auto pop_next_waiter() -> detail::lock_operation_base*;
+
+    /**
+     * Unlinks a timed out waiter from wherever it is queued, must be called with m_timed_mutex held.
+     * @return False if the waiter has already been popped by the lock holder.
+     */
+    auto unlink_waiter_locked(detail::lock_operation_base& waiter) -> bool;
 
     /// unlocked -> state == unlocked_value()
     /// locked but empty waiter list == nullptr
     /// locked with waiters == lock_operation_base*
     std::atomic<void*> m_state;
+    /// The order in which waiters acquire the lock.
+    resume_order_policy m_policy;
+    /// FIFO mode only, the waiters taken from m_state in the order they suspended.  Only the current
+    /// lock holder accesses this list so it does not need to be atomic.
+    detail::lock_operation_base* m_fifo_waiters{nullptr};
+    /// The number of timed waiters in m_state or m_fifo_waiters.  A timed waiter is counted before it is queued
+    /// and until it has left the lists for good, while it is non-zero the lock holder takes waiters while holding
+    /// m_timed_mutex so timed out waiters can unlink themselves.
+    std::atomic<std::uint32_t> m_timed_waiters{0};
+    /// Serializes the lock holder taking waiters with timed out waiters unlinking themselves.
+    std::mutex m_timed_mutex;
 
     /// Inactive value, this cannot be nullptr since we want nullptr to signify that the mutex
     /// is locked but there are zero waiters, this makes it easy to CAS new waiters into the
@@ -163,4 +379,130 @@ private:
     auto unlocked_value() const noexcept -> const void* { return &m_state; }
 };
 
+template<concepts::executor executor_type>
+auto detail::locked_callback::run(std::unique_ptr<executor_type>& e) -> bool
+{
+    if (lock_operation_base::await_suspend(nullptr))
+    {
+        return false;
+    }
+
+    // The lock was free, the caller may be holding locks of its own so the next waiter is not resumed inline.
+    m_callback(*this, true);
+    m_mutex.unlock(e);
+    return true;
+}
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+template<concepts::io_executor io_executor_type>
+auto detail::timed_lock_operation<io_executor_type>::await_ready() noexcept -> bool
+{
+    m_acquired = m_mutex.try_lock();
+    return m_acquired;
+}
+
+template<concepts::io_executor io_executor_type>
+auto detail::timed_lock_operation<io_executor_type>::await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool
+{
+    m_mutex.m_timed_waiters.fetch_add(1, std::memory_order::seq_cst);
+    if (!lock_operation_base::await_suspend(awaiting_coroutine))
+    {
+        // The lock became available while queueing.
+        m_mutex.m_timed_waiters.fetch_sub(1, std::memory_order::release);
+        m_acquired = true;
+        return false;
+    }
+
+    // The awaiter is now visible to the lock holder, it cannot be resumed until it is marked as waiting.
+    m_executor->add_timer(clock::now() + m_timeout, m_timer);
+
+    auto expected = state_t::registering;
+    if (m_state.compare_exchange_strong(expected, state_t::waiting, std::memory_order::acq_rel, std::memory_order::acquire))
+    {
+        return true;
+    }
+
+    if (expected == state_t::acquired)
+    {
+        // The timer must not be searching the waiter lists once the awaiter stops being counted.
+        m_executor->cancel_timer(m_timer);
+        m_mutex.m_timed_waiters.fetch_sub(1, std::memory_order::release);
+        m_acquired = true;
+        return false;
+    }
+
+    // The timer already fired and unlinked the awaiter.
+    m_acquired = false;
+    return false;
+}
+
+template<concepts::io_executor io_executor_type>
+auto detail::timed_lock_operation<io_executor_type>::on_handoff(lock_operation_base& base) noexcept
+    -> std::optional<std::coroutine_handle<>>
+{
+    auto& self  = static_cast<timed_lock_operation&>(base);
+    auto  state = self.m_state.load(std::memory_order::acquire);
+    while (true)
+    {
+        // A timed out awaiter has always been unlinked before it is marked as such, it is never popped.
+        auto desired = state_t::acquired;
+        if (self.m_state.compare_exchange_weak(state, desired, std::memory_order::acq_rel, std::memory_order::acquire))
+        {
+            break;
+        }
+    }
+
+    if (state == state_t::registering)
+    {
+        // The awaiter has not suspended yet, it notices the lock is its own and cancels the timer itself.
+        return std::coroutine_handle<>{nullptr};
+    }
+
+    // If the timer is concurrently firing this waits for it to back off, it cannot find the awaiter anymore.
+    self.m_executor->cancel_timer(self.m_timer);
+    self.m_mutex.m_timed_waiters.fetch_sub(1, std::memory_order::release);
+    self.m_acquired = true;
+    return self.m_awaiting_coroutine;
+}
+
+template<concepts::io_executor io_executor_type>
+auto detail::timed_lock_operation<io_executor_type>::on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+{
+    auto&            self = static_cast<timer_entry&>(pi).m_operation;
+    std::scoped_lock lk{self.m_mutex.m_timed_mutex};
+    if (!self.m_mutex.unlink_waiter_locked(self))
+    {
+        // The lock holder popped the awaiter first and is handing it the lock.
+        return nullptr;
+    }
+    self.m_mutex.m_timed_waiters.fetch_sub(1, std::memory_order::release);
+
+    auto state = self.m_state.load(std::memory_order::acquire);
+    while (true)
+    {
+        auto desired = state == state_t::registering ? state_t::registering_timed_out : state_t::timed_out;
+        if (self.m_state.compare_exchange_weak(state, desired, std::memory_order::acq_rel, std::memory_order::acquire))
+        {
+            if (desired == state_t::registering_timed_out)
+            {
+                // The awaiter sees the timeout before it suspends.
+                return nullptr;
+            }
+            self.m_acquired = false;
+            return self.m_awaiting_coroutine;
+        }
+    }
+}
+#endif
+
+template<concepts::executor executor_type>
+auto scoped_lock::unlock(std::unique_ptr<executor_type>& e) -> void
+{
+    if (m_mutex != nullptr)
+    {
+        std::atomic_thread_fence(std::memory_order::acq_rel);
+        std::exchange(m_mutex, nullptr)->unlock(e);
+    }
+}
+
 } // namespace coro
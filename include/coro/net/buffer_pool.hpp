@@ -0,0 +1,272 @@
+#pragma once
+
+#include "coro/fd.hpp"
+#include "coro/io_scheduler.hpp"
+#include "coro/net/recv_status.hpp"
+#include "coro/task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace coro::net
+{
+/**
+ * A buffer pool is a set of fixed size receive buffers shared by many sockets.  A buffer is only taken from the
+ * pool once data has actually arrived on a socket, so mostly idle connections do not each pin a receive buffer
+ * of their own.  With the io_uring backend the buffers are registered as a provided buffer ring and the kernel
+ * selects a buffer as it completes the receive, otherwise the socket is polled for readiness and a buffer is
+ * taken from the pool just before the recv.
+ *
+ * Received data is handed out as a buffer_pool::buffer which returns itself to the pool when destroyed, the
+ * pool must outlive every buffer and every pending recv.  A recv that finds every buffer in use waits for one to
+ * be returned to the pool, or for its timeout to expire.
+ * \code
+coro::net::buffer_pool pool{scheduler, coro::net::buffer_pool::options{.buffer_size = 4096, .buffer_count = 1024}};
+...
+auto [rstatus, buffer] = co_await client.async_recv(pool);
+if (rstatus == coro::net::recv_status::ok)
+{
+    handle_request(buffer.data());
+}
+ * \endcode
+ */
+class buffer_pool
+{
+public:
+    /// The most buffers a pool can hold, the limit of entries in an io_uring provided buffer ring.
+    static constexpr std::uint16_t max_buffer_count{32768};
+
+    struct options
+    {
+        /// The size of each receive buffer, a recv receives at most this many bytes.
+        std::size_t buffer_size{4096};
+        /// The number of receive buffers, at most max_buffer_count.  Once they are all in use a recv waits for
+        /// a buffer to be returned to the pool.
+        std::uint16_t buffer_count{1024};
+    };
+
+    /**
+     * Received data held in a buffer of the pool, the buffer returns to the pool when this is destroyed.
+     */
+    class buffer
+    {
+    public:
+        buffer() = default;
+        buffer(const buffer&) = delete;
+        buffer(buffer&& other) noexcept
+            : m_pool(std::exchange(other.m_pool, nullptr)),
+              m_id(other.m_id),
+              m_data(std::exchange(other.m_data, std::span<char>{}))
+        {
+        }
+        auto operator=(const buffer&) -> buffer& = delete;
+        auto operator=(buffer&& other) noexcept -> buffer&
+        {
+            if (std::addressof(other) != this)
+            {
+                release();
+                m_pool = std::exchange(other.m_pool, nullptr);
+                m_id   = other.m_id;
+                m_data = std::exchange(other.m_data, std::span<char>{});
+            }
+            return *this;
+        }
+        ~buffer() { release(); }
+
+        /**
+         * @return The received bytes.
+         */
+        [[nodiscard]] auto data() const noexcept -> std::span<char> { return m_data; }
+
+        /**
+         * @return The number of received bytes.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return m_data.size(); }
+
+        /**
+         * @return True if this holds no received bytes.
+         */
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_data.empty(); }
+
+        /**
+         * Returns the buffer to the pool early, the received bytes must no longer be accessed.
+         */
+        auto release() noexcept -> void
+        {
+            if (m_pool != nullptr)
+            {
+                std::exchange(m_pool, nullptr)->recycle(m_id);
+                m_data = std::span<char>{};
+            }
+        }
+
+    private:
+        friend buffer_pool;
+        buffer(buffer_pool* pool, std::uint16_t id, std::span<char> data) noexcept
+            : m_pool(pool),
+              m_id(id),
+              m_data(data)
+        {
+        }
+
+        buffer_pool*    m_pool{nullptr};
+        std::uint16_t   m_id{0};
+        std::span<char> m_data{};
+    };
+
+    /**
+     * @param scheduler The io scheduler the receives are performed on.
+     * @param opts See buffer_pool::options for more information.
+     * @throw std::runtime_error If the buffer_size or buffer_count is zero or buffer_count exceeds max_buffer_count.
+     */
+    explicit buffer_pool(
+        std::unique_ptr<coro::io_scheduler>& scheduler,
+        options                              opts = options{
+                                         .buffer_size  = 4096,
+                                         .buffer_count = 1024,
+        });
+
+    buffer_pool(const buffer_pool&)                    = delete;
+    buffer_pool(buffer_pool&&)                         = delete;
+    auto operator=(const buffer_pool&) -> buffer_pool& = delete;
+    auto operator=(buffer_pool&&) -> buffer_pool&      = delete;
+
+    ~buffer_pool();
+
+    /**
+     * Receives the data available on the socket into a buffer taken from the pool once it arrives, waiting for a
+     * buffer to be returned to the pool if they are all in use.
+     * @param fd The stream socket to receive from.
+     * @param timeout The amount of time to wait for data to arrive and a buffer to receive it into.  Use zero for
+     *                infinite timeout.
+     * @return The status of the recv and, if it is 'ok', the buffer holding the received bytes.
+     */
+    auto recv(fd_t fd, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<std::pair<recv_status, buffer>>;
+
+    /**
+     * @return The size of each buffer.
+     */
+    [[nodiscard]] auto buffer_size() const noexcept -> std::size_t { return m_opts.buffer_size; }
+
+    /**
+     * @return The number of buffers not holding received data.
+     */
+    [[nodiscard]] auto available() const noexcept -> std::size_t
+    {
+        return m_opts.buffer_count - m_in_use.load(std::memory_order::acquire);
+    }
+
+    /**
+     * @return True if the kernel selects the buffers, false if they are taken from the pool upon readiness.
+     */
+    [[nodiscard]] auto kernel_provided() const noexcept -> bool { return m_buffer_group >= 0; }
+
+private:
+    /**
+     * Parks a recv until a buffer is returned to the pool.  It lives in the waiting coroutine's frame, the
+     * timer callback unlinks it from the waiters under the pool's lock.
+     */
+    class wait_operation
+    {
+    public:
+        /**
+         * @param pool The pool to wait on.
+         * @param recycled The pool's recycle count sampled before the kernel failed to select a buffer, a
+         *                 buffer returned since then ends the wait right away.  Unused when the pool selects
+         *                 the buffers itself.
+         * @param deadline When to stop waiting, only if timed.
+         * @param timed True if the wait ends at the deadline.
+         */
+        wait_operation(buffer_pool& pool, std::uint64_t recycled, time_point deadline, bool timed) noexcept;
+
+        wait_operation(const wait_operation&)                    = delete;
+        wait_operation(wait_operation&&)                         = delete;
+        auto operator=(const wait_operation&) -> wait_operation& = delete;
+        auto operator=(wait_operation&&) -> wait_operation&      = delete;
+
+        auto await_ready() const noexcept -> bool { return false; }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool;
+        /**
+         * @return The buffer handed to this recv when the pool selects the buffers itself, any value when the
+         *         kernel selects them, or empty if the wait timed out.
+         */
+        auto await_resume() const noexcept -> std::optional<std::uint16_t>;
+
+    private:
+        friend buffer_pool;
+
+        enum class state_t : std::uint8_t
+        {
+            /// Not yet linked into the pool's waiters.
+            registering,
+            /// Linked into the pool's waiters.
+            waiting,
+            /// A buffer was returned to the pool for this recv.
+            granted,
+            /// The deadline passed first.
+            timed_out
+        };
+
+        struct timer_entry : public detail::poll_info
+        {
+            explicit timer_entry(wait_operation& operation) : m_operation(operation) {}
+            wait_operation& m_operation;
+        };
+
+        static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>;
+
+        buffer_pool&            m_pool;
+        std::uint64_t           m_recycled;
+        time_point              m_deadline;
+        bool                    m_timed;
+        /// Guarded by the pool's lock.
+        state_t                 m_state{state_t::registering};
+        std::uint16_t           m_id{0};
+        wait_operation*         m_prev{nullptr};
+        wait_operation*         m_next{nullptr};
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        timer_entry             m_timer;
+    };
+
+    /// The scheduler performing the receives.
+    coro::io_scheduler* m_io_scheduler{nullptr};
+    /// The pool's configuration.
+    options m_opts;
+    /// The memory for all the buffers.
+    std::unique_ptr<char[]> m_storage{nullptr};
+    /// The io notifier's buffer group when the kernel selects the buffers, otherwise -1.
+    std::int32_t m_buffer_group{-1};
+    /// The number of buffers holding received data.
+    std::atomic<std::size_t> m_in_use{0};
+
+    /// Guards the free buffers and the waiting recvs.
+    std::mutex m_mutex{};
+    /// The ids of the buffers not holding received data when the pool selects them itself.
+    std::vector<std::uint16_t> m_free{};
+    /// The number of buffers returned to the kernel, only incremented while holding m_mutex.
+    std::atomic<std::uint64_t> m_recycled{0};
+    /// The recvs waiting for a buffer, oldest first.
+    wait_operation* m_waiters_head{nullptr};
+    wait_operation* m_waiters_tail{nullptr};
+
+    auto data(std::uint16_t id) noexcept -> char* { return m_storage.get() + id * m_opts.buffer_size; }
+    auto recycle(std::uint16_t id) noexcept -> void;
+    auto pop_waiter_locked() noexcept -> wait_operation*;
+    auto wake(wait_operation& waiter) noexcept -> void;
+    auto recv_kernel_provided(fd_t fd, std::chrono::milliseconds timeout)
+        -> coro::task<std::pair<recv_status, buffer>>;
+    auto recv_on_readiness(fd_t fd, std::chrono::milliseconds timeout)
+        -> coro::task<std::pair<recv_status, buffer>>;
+};
+
+} // namespace coro::net
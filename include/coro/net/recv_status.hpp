@@ -25,6 +25,8 @@ enum class recv_status : int64_t
     not_connected            = ENOTCONN,
     not_a_socket             = ENOTSOCK,
     connection_reset_by_peer = ECONNRESET,
+    /// The tcp::client::async_recv() did not complete within its timeout.
+    timeout = ETIMEDOUT,
 };
 
 auto to_string(recv_status status) -> const std::string&;
@@ -26,6 +26,8 @@ enum class send_status : int64_t
     not_a_socket             = ENOTSOCK,
     operationg_not_supported = EOPNOTSUPP,
     pipe_closed              = EPIPE,
+    /// The tcp::client::async_send() did not complete within its timeout.
+    timeout = ETIMEDOUT,
 };
 
 } // namespace coro::net
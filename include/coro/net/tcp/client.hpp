@@ -2,6 +2,7 @@
 
 #include "coro/concepts/buffer.hpp"
 #include "coro/io_scheduler.hpp"
+#include "coro/net/buffer_pool.hpp"
 #include "coro/net/connect.hpp"
 #include "coro/net/ip_address.hpp"
 #include "coro/net/recv_status.hpp"
@@ -64,6 +65,15 @@ public:
      */
     auto connect(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<net::connect_status>;
 
+    /**
+     * Connects to the address+port with the given timeout as a single completion based operation, see
+     * io_scheduler::perform().  Once connected calling this function only returns the connected status.
+     * @param timeout How long to wait for the connection to establish? Timeout of zero is indefinite.
+     * @return The result status of trying to connect.
+     */
+    auto async_connect(std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<net::connect_status>;
+
     /**
      * Polls for the given operation on this client's tcp socket.  This should be done prior to
      * calling recv and after a send call that doesn't send the entire buffer.
@@ -73,7 +83,7 @@ public:
      *         event operation is ready.
      */
     auto poll(const coro::poll_op op, const std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>
+        -> coro::io_scheduler::poll_operation
     {
         return m_io_scheduler->poll(m_socket, op, timeout);
     }
@@ -140,6 +150,99 @@ public:
         return {static_cast<send_status>(errno), std::span<element_type>{buffer.data(), buffer.size()}};
     }
 
+    /**
+     * Receives incoming data into the given buffer once it arrives, there is no need to poll() first.  With the
+     * io_uring backend the kernel receives the data with a single submission, otherwise the recv is attempted
+     * and the socket is polled for read only if no data is available yet.
+     * @param buffer Received bytes are written into this buffer up to the buffers size, it must stay alive
+     *               until the returned task completes.
+     * @param timeout The amount of time to wait for data to arrive.  Use zero for infinite timeout.
+     * @return The status of the recv and a span of the bytes received (if any). The span of bytes will be a
+     *         subspan or full span of the given input buffer.
+     */
+    template<concepts::mutable_buffer buffer_type, typename element_type = typename concepts::mutable_buffer_traits<buffer_type>::element_type>
+    auto async_recv(buffer_type& buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<std::pair<recv_status, std::span<element_type>>>
+    {
+        // If the user requested zero bytes, just return.
+        if (buffer.empty())
+        {
+            co_return {recv_status::ok, std::span<element_type>{}};
+        }
+
+        auto result = co_await m_io_scheduler->perform(
+            detail::io_operation{
+                .m_opcode = detail::io_operation::opcode_t::recv,
+                .m_fd     = m_socket.native_handle(),
+                .m_buffer = static_cast<void*>(buffer.data()),
+                .m_length = buffer.size()},
+            timeout);
+        if (result > 0)
+        {
+            co_return {recv_status::ok, std::span<element_type>{buffer.data(), static_cast<size_t>(result)}};
+        }
+
+        if (result == 0)
+        {
+            // On TCP stream sockets 0 indicates the connection has been closed by the peer.
+            co_return {recv_status::closed, std::span<element_type>{}};
+        }
+
+        co_return {static_cast<recv_status>(-result), std::span<element_type>{}};
+    }
+
+    /**
+     * Receives incoming data into a buffer taken from the pool once it arrives, so the client holds no receive
+     * buffer of its own while it is idle.  See net::buffer_pool for how the buffer is selected.
+     * @param pool The pool to take the receive buffer from, it must outlive the returned buffer.
+     * @param timeout The amount of time to wait for data to arrive.  Use zero for infinite timeout.
+     * @return The status of the recv and, if it is 'ok', the buffer holding the received bytes.
+     */
+    auto async_recv(net::buffer_pool& pool, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<std::pair<recv_status, net::buffer_pool::buffer>>
+    {
+        return pool.recv(m_socket.native_handle(), timeout);
+    }
+
+    /**
+     * Sends outgoing data from the given buffer once the socket can accept it, there is no need to poll() first.
+     * With the io_uring backend the kernel sends the data with a single submission, otherwise the send is
+     * attempted and the socket is polled for write only if its send buffer is full.  Like send() a partial
+     * write returns 'ok' with the span of the data that was not sent.
+     * @param buffer The data to write on the tcp socket, it must stay alive until the returned task completes.
+     * @param timeout The amount of time to wait for the data to be sent.  Use zero for infinite timeout.
+     * @return The status of the send and a span of any remaining bytes not sent.  If all bytes were
+     *         successfully sent the status will be 'ok' and the remaining span will be empty.
+     */
+    template<concepts::const_buffer buffer_type, typename element_type = typename concepts::const_buffer_traits<buffer_type>::element_type>
+    auto async_send(const buffer_type& buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<std::pair<send_status, std::span<element_type>>>
+    {
+        // If the user requested zero bytes, just return.
+        if (buffer.empty())
+        {
+            co_return {send_status::ok, std::span<element_type>{buffer.data(), buffer.size()}};
+        }
+
+        auto result = co_await m_io_scheduler->perform(
+            detail::io_operation{
+                .m_opcode = detail::io_operation::opcode_t::send,
+                .m_fd     = m_socket.native_handle(),
+                .m_buffer = const_cast<void*>(static_cast<const void*>(buffer.data())),
+                .m_length = buffer.size()},
+            timeout);
+        if (result >= 0)
+        {
+            // Some or all of the bytes were written.
+            co_return {
+                send_status::ok,
+                std::span<element_type>{buffer.data() + result, buffer.size() - static_cast<size_t>(result)}};
+        }
+
+        // Due to the error none of the bytes were written.
+        co_return {static_cast<send_status>(-result), std::span<element_type>{buffer.data(), buffer.size()}};
+    }
+
 private:
     /// The tcp::server creates already connected clients and provides a tcp socket pre-built.
     friend server;
@@ -49,7 +49,7 @@ public:
      * @return The result of the poll, 'event' means the poll was successful and there is at least 1
      *         connection ready to be accepted.
      */
-    auto poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<coro::poll_status>
+    auto poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::io_scheduler::poll_operation
     {
         return m_io_scheduler->poll(m_accept_socket, coro::poll_op::read, timeout);
     }
@@ -61,6 +61,18 @@ public:
      */
     auto accept() -> coro::net::tcp::client;
 
+    /**
+     * Accepts the next incoming tcp client connection once it arrives, there is no need to poll() first.
+     * With the io_uring backend the kernel accepts the connection with a single submission, otherwise the
+     * accept is attempted and the accept socket is polled only if no connection is pending.  On failure or
+     * timeout the client's socket will be set to an invalid state, use socket.is_valid() to verify the
+     * client was correctly accepted.
+     * @param timeout How long to wait for a new connection before timing out, zero waits indefinitely.
+     * @return The newly connected tcp client connection.
+     */
+    auto async_accept(std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        -> coro::task<coro::net::tcp::client>;
+
     /**
      * @return The tcp accept socket this server is using.
      * @{
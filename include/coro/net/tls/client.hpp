@@ -296,7 +296,7 @@ private:
      *         event operation is ready.
      */
     auto poll(coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>
+        -> coro::io_scheduler::poll_operation
     {
         return m_io_scheduler->poll(m_socket, op, timeout);
     }
@@ -65,9 +65,9 @@ public:
      * @return The result status of the poll operation.
      */
     auto poll(poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<coro::poll_status>
+        -> coro::io_scheduler::poll_operation
     {
-        co_return co_await m_io_scheduler->poll(m_socket, op, timeout);
+        return m_io_scheduler->poll(m_socket, op, timeout);
     }
 
     /**
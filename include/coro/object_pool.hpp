@@ -0,0 +1,570 @@
+#pragma once
+
+#include "coro/concepts/executor.hpp"
+#include "coro/detail/poll_info.hpp"
+#include "coro/detail/task_self_deleting.hpp"
+#include "coro/expected.hpp"
+#include "coro/io_scheduler.hpp"
+#include "coro/task.hpp"
+#include "coro/time.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+enum class object_pool_acquire_result
+{
+    /// @brief An object was acquired from the pool.
+    acquired,
+    /// @brief The pool is shutting down, no object was acquired.
+    shutdown
+};
+
+/**
+ * The object pool hands out reusable objects that are expensive to create, e.g. tcp or tls client
+ * connections.  Objects are created on demand by the user's factory up to `max_size`, once exhausted
+ * acquire() suspends until another task returns an object.  Objects are returned automatically when the
+ * acquired `pooled_object` goes out of scope, waiters are handed the returned object directly in FIFO
+ * order and resumed on the pool's io executor.
+ *
+ * Idle objects are handed out most recently used first, objects that sit idle longer than `idle_timeout`
+ * are destroyed by an io executor timer while keeping at least `min_size` objects alive.  An optional
+ * health check runs on every idle object before it is handed out, objects that fail are destroyed.
+ *
+ * The pool's timer keeps the io executor alive while idle objects above `min_size` are waiting to expire,
+ * shutdown() the pool before shutting down its io executor.
+ */
+template<typename object_type, concepts::io_executor io_executor_type = coro::io_scheduler>
+class object_pool
+{
+public:
+    struct options
+    {
+        /// The number of objects idle eviction will always keep alive, see prefill() to create them eagerly.
+        std::size_t min_size{0};
+        /// The maximum number of objects that can exist at once, including the ones handed out.
+        std::size_t max_size{16};
+        /// Idle objects above min_size are destroyed after being unused for this long, zero disables eviction.
+        std::chrono::milliseconds idle_timeout{std::chrono::seconds{60}};
+        /// Creates a new object, required.
+        std::function<coro::task<object_type>()> factory{nullptr};
+        /// Checks an idle object is still usable before it is handed out, optional.
+        std::function<coro::task<bool>(object_type&)> health_check{nullptr};
+    };
+
+private:
+    struct state;
+
+public:
+    /**
+     * An object acquired from the pool, it is returned to the pool upon destructing.
+     */
+    class pooled_object
+    {
+    public:
+        pooled_object(std::shared_ptr<state> s, object_type&& object)
+            : m_state(std::move(s)),
+              m_object(std::move(object))
+        {
+        }
+
+        pooled_object(const pooled_object&) = delete;
+        pooled_object(pooled_object&& other) noexcept
+            : m_state(std::move(other.m_state)),
+              m_object(std::move(other.m_object)),
+              m_discard(other.m_discard)
+        {
+            other.m_object.reset();
+        }
+        auto operator=(const pooled_object&) -> pooled_object& = delete;
+        auto operator=(pooled_object&& other) noexcept -> pooled_object&
+        {
+            if (std::addressof(other) != this)
+            {
+                release();
+                m_state   = std::move(other.m_state);
+                m_object  = std::move(other.m_object);
+                m_discard = other.m_discard;
+                other.m_object.reset();
+            }
+            return *this;
+        }
+
+        /**
+         * Returns the object to the pool.
+         */
+        ~pooled_object() { release(); }
+
+        auto operator*() -> object_type& { return m_object.value(); }
+        auto operator*() const -> const object_type& { return m_object.value(); }
+        auto operator->() -> object_type* { return std::addressof(m_object.value()); }
+        auto operator->() const -> const object_type* { return std::addressof(m_object.value()); }
+
+        /**
+         * Marks the object as broken, it is destroyed instead of being returned to the pool.
+         */
+        auto discard() noexcept -> void { m_discard = true; }
+
+    private:
+        auto release() -> void
+        {
+            if (m_state != nullptr && m_object.has_value())
+            {
+                if (m_discard)
+                {
+                    m_object.reset();
+                    m_state->discard_slot();
+                }
+                else
+                {
+                    m_state->release(std::move(m_object.value()));
+                    m_object.reset();
+                }
+            }
+            m_state = nullptr;
+        }
+
+        std::shared_ptr<state>     m_state{nullptr};
+        std::optional<object_type> m_object{std::nullopt};
+        bool                       m_discard{false};
+    };
+
+    /**
+     * @param executor The io executor that resumes waiters and drives idle eviction.
+     * @param opts The pool's sizing, eviction and object hooks.
+     * @throw std::runtime_error If the factory is missing or the sizes are invalid.
+     */
+    object_pool(std::unique_ptr<io_executor_type>& executor, options opts)
+        : m_state(std::make_shared<state>(executor, std::move(opts)))
+    {
+    }
+
+    /**
+     * Shuts down the pool, objects that are still handed out are destroyed when they are returned.
+     */
+    ~object_pool() { shutdown(); }
+
+    object_pool(const object_pool&)                    = delete;
+    object_pool(object_pool&&)                         = delete;
+    auto operator=(const object_pool&) -> object_pool& = delete;
+    auto operator=(object_pool&&) -> object_pool&      = delete;
+
+    /**
+     * Acquires an object from the pool.  An idle object is reused if there is one, otherwise a new object is
+     * created if the pool is below max_size, otherwise this suspends until another task returns an object.
+     * Exceptions thrown by the factory or health check are rethrown to the caller.
+     * @return The acquired object or object_pool_acquire_result::shutdown if the pool is shutting down.
+     */
+    [[nodiscard]] auto acquire() -> coro::task<coro::expected<pooled_object, object_pool_acquire_result>>
+    {
+        auto s = m_state;
+        while (true)
+        {
+            typename state::acquire_operation operation{*s};
+            co_await operation;
+
+            switch (operation.m_grant)
+            {
+                case grant_t::shutdown:
+                    co_return coro::unexpected<object_pool_acquire_result>{object_pool_acquire_result::shutdown};
+                case grant_t::create:
+                    co_return pooled_object{s, co_await s->create()};
+                case grant_t::handoff:
+                    co_return pooled_object{s, std::move(operation.m_object.value())};
+                case grant_t::idle:
+                    if (co_await s->check(operation.m_object.value()))
+                    {
+                        co_return pooled_object{s, std::move(operation.m_object.value())};
+                    }
+                    // The idle object failed its health check, try again.
+                    operation.m_object.reset();
+                    s->discard_slot();
+                    break;
+            }
+        }
+    }
+
+    /**
+     * Creates objects until the pool holds at least min_size objects.
+     */
+    [[nodiscard]] auto prefill() -> coro::task<void>
+    {
+        auto s = m_state;
+        while (s->reserve_below_min())
+        {
+            s->release(co_await s->create());
+        }
+        co_return;
+    }
+
+    /**
+     * Stops the pool, waiters resume with object_pool_acquire_result::shutdown and idle objects are destroyed.
+     */
+    auto shutdown() -> void { m_state->shutdown(); }
+
+    /**
+     * @return The number of objects that exist, including the ones handed out.
+     */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        std::scoped_lock lk{m_state->m_mutex};
+        return m_state->m_size;
+    }
+
+    /**
+     * @return The number of objects idle in the pool.
+     */
+    [[nodiscard]] auto idle_size() const -> std::size_t
+    {
+        std::scoped_lock lk{m_state->m_mutex};
+        return m_state->m_idle.size();
+    }
+
+private:
+    enum class grant_t
+    {
+        /// The pool is shutting down.
+        shutdown,
+        /// The waiter reserved a slot and must create the object.
+        create,
+        /// The waiter was handed an object that was just returned.
+        handoff,
+        /// The waiter took an idle object that must be health checked.
+        idle
+    };
+
+    /**
+     * The pool's state is shared with every pooled_object and any pending eviction so that objects can be
+     * returned safely after the pool itself has been destroyed.
+     */
+    struct state : public std::enable_shared_from_this<state>
+    {
+        struct idle_entry
+        {
+            object_type m_object;
+            time_point  m_last_used;
+        };
+
+        struct acquire_operation
+        {
+            explicit acquire_operation(state& s) : m_state(s) {}
+
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool
+            {
+                m_awaiting_coroutine = awaiting_coroutine;
+
+                std::scoped_lock lk{m_state.m_mutex};
+                if (m_state.m_shutdown)
+                {
+                    m_grant = grant_t::shutdown;
+                    return false;
+                }
+
+                if (!m_state.m_idle.empty())
+                {
+                    // Most recently used first so the least used objects can expire.
+                    m_object.emplace(std::move(m_state.m_idle.back().m_object));
+                    m_state.m_idle.pop_back();
+                    m_grant = grant_t::idle;
+                    return false;
+                }
+
+                if (m_state.m_size < m_state.m_opts.max_size)
+                {
+                    ++m_state.m_size;
+                    m_grant = grant_t::create;
+                    return false;
+                }
+
+                // Exhausted, wait in FIFO order for an object to be returned.
+                m_state.m_waiters.emplace_back(this);
+                return true;
+            }
+
+            auto await_resume() const noexcept -> void {}
+
+            state&                     m_state;
+            std::coroutine_handle<>    m_awaiting_coroutine{nullptr};
+            grant_t                    m_grant{grant_t::shutdown};
+            std::optional<object_type> m_object{std::nullopt};
+        };
+
+        /// @brief The timer entry handed to the io executor, it points back at its state.
+        struct timer_entry : public detail::poll_info
+        {
+            explicit timer_entry(state& s) : m_state(s) {}
+            state& m_state;
+        };
+
+        state(std::unique_ptr<io_executor_type>& executor, options opts)
+            : m_executor(executor.get()),
+              m_opts(std::move(opts)),
+              m_timer(*this)
+        {
+            if (m_executor == nullptr)
+            {
+                throw std::runtime_error{"coro::object_pool cannot have a nullptr executor"};
+            }
+            if (m_opts.factory == nullptr)
+            {
+                throw std::runtime_error{"coro::object_pool requires a factory"};
+            }
+            if (m_opts.max_size == 0 || m_opts.min_size > m_opts.max_size)
+            {
+                throw std::runtime_error{"coro::object_pool requires 0 < max_size and min_size <= max_size"};
+            }
+            m_timer.m_on_timeout = &state::on_timeout;
+        }
+
+        auto create() -> coro::task<object_type>
+        {
+            try
+            {
+                co_return co_await m_opts.factory();
+            }
+            catch (...)
+            {
+                discard_slot();
+                throw;
+            }
+        }
+
+        auto check(object_type& object) -> coro::task<bool>
+        {
+            if (m_opts.health_check == nullptr)
+            {
+                co_return true;
+            }
+
+            try
+            {
+                co_return co_await m_opts.health_check(object);
+            }
+            catch (...)
+            {
+                discard_slot();
+                throw;
+            }
+        }
+
+        auto reserve_below_min() -> bool
+        {
+            std::scoped_lock lk{m_mutex};
+            if (m_shutdown || m_size >= m_opts.min_size)
+            {
+                return false;
+            }
+            ++m_size;
+            return true;
+        }
+
+        /**
+         * Returns an object, the longest waiting acquirer is handed it directly otherwise it goes idle.
+         */
+        auto release(object_type&& object) -> void
+        {
+            acquire_operation*        waiter{nullptr};
+            std::optional<time_point> expires{std::nullopt};
+            {
+                std::scoped_lock lk{m_mutex};
+                if (m_shutdown)
+                {
+                    // The caller destroys the object outside of the lock.
+                    --m_size;
+                    return;
+                }
+
+                if (!m_waiters.empty())
+                {
+                    waiter = m_waiters.front();
+                    m_waiters.pop_front();
+                    waiter->m_object.emplace(std::move(object));
+                    waiter->m_grant = grant_t::handoff;
+                }
+                else
+                {
+                    m_idle.emplace_back(idle_entry{std::move(object), clock::now()});
+                    expires = arm_locked();
+                }
+            }
+
+            if (waiter != nullptr)
+            {
+                resume(waiter);
+            }
+            else if (expires.has_value())
+            {
+                arm_timer(expires.value());
+            }
+        }
+
+        /**
+         * Gives up a slot whose object was destroyed, the longest waiting acquirer may now create one.
+         */
+        auto discard_slot() -> void
+        {
+            acquire_operation* waiter{nullptr};
+            {
+                std::scoped_lock lk{m_mutex};
+                if (!m_shutdown && !m_waiters.empty())
+                {
+                    // The slot passes straight to the waiter.
+                    waiter = m_waiters.front();
+                    m_waiters.pop_front();
+                    waiter->m_grant = grant_t::create;
+                }
+                else
+                {
+                    --m_size;
+                }
+            }
+
+            if (waiter != nullptr)
+            {
+                resume(waiter);
+            }
+        }
+
+        auto shutdown() -> void
+        {
+            std::deque<acquire_operation*> waiters{};
+            std::deque<idle_entry>         idle{};
+            bool                           armed{false};
+            {
+                std::scoped_lock lk{m_mutex};
+                if (m_shutdown)
+                {
+                    return;
+                }
+                m_shutdown = true;
+                waiters.swap(m_waiters);
+                idle.swap(m_idle);
+                m_size -= idle.size();
+                armed = m_timer_armed;
+            }
+
+            if (armed)
+            {
+                m_executor->cancel_timer(m_timer);
+            }
+
+            for (auto* waiter : waiters)
+            {
+                waiter->m_grant = grant_t::shutdown;
+                resume(waiter);
+            }
+        }
+
+        auto resume(acquire_operation* waiter) -> void
+        {
+            if (!m_executor->resume(waiter->m_awaiting_coroutine))
+            {
+                waiter->m_awaiting_coroutine.resume();
+            }
+        }
+
+        /**
+         * Marks the eviction timer as armed if there are idle objects that can expire, the caller must call
+         * arm_timer() after releasing the lock.
+         * @return When the least recently used idle object expires, or nullopt if the timer is not needed.
+         */
+        auto arm_locked() -> std::optional<time_point>
+        {
+            if (m_shutdown || m_timer_armed || m_opts.idle_timeout.count() == 0 || m_size <= m_opts.min_size ||
+                m_idle.empty())
+            {
+                return std::nullopt;
+            }
+            m_timer_armed = true;
+            return m_idle.front().m_last_used + m_opts.idle_timeout;
+        }
+
+        auto arm_timer(time_point expires) -> void
+        {
+            m_executor->add_timer(expires, m_timer);
+
+            // A concurrent shutdown could have missed the timer being armed, it must not outlive the pool.
+            std::unique_lock lk{m_mutex};
+            if (m_shutdown)
+            {
+                lk.unlock();
+                m_executor->cancel_timer(m_timer);
+            }
+        }
+
+        /**
+         * @brief Called by the io executor when the eviction timer expires while holding its timer lock.
+         * @return The eviction task to run.
+         */
+        static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+        {
+            auto& self = static_cast<timer_entry&>(pi).m_state;
+            return evict_idle(self.shared_from_this()).handle();
+        }
+
+        /**
+         * Destroys the idle objects that have expired and re-arms the timer for the next one to expire.
+         * @param self Keeps the state alive in case the pool is destroyed while this is pending.
+         */
+        static auto evict_idle(std::shared_ptr<state> self) -> detail::task_self_deleting
+        {
+            std::vector<object_type>  expired{};
+            std::optional<time_point> next{std::nullopt};
+            {
+                std::scoped_lock lk{self->m_mutex};
+                auto             now = clock::now();
+                while (!self->m_idle.empty() && self->m_size > self->m_opts.min_size &&
+                       self->m_idle.front().m_last_used + self->m_opts.idle_timeout <= now)
+                {
+                    expired.emplace_back(std::move(self->m_idle.front().m_object));
+                    self->m_idle.pop_front();
+                    --self->m_size;
+                }
+
+                self->m_timer_armed = false;
+                next                = self->arm_locked();
+            }
+
+            // The expired objects are destroyed outside of the lock when this task completes.
+            if (next.has_value())
+            {
+                self->arm_timer(next.value());
+            }
+            co_return;
+        }
+
+        /// The io executor waiters are resumed on and eviction timers are scheduled on.
+        io_executor_type* m_executor{nullptr};
+        /// The pool's sizing, eviction and object hooks.
+        options m_opts;
+        /// Guards every member below, it is never held while calling into the executor's timers.
+        std::mutex m_mutex{};
+        /// The idle objects ordered from least to most recently returned.
+        std::deque<idle_entry> m_idle{};
+        /// The acquirers waiting for an object to be returned in FIFO order.
+        std::deque<acquire_operation*> m_waiters{};
+        /// The number of objects that exist, are handed out or are being created.
+        std::size_t m_size{0};
+        /// Set once the pool has been shutdown.
+        bool m_shutdown{false};
+        /// Set while the eviction timer is armed or its eviction is pending.
+        bool m_timer_armed{false};
+        /// The eviction timer.
+        timer_entry m_timer;
+    };
+
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace coro
@@ -1,16 +1,27 @@
 #pragma once
 
 #include "coro/concepts/executor.hpp"
+#include "coro/detail/select_claim.hpp"
 #include "coro/expected.hpp"
 #include "coro/mutex.hpp"
 #include "coro/sync_wait.hpp"
 #include "coro/task.hpp"
 
 #include <atomic>
+#include <iterator>
 #include <queue>
+#include <ranges>
+#include <span>
 
 namespace coro
 {
+namespace detail
+{
+template<typename... source_types>
+class selector;
+template<typename source_type>
+struct select_source_traits;
+} // namespace detail
 
 enum class queue_produce_result
 {
@@ -126,10 +137,28 @@ public:
             }
         }
 
+        /**
+         * @brief Resumes the waiter after it has been handed its element or the queue has stopped. A coro::select()
+         *        waiter signals its select instead since its coroutine may still be registering with other sources.
+         */
+        auto resume() -> void
+        {
+            if (m_claim != nullptr)
+            {
+                m_claim->m_ready.set();
+            }
+            else
+            {
+                m_awaiting_coroutine.resume();
+            }
+        }
+
         std::optional<element_type> m_element{std::nullopt};
         queue&                      m_queue;
         std::coroutine_handle<>     m_awaiting_coroutine{nullptr};
         awaiter*                    m_next{nullptr};
+        /// @brief Set when this waiter is registered by coro::select(), it must be claimed before it is resumed.
+        detail::select_claim* m_claim{nullptr};
     };
 
     queue() {}
@@ -183,14 +212,13 @@ public:
         }
 
         // assert(m_element.empty())
-        if (m_waiters != nullptr)
+        if (auto* waiter = pop_waiter_locked(); waiter != nullptr)
         {
-            auto* waiter = std::exchange(m_waiters, m_waiters->m_next);
             lock.unlock();
 
             // Transfer the element directly to the awaiter.
             waiter->m_element = element;
-            waiter->m_awaiting_coroutine.resume();
+            waiter->resume();
         }
         else
         {
@@ -217,14 +245,13 @@ public:
             co_return queue_produce_result::stopped;
         }
 
-        if (m_waiters != nullptr)
+        if (auto* waiter = pop_waiter_locked(); waiter != nullptr)
         {
-            auto* waiter = std::exchange(m_waiters, m_waiters->m_next);
             lock.unlock();
 
             // Transfer the element directly to the awaiter.
             waiter->m_element = std::move(element);
-            waiter->m_awaiting_coroutine.resume();
+            waiter->resume();
         }
         else
         {
@@ -251,13 +278,12 @@ public:
             co_return queue_produce_result::stopped;
         }
 
-        if (m_waiters != nullptr)
+        if (auto* waiter = pop_waiter_locked(); waiter != nullptr)
         {
-            auto* waiter = std::exchange(m_waiters, m_waiters->m_next);
             lock.unlock();
 
             waiter->m_element.emplace(std::forward<args_type>(args)...);
-            waiter->m_awaiting_coroutine.resume();
+            waiter->resume();
         }
         else
         {
@@ -267,6 +293,79 @@ public:
         co_return queue_produce_result::produced;
     }
 
+    /**
+     * @brief Pushes every element of the range into the queue under a single lock acquisition. Waiters
+     *        are handed elements directly in the order they are popped from the waiter list and are only
+     *        resumed once the lock has been released, any remaining elements are appended to the queue.
+     *        If the range is an rvalue its elements are moved into the queue, otherwise they are copied.
+     *
+     * @param elements The elements being produced.
+     * @return coro::task<queue_produce_result>
+     */
+    template<std::ranges::input_range range_type>
+        requires std::constructible_from<element_type, std::ranges::range_reference_t<range_type>>
+    auto push_range(range_type&& elements) -> coro::task<queue_produce_result>
+    {
+        auto lock = co_await m_mutex.scoped_lock();
+
+        if (m_running_state.load(std::memory_order::acquire) != running_state_t::running)
+        {
+            co_return queue_produce_result::stopped;
+        }
+
+        // Hand out elements to the current waiters first, they are detached from the waiter list
+        // while the lock is held but are not resumed until the entire range has been processed.
+        awaiter* to_resume = nullptr;
+        awaiter* tail      = nullptr;
+
+        auto it  = std::ranges::begin(elements);
+        auto end = std::ranges::end(elements);
+        for (; it != end; ++it)
+        {
+            if (auto* waiter = pop_waiter_locked(); waiter != nullptr)
+            {
+                waiter->m_next = nullptr;
+                if constexpr (std::is_lvalue_reference_v<range_type>)
+                {
+                    waiter->m_element.emplace(*it);
+                }
+                else
+                {
+                    waiter->m_element.emplace(std::ranges::iter_move(it));
+                }
+
+                if (tail == nullptr)
+                {
+                    to_resume = waiter;
+                }
+                else
+                {
+                    tail->m_next = waiter;
+                }
+                tail = waiter;
+            }
+            else if constexpr (std::is_lvalue_reference_v<range_type>)
+            {
+                m_elements.emplace(*it);
+            }
+            else
+            {
+                m_elements.emplace(std::ranges::iter_move(it));
+            }
+        }
+
+        lock.unlock();
+
+        while (to_resume != nullptr)
+        {
+            auto* next = to_resume->m_next;
+            to_resume->resume();
+            to_resume = next;
+        }
+
+        co_return queue_produce_result::produced;
+    }
+
     /**
      * @brief Pops the head element of the queue if available, or waits for one to be available.
      *
@@ -279,6 +378,59 @@ public:
         co_return co_await awaiter{*this};
     }
 
+    /**
+     * @brief Pops up to `elements.size()` elements from the queue with a single lock acquisition,
+     *        waiting for at least one element to be available if the queue is currently empty.
+     *
+     * @param elements The output span to move the popped elements into, its size is the maximum batch size.
+     * @return expected<std::size_t, queue_consume_result> The number of elements written to the front of
+     *         `elements`, or queue_consume_result::stopped if the queue has been shutdown.
+     */
+    [[nodiscard]] auto pop_batch(std::span<element_type> elements)
+        -> coro::task<expected<std::size_t, queue_consume_result>>
+    {
+        if (elements.empty())
+        {
+            co_return std::size_t{0};
+        }
+
+        co_await m_mutex.lock();
+
+        if (m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
+        {
+            m_mutex.unlock();
+            co_return unexpected<queue_consume_result>(queue_consume_result::stopped);
+        }
+
+        if (!m_elements.empty())
+        {
+            auto count = pop_batch_locked(elements);
+            m_mutex.unlock();
+            co_return count;
+        }
+
+        // The queue is empty, wait for the next element like a normal pop(), the mutex is unlocked by the awaiter.
+        auto first = co_await awaiter{*this};
+        if (!first)
+        {
+            co_return unexpected<queue_consume_result>(first.error());
+        }
+        elements[0] = std::move(*first);
+
+        // The producer could have pushed more than a single element, grab them if the lock is free.
+        std::size_t count{1};
+        if (elements.size() > 1 && m_mutex.try_lock())
+        {
+            coro::scoped_lock lk{m_mutex};
+            if (m_running_state.load(std::memory_order::acquire) != running_state_t::stopped)
+            {
+                count += pop_batch_locked(elements.subspan(1));
+            }
+        }
+
+        co_return count;
+    }
+
     /**
      * @brief Tries to pop the head element of the queue if available. This can fail if it cannot
      *        acquire the lock via `coro::mutex::try_lock()` or if there are no elements available.
@@ -347,13 +499,18 @@ public:
             co_return;
         }
 
-        auto* waiters = m_waiters;
-        m_waiters = nullptr;
+        // Claim every waiter while the lock is held, select() waiters completed by another source are dropped.
+        awaiter* waiters = nullptr;
+        while (auto* waiter = pop_waiter_locked())
+        {
+            waiter->m_next = waiters;
+            waiters        = waiter;
+        }
         lk.unlock();
         while (waiters != nullptr)
         {
             auto* next = waiters->m_next;
-            waiters->m_awaiting_coroutine.resume();
+            waiters->resume();
             waiters = next;
         }
     }
@@ -395,6 +552,100 @@ public:
 
 private:
     friend awaiter;
+    template<typename... source_types>
+    friend class detail::selector;
+    template<typename source_type>
+    friend struct detail::select_source_traits;
+
+    /**
+     * @brief Pops the next waiter that can be handed an element, the mutex must be held. Waiters registered by
+     *        a coro::select() that has already been completed by another source are discarded.
+     * @return The waiter or nullptr if there are no waiters.
+     */
+    auto pop_waiter_locked() -> awaiter*
+    {
+        while (m_waiters != nullptr)
+        {
+            auto* waiter = std::exchange(m_waiters, m_waiters->m_next);
+            if (waiter->m_claim == nullptr || waiter->m_claim->try_claim(waiter))
+            {
+                return waiter;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Registers a coro::select() waiter, the mutex must be held. If the queue has an element or is stopped
+     *        the waiter is completed immediately instead, provided no other source has claimed its select first.
+     * @return True if the select no longer needs to register with any other source.
+     */
+    auto select_register_locked(awaiter& waiter) -> bool
+    {
+        auto state = m_running_state.load(std::memory_order::acquire);
+        if (state != running_state_t::stopped && m_elements.empty())
+        {
+            waiter.m_next = std::exchange(m_waiters, &waiter);
+            return false;
+        }
+
+        if (waiter.m_claim->try_claim(&waiter))
+        {
+            if (state != running_state_t::stopped)
+            {
+                if constexpr (std::is_move_constructible_v<element_type>)
+                {
+                    waiter.m_element = std::move(m_elements.front());
+                }
+                else
+                {
+                    waiter.m_element = m_elements.front();
+                }
+                m_elements.pop();
+            }
+            waiter.m_claim->m_ready.set();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Removes a coro::select() waiter if it is still registered, the mutex must be held.
+     */
+    auto select_unregister_locked(awaiter& waiter) -> void
+    {
+        for (auto** link = &m_waiters; *link != nullptr; link = &(*link)->m_next)
+        {
+            if (*link == &waiter)
+            {
+                *link = waiter.m_next;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves up to `elements.size()` elements from the front of the queue, the mutex must be held.
+     * @return The number of elements moved into `elements`.
+     */
+    auto pop_batch_locked(std::span<element_type> elements) -> std::size_t
+    {
+        std::size_t count{0};
+        while (count < elements.size() && !m_elements.empty())
+        {
+            if constexpr (std::is_move_assignable_v<element_type>)
+            {
+                elements[count] = std::move(m_elements.front());
+            }
+            else
+            {
+                elements[count] = m_elements.front();
+            }
+            m_elements.pop();
+            ++count;
+        }
+        return count;
+    }
+
     /// @brief The list of pop() awaiters.
     awaiter* m_waiters{nullptr};
     /// @brief Mutex for properly maintaining the queue.
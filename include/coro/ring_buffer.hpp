@@ -1,20 +1,33 @@
 #pragma once
 
 #include "coro/concepts/executor.hpp"
-#include "coro/detail/awaiter_list.hpp"
+#include "coro/detail/select_claim.hpp"
 #include "coro/expected.hpp"
-#include "coro/mutex.hpp"
 #include "coro/sync_wait.hpp"
 #include "coro/task.hpp"
 
 #include <array>
 #include <atomic>
 #include <coroutine>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
 
 namespace coro
 {
+namespace detail
+{
+template<typename... source_types>
+class selector;
+template<typename source_type>
+struct select_source_traits;
+} // namespace detail
+
 namespace ring_buffer_result
 {
 enum class produce
@@ -30,6 +43,13 @@ enum class consume
 } // namespace ring_buffer_result
 
 /**
+ * A bounded multi-producer multi-consumer ring buffer.  Every slot carries a sequence number that tells
+ * producers and consumers whether the slot is ready for them, so while the ring buffer is neither full nor
+ * empty a produce or consume is a single CAS on the front or back index and no lock is taken.  Producers
+ * that find the ring buffer full and consumers that find it empty suspend on a waiter list, the waiter lists
+ * and their locks are only touched on those slow paths.  Waiters are resumed inline on the thread that made
+ * room or produced an element and then retry their operation.
+ *
  * @tparam element The type of element the ring buffer will store.  Note that this type should be
  *         cheap to move if possible as it is moved into and out of the buffer upon produce and
  *         consume operations.
@@ -49,6 +69,102 @@ private:
         stopped,
     };
 
+    /// The assumed cache line size, the producer and consumer indexes are kept on separate lines.
+    static constexpr std::size_t cache_line_size = 64;
+
+    struct slot
+    {
+        /// Equal to 2 * position when the slot can be produced into for that position and 2 * position + 1 once
+        /// it can be consumed, doubling keeps the two states distinct even when the ring buffer has a single slot.
+        std::atomic<std::size_t> m_sequence{0};
+        /// The element stored in this slot.
+        std::optional<element> m_e{std::nullopt};
+    };
+
+    struct wait_operation;
+
+    struct waiter_list
+    {
+        /// Guards m_head, only taken on the full or empty slow paths.
+        std::mutex m_mutex{};
+        /// LIFO list of suspended operations.
+        wait_operation* m_head{nullptr};
+        /// The number of suspended operations, lets the fast paths skip the lock when nobody is waiting.
+        std::atomic<std::size_t> m_count{0};
+    };
+
+    /**
+     * Suspends a producer until the ring buffer has a free slot, or a consumer until it has an element,
+     * or until the ring buffer is shutdown.  The operation must be retried once resumed.
+     */
+    struct wait_operation
+    {
+        wait_operation(ring_buffer<element, num_elements>& rb, waiter_list& list, bool (ring_buffer::*ready)() const)
+            : m_rb(rb),
+              m_list(list),
+              m_ready(ready)
+        {}
+
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+
+            std::scoped_lock lk{m_list.m_mutex};
+            m_next = std::exchange(m_list.m_head, this);
+            m_list.m_count.fetch_add(1, std::memory_order::seq_cst);
+
+            // Pairs with the fence in wake(), either the other side sees this waiter or this sees its update.
+            std::atomic_thread_fence(std::memory_order::seq_cst);
+            if ((m_rb.*m_ready)())
+            {
+                m_list.m_head = m_next;
+                m_list.m_count.fetch_sub(1, std::memory_order::relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        auto await_resume() const noexcept -> void {}
+
+        /// The coroutine to resume once the operation can be retried.
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        /// The next suspended operation.
+        wait_operation* m_next{nullptr};
+        /// Set when this operation is registered by coro::select(), it must be claimed before it is woken.
+        detail::select_claim* m_claim{nullptr};
+        /// The ring buffer this operation is waiting on.
+        ring_buffer<element, num_elements>& m_rb;
+
+    private:
+        waiter_list& m_list;
+        bool (ring_buffer::*m_ready)() const;
+    };
+
+    /**
+     * A consumer registered by coro::select().  Waking it completes the select instead of resuming a coroutine,
+     * the select then consumes the element itself and registers again if another consumer took it first.
+     */
+    struct select_waiter : public wait_operation
+    {
+        explicit select_waiter(ring_buffer<element, num_elements>& rb)
+            : wait_operation(rb, rb.m_consume_waiters, &ring_buffer::can_consume)
+        {}
+
+        [[nodiscard]] auto await_resume() noexcept -> expected<element, ring_buffer_result::consume>
+        {
+            if (m_element.has_value())
+            {
+                return expected<element, ring_buffer_result::consume>(std::move(m_element).value());
+            }
+            return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
+        }
+
+        /// The element consumed once the select has been completed by this ring buffer.
+        std::optional<element> m_element{std::nullopt};
+    };
+
 public:
     /**
      * static_assert If `num_elements` == 0.
@@ -56,6 +172,10 @@ public:
     ring_buffer()
     {
         static_assert(num_elements != 0, "num_elements cannot be zero");
+        for (std::size_t i = 0; i < num_elements; ++i)
+        {
+            m_slots[i].m_sequence.store(i * 2, std::memory_order::relaxed);
+        }
     }
 
     ~ring_buffer()
@@ -70,169 +190,151 @@ public:
     auto operator=(const ring_buffer<element, num_elements>&) noexcept -> ring_buffer<element, num_elements>& = delete;
     auto operator=(ring_buffer<element, num_elements>&&) noexcept -> ring_buffer<element, num_elements>&      = delete;
 
-    struct produce_operation
+    /**
+     * Produces the given element into the ring buffer.  This operation will suspend until a slot
+     * in the ring buffer becomes available.
+     * @param e The element to produce.
+     */
+    [[nodiscard]] auto produce(element e) -> coro::task<ring_buffer_result::produce>
     {
-        produce_operation(ring_buffer<element, num_elements>& rb, element e)
-            : m_rb(rb),
-              m_e(std::move(e))
-        {}
-
-        auto await_ready() noexcept -> bool
+        while (true)
         {
-            auto& mutex = m_rb.m_mutex;
-
-            // Produce operations can only proceed if running.
-            if (m_rb.m_running_state.load(std::memory_order::acquire) != running_state_t::running)
+            if (m_running_state.load(std::memory_order::acquire) != running_state_t::running)
             {
-                mutex.unlock();
-                return true; // Will be awoken with produce::stopped
+                co_return ring_buffer_result::produce::stopped;
             }
 
-            if (m_rb.m_used.load(std::memory_order::acquire) < num_elements)
+            if (try_produce_slot(std::move(e)))
             {
-                // There is guaranteed space to store
-                auto slot = m_rb.m_front.fetch_add(1, std::memory_order::acq_rel) % num_elements;
-                m_rb.m_elements[slot] = std::move(m_e);
-                m_rb.m_used.fetch_add(1, std::memory_order::release);
-                mutex.unlock();
-                return true; // Will be awoken with produce::produced
+                wake(m_consume_waiters, 1);
+                co_return ring_buffer_result::produce::produced;
             }
 
-            return false; // ring buffer full, suspend
-        }
-
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-        {
-            m_awaiting_coroutine = awaiting_coroutine;
-            m_next = m_rb.m_produce_waiters.exchange(this, std::memory_order::acq_rel);
-            m_rb.m_mutex.unlock();
-            return true;
+            co_await wait_operation{*this, m_produce_waiters, &ring_buffer::can_produce};
         }
+    }
 
-        /**
-         * @return produce_result
-         */
-        auto await_resume() -> ring_buffer_result::produce
+    /**
+     * Consumes an element from the ring buffer.  This operation will suspend until an element in
+     * the ring buffer becomes available.
+     */
+    [[nodiscard]] auto consume() -> coro::task<expected<element, ring_buffer_result::consume>>
+    {
+        std::optional<element> e{std::nullopt};
+        while (true)
         {
-            return m_rb.m_running_state.load(std::memory_order::acquire) == running_state_t::running
-                    ? ring_buffer_result::produce::produced
-                    : ring_buffer_result::produce::stopped;
-        }
-
-        /// If the operation needs to suspend, the coroutine to resume when the element can be produced.
-        std::coroutine_handle<> m_awaiting_coroutine;
-        /// Linked list of produce operations that are awaiting to produce their element.
-        produce_operation* m_next{nullptr};
+            if (m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
+            {
+                co_return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
+            }
 
-    private:
-        template<typename element_subtype, size_t num_elements_subtype>
-        friend class ring_buffer;
+            if (try_consume_slot([&](element&& value) { e.emplace(std::move(value)); }))
+            {
+                wake(m_produce_waiters, 1);
+                co_return expected<element, ring_buffer_result::consume>(std::move(e).value());
+            }
 
-        /// The ring buffer the element is being produced into.
-        ring_buffer<element, num_elements>& m_rb;
-        /// The element this produce operation is producing into the ring buffer.
-        std::optional<element> m_e{std::nullopt};
-    };
+            co_await wait_operation{*this, m_consume_waiters, &ring_buffer::can_consume};
+        }
+    }
 
-    struct consume_operation
+    /**
+     * Produces every element of the range into the ring buffer.  The elements are stored without suspending
+     * for as long as there are free slots and the consumers are woken up once per batch, if the ring buffer
+     * becomes full this will suspend until a slot becomes available.  If the range is an rvalue its elements
+     * are moved into the ring buffer, otherwise they are copied.
+     * @param elements The elements to produce.
+     * @return produce::stopped if the ring buffer was shutdown before all of the elements were produced.
+     */
+    template<std::ranges::input_range range_type>
+        requires std::constructible_from<element, std::ranges::range_reference_t<range_type>>
+    [[nodiscard]] auto produce_range(range_type&& elements) -> coro::task<ring_buffer_result::produce>
     {
-        explicit consume_operation(ring_buffer<element, num_elements>& rb)
-            : m_rb(rb)
-        {}
+        auto it  = std::ranges::begin(elements);
+        auto end = std::ranges::end(elements);
 
-        auto await_ready() noexcept -> bool
+        std::size_t produced{0};
+        while (it != end)
         {
-            auto& mutex = m_rb.m_mutex;
+            if (m_running_state.load(std::memory_order::acquire) != running_state_t::running)
+            {
+                wake(m_consume_waiters, produced);
+                co_return ring_buffer_result::produce::stopped;
+            }
 
-            // Consume operations proceed until stopped.
-            if (m_rb.m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
+            bool stored{false};
+            if constexpr (std::is_lvalue_reference_v<range_type>)
             {
-                mutex.unlock();
-                return true;
+                stored = try_produce_slot(*it);
+            }
+            else
+            {
+                stored = try_produce_slot(std::ranges::iter_move(it));
             }
 
-            if (m_rb.m_used.load(std::memory_order::acquire) > 0)
+            if (stored)
             {
-                auto slot = m_rb.m_back.fetch_add(1, std::memory_order::acq_rel) % num_elements;
-                m_e = std::move(m_rb.m_elements[slot]);
-                m_rb.m_elements[slot] = std::nullopt;
-                m_rb.m_used.fetch_sub(1, std::memory_order::release);
-                mutex.unlock();
-                return true;
+                ++produced;
+                ++it;
+                continue;
             }
 
-            return false; // ring buffer is empty, suspend.
+            // The ring buffer is full, the consumers of this batch must be woken up to make room.
+            wake(m_consume_waiters, std::exchange(produced, 0));
+            co_await wait_operation{*this, m_produce_waiters, &ring_buffer::can_produce};
         }
 
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        wake(m_consume_waiters, produced);
+        co_return ring_buffer_result::produce::produced;
+    }
+
+    /**
+     * Consumes up to `elements.size()` elements from the ring buffer, this operation will suspend until
+     * at least one element is available.  The producers are woken up once for the entire batch.
+     * @param elements The output span to move the consumed elements into, its size is the maximum batch size.
+     * @return The number of elements written to the front of `elements` or consume::stopped if the ring
+     *         buffer has been shutdown.
+     */
+    [[nodiscard]] auto consume_batch(std::span<element> elements)
+        -> coro::task<expected<std::size_t, ring_buffer_result::consume>>
+    {
+        if (elements.empty())
         {
-            m_awaiting_coroutine = awaiting_coroutine;
-            m_next = m_rb.m_consume_waiters.exchange(this, std::memory_order::acq_rel);
-            m_rb.m_mutex.unlock();
-            return true;
+            co_return std::size_t{0};
         }
 
-        /**
-         * @return The consumed element or ring_buffer_stopped if the ring buffer has been shutdown.
-         */
-        auto await_resume() -> expected<element, ring_buffer_result::consume>
+        std::size_t count{0};
+        auto        sink = [&](element&& value) { elements[count++] = std::move(value); };
+        while (true)
         {
-            if (m_e.has_value())
+            if (m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
             {
-                return expected<element, ring_buffer_result::consume>(std::move(m_e).value());
+                co_return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
             }
-            else // state is stopped
+
+            if (try_consume_slot(sink))
             {
-                return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
+                break;
             }
-        }
-
-        /// If the operation needs to suspend, the coroutine to resume when the element can be consumed.
-        std::coroutine_handle<> m_awaiting_coroutine;
-        /// Linked list of consume operations that are awaiting to consume an element.
-        consume_operation* m_next{nullptr};
 
-    private:
-        template<typename element_subtype, size_t num_elements_subtype>
-        friend class ring_buffer;
+            co_await wait_operation{*this, m_consume_waiters, &ring_buffer::can_consume};
+        }
 
-        /// The ring buffer to consume an element from.
-        ring_buffer<element, num_elements>& m_rb;
-        /// The element this consume operation will consume.
-        std::optional<element> m_e{std::nullopt};
-    };
+        while (count < elements.size() && try_consume_slot(sink)) {}
 
-    /**
-     * Produces the given element into the ring buffer.  This operation will suspend until a slot
-     * in the ring buffer becomes available.
-     * @param e The element to produce.
-     */
-    [[nodiscard]] auto produce(element e) -> coro::task<ring_buffer_result::produce>
-    {
-        co_await m_mutex.lock();
-        auto result = co_await produce_operation{*this, std::move(e)};
-        co_await try_resume_consumers();
-        co_return result;
+        wake(m_produce_waiters, count);
+        co_return count;
     }
 
     /**
-     * Consumes an element from the ring buffer.  This operation will suspend until an element in
-     * the ring buffer becomes available.
-     */
-    [[nodiscard]] auto consume() -> coro::task<expected<element, ring_buffer_result::consume>>
-    {
-        co_await m_mutex.lock();
-        auto result = co_await consume_operation{*this};
-        co_await try_resume_producers();
-        co_return result;
-    }
-
-    /**
-     * @return The current number of elements contained in the ring buffer.
+     * @return The current number of elements contained in the ring buffer, this includes elements that
+     *         are in the middle of being produced or consumed.
      */
     auto size() const -> size_t
     {
-        return m_used.load(std::memory_order::acquire);
+        auto back  = m_back.load(std::memory_order::acquire);
+        auto front = m_front.load(std::memory_order::acquire);
+        return front > back ? front - back : 0;
     }
 
     /**
@@ -246,63 +348,34 @@ public:
      */
     auto shutdown() -> coro::task<void>
     {
-        // Only wake up waiters once.
+        // Only let one caller do the wake-ups, this can go from running or draining to stopped.
         auto expected = m_running_state.load(std::memory_order::acquire);
-        if (expected == running_state_t::stopped)
+        do
         {
-            co_return;
-        }
-
-        auto lk = co_await m_mutex.scoped_lock();
-        // Only let one caller do the wake-ups, this can go from running or draining to stopped
-        if (!m_running_state.compare_exchange_strong(expected, running_state_t::stopped, std::memory_order::acq_rel, std::memory_order::relaxed))
-        {
-            co_return;
-        }
-        lk.unlock();
-
-        co_await m_mutex.lock();
-        auto* produce_waiters = m_produce_waiters.exchange(nullptr, std::memory_order::acq_rel);
-        auto* consume_waiters = m_consume_waiters.exchange(nullptr, std::memory_order::acq_rel);
-        m_mutex.unlock();
-
-        while (produce_waiters != nullptr)
-        {
-            auto* next = produce_waiters->m_next;
-            produce_waiters->m_awaiting_coroutine.resume();
-            produce_waiters = next;
-        }
-
-        while (consume_waiters != nullptr)
-        {
-            auto* next = consume_waiters->m_next;
-            consume_waiters->m_awaiting_coroutine.resume();
-            consume_waiters = next;
-        }
+            if (expected == running_state_t::stopped)
+            {
+                co_return;
+            }
+        } while (!m_running_state.compare_exchange_weak(
+            expected, running_state_t::stopped, std::memory_order::acq_rel, std::memory_order::acquire));
 
+        wake(m_produce_waiters, num_waiters_all);
+        wake(m_consume_waiters, num_waiters_all);
         co_return;
     }
 
     template<coro::concepts::executor executor_type>
     [[nodiscard]] auto shutdown_drain(std::unique_ptr<executor_type>& e) -> coro::task<void>
     {
-        auto lk = co_await m_mutex.scoped_lock();
         // Do not allow any more produces, the state must be in running to drain.
         auto expected = running_state_t::running;
-        if (!m_running_state.compare_exchange_strong(expected, running_state_t::draining, std::memory_order::acq_rel, std::memory_order::relaxed))
+        if (!m_running_state.compare_exchange_strong(
+                expected, running_state_t::draining, std::memory_order::acq_rel, std::memory_order::relaxed))
         {
             co_return;
         }
 
-        auto* produce_waiters = m_produce_waiters.exchange(nullptr, std::memory_order::acq_rel);
-        lk.unlock();
-
-        while (produce_waiters != nullptr)
-        {
-            auto* next = produce_waiters->m_next;
-            produce_waiters->m_awaiting_coroutine.resume();
-            produce_waiters = next;
-        }
+        wake(m_produce_waiters, num_waiters_all);
 
         while (!empty() && m_running_state.load(std::memory_order::acquire) == running_state_t::draining)
         {
@@ -320,72 +393,217 @@ public:
     [[nodiscard]] auto is_shutdown() const -> bool { return m_running_state.load(std::memory_order::acquire) != running_state_t::running; }
 
 private:
-    friend produce_operation;
-    friend consume_operation;
-
-    coro::mutex m_mutex{};
+    template<typename... source_types>
+    friend class detail::selector;
+    template<typename source_type>
+    friend struct detail::select_source_traits;
 
-    std::array<std::optional<element>, num_elements> m_elements{};
-    /// The current front pointer to an open slot if not full.
-    std::atomic<size_t> m_front{0};
-    /// The current back pointer to the oldest item in the buffer if not empty.
-    std::atomic<size_t> m_back{0};
-    /// The number of items in the ring buffer.
-    std::atomic<size_t> m_used{0};
+    static constexpr std::size_t num_waiters_all = std::numeric_limits<std::size_t>::max();
 
-    /// The LIFO list of produce waiters.
-    std::atomic<produce_operation*> m_produce_waiters{nullptr};
-    /// The LIFO list of consume watier.
-    std::atomic<consume_operation*> m_consume_waiters{nullptr};
-
-    std::atomic<running_state_t> m_running_state{running_state_t::running};
-
-    auto try_resume_producers() -> coro::task<void>
+    /**
+     * Stores the element in the slot at the front if it is free, the element is only moved from on success.
+     * @return True if the element was stored, false if the ring buffer is full.
+     */
+    template<typename element_type>
+    auto try_produce_slot(element_type&& e) -> bool
     {
+        auto pos = m_front.load(std::memory_order::relaxed);
         while (true)
         {
-            auto lk = co_await m_mutex.scoped_lock();
-            if (m_used.load(std::memory_order::acquire) < num_elements)
+            auto& s    = m_slots[pos % num_elements];
+            auto  seq  = s.m_sequence.load(std::memory_order::acquire);
+            auto  diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos * 2);
+            if (diff == 0)
             {
-                auto* op = detail::awaiter_list_pop(m_produce_waiters);
-                if (op != nullptr)
+                if (m_front.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed))
                 {
-                    auto slot = m_front.fetch_add(1, std::memory_order::acq_rel) % num_elements;
-                    m_elements[slot] = std::move(op->m_e);
-                    m_used.fetch_add(1, std::memory_order::release);
-
-                    lk.unlock();
-                    op->m_awaiting_coroutine.resume();
-                    continue;
+                    s.m_e.emplace(std::forward<element_type>(e));
+                    s.m_sequence.store(pos * 2 + 1, std::memory_order::release);
+                    return true;
                 }
             }
-            co_return;
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_front.load(std::memory_order::relaxed);
+            }
         }
     }
 
-    auto try_resume_consumers() -> coro::task<void>
+    /**
+     * Moves the element in the slot at the back into `sink` if it has been produced.
+     * @return True if an element was consumed, false if the ring buffer is empty.
+     */
+    template<typename sink_type>
+    auto try_consume_slot(sink_type&& sink) -> bool
     {
+        auto pos = m_back.load(std::memory_order::relaxed);
         while (true)
         {
-            auto lk = co_await m_mutex.scoped_lock();
-            if (m_used.load(std::memory_order::acquire) > 0)
+            auto& s    = m_slots[pos % num_elements];
+            auto  seq  = s.m_sequence.load(std::memory_order::acquire);
+            auto  diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos * 2 + 1);
+            if (diff == 0)
             {
-                auto* op = detail::awaiter_list_pop(m_consume_waiters);
-                if (op != nullptr)
+                if (m_back.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed))
                 {
-                    auto slot = m_back.fetch_add(1, std::memory_order::acq_rel) % num_elements;
-                    op->m_e = std::move(m_elements[slot]);
-                    m_elements[slot] = std::nullopt;
-                    m_used.fetch_sub(1, std::memory_order::release);
-                    lk.unlock();
+                    sink(std::move(s.m_e).value());
+                    s.m_e = std::nullopt;
+                    s.m_sequence.store((pos + num_elements) * 2, std::memory_order::release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_back.load(std::memory_order::relaxed);
+            }
+        }
+    }
 
-                    op->m_awaiting_coroutine.resume();
+    /// @return True if a suspending producer should retry instead.
+    auto can_produce() const -> bool
+    {
+        if (m_running_state.load(std::memory_order::acquire) != running_state_t::running)
+        {
+            return true;
+        }
+        auto pos = m_front.load(std::memory_order::relaxed);
+        auto seq = m_slots[pos % num_elements].m_sequence.load(std::memory_order::acquire);
+        return static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos * 2) >= 0;
+    }
+
+    /// @return True if a suspending consumer should retry instead.
+    auto can_consume() const -> bool
+    {
+        if (m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
+        {
+            return true;
+        }
+        auto pos = m_back.load(std::memory_order::relaxed);
+        auto seq = m_slots[pos % num_elements].m_sequence.load(std::memory_order::acquire);
+        return static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos * 2 + 1) >= 0;
+    }
+
+    /**
+     * Registers a coro::select() consumer.  If an element is available or the ring buffer is stopped the select
+     * is completed immediately instead, provided no other source has claimed it first.
+     * @return True if the select no longer needs to register with any other source.
+     */
+    auto select_register(select_waiter& waiter) -> bool
+    {
+        // The select's coroutine is never resumed through the waiter, only its claim is used.
+        if (waiter.await_suspend(nullptr))
+        {
+            return false;
+        }
+
+        if (waiter.m_claim->try_claim(&waiter))
+        {
+            waiter.m_claim->m_ready.set();
+        }
+        return true;
+    }
+
+    /**
+     * Removes a coro::select() consumer if it is still registered.
+     */
+    auto select_unregister(select_waiter& waiter) -> void
+    {
+        std::scoped_lock lk{m_consume_waiters.m_mutex};
+        for (auto** link = &m_consume_waiters.m_head; *link != nullptr; link = &(*link)->m_next)
+        {
+            if (*link == &waiter)
+            {
+                *link = waiter.m_next;
+                m_consume_waiters.m_count.fetch_sub(1, std::memory_order::relaxed);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Consumes the element for a coro::select() consumer that has completed its select.
+     * @return False if another consumer took the element first and the select must register again.
+     */
+    auto select_take(select_waiter& waiter) -> bool
+    {
+        if (m_running_state.load(std::memory_order::acquire) == running_state_t::stopped)
+        {
+            return true;
+        }
+
+        if (try_consume_slot([&](element&& value) { waiter.m_element.emplace(std::move(value)); }))
+        {
+            wake(m_produce_waiters, 1);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Resumes up to `count` suspended operations from the list so they can retry.  coro::select() consumers
+     * whose select was already completed by another source are dropped without using up a wake-up.
+     */
+    auto wake(waiter_list& list, std::size_t count) -> void
+    {
+        // Pairs with the fence in wait_operation::await_suspend().
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (count == 0 || list.m_count.load(std::memory_order::relaxed) == 0)
+        {
+            return;
+        }
+
+        wait_operation* to_resume{nullptr};
+        {
+            std::scoped_lock lk{list.m_mutex};
+            while (count > 0 && list.m_head != nullptr)
+            {
+                auto* op = std::exchange(list.m_head, list.m_head->m_next);
+                list.m_count.fetch_sub(1, std::memory_order::relaxed);
+                if (op->m_claim != nullptr && !op->m_claim->try_claim(op))
+                {
                     continue;
                 }
+                op->m_next = std::exchange(to_resume, op);
+                --count;
             }
-            co_return;
+        }
+
+        while (to_resume != nullptr)
+        {
+            auto* next = to_resume->m_next;
+            if (to_resume->m_claim != nullptr)
+            {
+                to_resume->m_claim->m_ready.set();
+            }
+            else
+            {
+                to_resume->m_awaiting_coroutine.resume();
+            }
+            to_resume = next;
         }
     }
+
+    /// The position of the next slot to produce into.
+    alignas(cache_line_size) std::atomic<std::size_t> m_front{0};
+    /// The position of the next slot to consume from.
+    alignas(cache_line_size) std::atomic<std::size_t> m_back{0};
+
+    alignas(cache_line_size) std::atomic<running_state_t> m_running_state{running_state_t::running};
+    /// The producers waiting for a free slot.
+    waiter_list m_produce_waiters{};
+    /// The consumers waiting for an element.
+    waiter_list m_consume_waiters{};
+
+    /// The element slots.
+    std::array<slot, num_elements> m_slots{};
 };
 
 } // namespace coro
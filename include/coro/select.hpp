@@ -0,0 +1,227 @@
+#pragma once
+
+#include "coro/detail/select_claim.hpp"
+#include "coro/expected.hpp"
+#include "coro/mutex.hpp"
+#include "coro/queue.hpp"
+#include "coro/ring_buffer.hpp"
+#include "coro/task.hpp"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace coro
+{
+namespace detail
+{
+/// Type erased view of a single source so the sources can be walked with a plain loop.
+struct select_source
+{
+    /// The lock the source's register and unregister functions must be called with, nullptr if they lock themselves.
+    coro::mutex* m_mutex;
+    void*        m_waiter;
+    /// @return True if the select no longer needs to register with any other source.
+    bool (*m_register)(void* waiter);
+    void (*m_unregister)(void* waiter);
+    /// Called once the waiter has won the select, @return False if it has no result and the select must start over.
+    bool (*m_take)(void* waiter);
+};
+
+template<typename source_type>
+struct select_source_traits;
+
+template<typename element_type>
+struct select_source_traits<coro::queue<element_type>>
+{
+    using waiter_type = typename coro::queue<element_type>::awaiter;
+    using result_type = expected<element_type, queue_consume_result>;
+
+    static auto make_source(waiter_type& waiter) -> select_source
+    {
+        return select_source{
+            .m_mutex  = &waiter.m_queue.m_mutex,
+            .m_waiter = &waiter,
+            .m_register =
+                [](void* w) -> bool
+            {
+                auto& a = *static_cast<waiter_type*>(w);
+                return a.m_queue.select_register_locked(a);
+            },
+            .m_unregister =
+                [](void* w) -> void
+            {
+                auto& a = *static_cast<waiter_type*>(w);
+                a.m_queue.select_unregister_locked(a);
+            },
+            // The queue hands the element to the waiter before completing the select.
+            .m_take = [](void*) -> bool { return true; }};
+    }
+};
+
+template<typename element_type, std::size_t num_elements>
+struct select_source_traits<coro::ring_buffer<element_type, num_elements>>
+{
+    using waiter_type = typename coro::ring_buffer<element_type, num_elements>::select_waiter;
+    using result_type = expected<element_type, ring_buffer_result::consume>;
+
+    static auto make_source(waiter_type& waiter) -> select_source
+    {
+        return select_source{
+            .m_mutex  = nullptr,
+            .m_waiter = &waiter,
+            .m_register =
+                [](void* w) -> bool
+            {
+                auto& a = *static_cast<waiter_type*>(w);
+                return a.m_rb.select_register(a);
+            },
+            .m_unregister =
+                [](void* w) -> void
+            {
+                auto& a = *static_cast<waiter_type*>(w);
+                a.m_rb.select_unregister(a);
+            },
+            .m_take =
+                [](void* w) -> bool
+            {
+                auto& a = *static_cast<waiter_type*>(w);
+                return a.m_rb.select_take(a);
+            }};
+    }
+};
+
+template<typename... source_types>
+class selector
+{
+public:
+    using result_type = std::variant<typename select_source_traits<source_types>::result_type...>;
+
+    static auto make(source_types&... sources) -> coro::task<result_type>
+    {
+        return run(std::index_sequence_for<source_types...>{}, sources...);
+    }
+
+private:
+    using waiters_type = std::tuple<typename select_source_traits<source_types>::waiter_type...>;
+
+    template<std::size_t... indexes>
+    static auto run(std::index_sequence<indexes...>, source_types&... srcs) -> coro::task<result_type>
+    {
+        select_claim claim{};
+        waiters_type waiters{typename select_source_traits<source_types>::waiter_type{srcs}...};
+        ((std::get<indexes>(waiters).m_claim = &claim), ...);
+
+        std::array<select_source, sizeof...(source_types)> sources{
+            select_source_traits<source_types>::make_source(std::get<indexes>(waiters))...};
+
+        const void* winner{nullptr};
+        while (true)
+        {
+            // Register with each source in order, stopping as soon as any source completes the select.
+            std::size_t registered{0};
+            for (auto& s : sources)
+            {
+                if (claim.m_winner.load(std::memory_order::acquire) != nullptr)
+                {
+                    break;
+                }
+
+                bool done{false};
+                if (s.m_mutex != nullptr)
+                {
+                    co_await s.m_mutex->lock();
+                    done = s.m_register(s.m_waiter);
+                    s.m_mutex->unlock();
+                }
+                else
+                {
+                    done = s.m_register(s.m_waiter);
+                }
+
+                if (done)
+                {
+                    break;
+                }
+                ++registered;
+            }
+
+            co_await claim.m_ready;
+
+            // The winning source has already removed its waiter, every other registered waiter must be removed
+            // before this frame is destroyed or the select starts over.
+            winner = claim.m_winner.load(std::memory_order::acquire);
+            for (std::size_t i = 0; i < registered; ++i)
+            {
+                auto& s = sources[i];
+                if (s.m_waiter == winner)
+                {
+                    continue;
+                }
+
+                if (s.m_mutex != nullptr)
+                {
+                    co_await s.m_mutex->lock();
+                    s.m_unregister(s.m_waiter);
+                    s.m_mutex->unlock();
+                }
+                else
+                {
+                    s.m_unregister(s.m_waiter);
+                }
+            }
+
+            bool taken{false};
+            for (auto& s : sources)
+            {
+                if (s.m_waiter == winner)
+                {
+                    taken = s.m_take(s.m_waiter);
+                    break;
+                }
+            }
+
+            if (taken)
+            {
+                break;
+            }
+
+            // A ring buffer woke the select but another consumer took its element, nothing is registered anymore.
+            claim.m_winner.store(nullptr, std::memory_order::release);
+            claim.m_ready.reset();
+        }
+
+        std::optional<result_type> result{std::nullopt};
+        ((winner == &std::get<indexes>(waiters)
+              ? (void)result.emplace(std::in_place_index<indexes>, std::get<indexes>(waiters).await_resume())
+              : (void)0),
+         ...);
+        co_return std::move(result).value();
+    }
+};
+
+} // namespace detail
+
+/**
+ * Waits for the first of the given queues or ring buffers to yield an element.  A single waiter is registered
+ * with each source, the first source to complete its waiter (or that is shutdown) completes the select and the
+ * waiters registered with every other source are removed without consuming anything from them.  A ring buffer
+ * only wakes the select, the select consumes the element itself and waits again if another consumer of that
+ * ring buffer took it first.
+ *
+ * @param sources The coro::queue and coro::ring_buffer sources to wait on, the same type may appear multiple times.
+ * @return A variant whose active index identifies the source that completed the select, holding either the
+ *         element consumed from that source or its stopped result if that source has been shutdown.
+ */
+template<typename... source_types>
+    requires(sizeof...(source_types) > 0)
+[[nodiscard]] auto select(source_types&... sources)
+    -> coro::task<std::variant<typename detail::select_source_traits<source_types>::result_type...>>
+{
+    return detail::selector<source_types...>::make(sources...);
+}
+
+} // namespace coro
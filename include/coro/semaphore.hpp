@@ -1,15 +1,22 @@
 #pragma once
 
-#include "coro/detail/awaiter_list.hpp"
+#include "coro/concepts/executor.hpp"
 #include "coro/expected.hpp"
 #include "coro/export.hpp"
 #include "coro/mutex.hpp"
 #include "coro/sync_wait.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <coroutine>
+#include <stdexcept>
 #include <string>
 
+#ifdef LIBCORO_FEATURE_NETWORKING
+    #include "coro/detail/poll_info.hpp"
+#endif
+
 namespace coro
 {
 
@@ -18,11 +25,14 @@ enum class semaphore_acquire_result
     /// @brief The semaphore was acquired.
     acquired,
     /// @brief The semaphore is shutting down, it has not been acquired.
-    shutdown
+    shutdown,
+    /// @brief The timeout expired before the semaphore could be acquired.
+    timeout
 };
 
 extern CORO_EXPORT std::string semaphore_acquire_result_acquired;
 extern CORO_EXPORT std::string semaphore_acquire_result_shutdown;
+extern CORO_EXPORT std::string semaphore_acquire_result_timeout;
 extern CORO_EXPORT std::string semaphore_acquire_result_unknown;
 
 auto to_string(semaphore_acquire_result result) -> const std::string&;
@@ -37,12 +47,26 @@ template<std::ptrdiff_t max_value>
 class acquire_operation
 {
 public:
-    explicit acquire_operation(semaphore<max_value>& s) : m_semaphore(s) { }
+    acquire_operation(semaphore<max_value>& s, std::ptrdiff_t count) : m_semaphore(s), m_count(count) { }
+    ~acquire_operation() = default;
+
+    acquire_operation(const acquire_operation&)                    = delete;
+    acquire_operation(acquire_operation&&)                         = delete;
+    auto operator=(const acquire_operation&) -> acquire_operation& = delete;
+    auto operator=(acquire_operation&&) -> acquire_operation&      = delete;
 
-    [[nodiscard]] auto await_ready() const noexcept -> bool
+    [[nodiscard]] auto await_ready() noexcept -> bool
     {
-        // If the semaphore is shutdown or a resources can be acquired without suspending release the lock and resume execution.
-        if (m_semaphore.m_shutdown.load(std::memory_order::acquire) || m_semaphore.try_acquire())
+        // Only acquire without suspending when nobody is queued ahead of this operation, otherwise
+        // a steady stream of small acquires could starve a large acquire forever.
+        if (m_semaphore.m_shutdown.load(std::memory_order::acquire))
+        {
+            m_result = semaphore_acquire_result::shutdown;
+            m_semaphore.m_mutex.unlock();
+            return true;
+        }
+
+        if (m_semaphore.m_waiters_head == nullptr && m_semaphore.try_take(m_count))
         {
             m_semaphore.m_mutex.unlock();
             return true;
@@ -51,34 +75,171 @@ public:
         return false;
     }
 
-    auto await_suspend(const std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+    auto await_suspend(const std::coroutine_handle<> awaiting_coroutine) noexcept -> void
     {
-        // Check again now that we've set up the coroutine frame, the state could have changed.
-        if (await_ready())
+        // The semaphore's mutex is still held, queue at the back so waiters are granted in FIFO order.
+        m_awaiting_coroutine = awaiting_coroutine;
+        m_semaphore.push_waiter(this);
+        m_semaphore.m_mutex.unlock();
+    }
+
+    [[nodiscard]] auto await_resume() const noexcept -> semaphore_acquire_result { return m_result; }
+
+    /**
+     * Called with the semaphore's mutex held before this waiter is granted its resources or woken by shutdown.
+     * @return False if the waiter has already timed out and must be skipped.
+     */
+    auto try_claim() noexcept -> bool { return m_on_claim == nullptr || m_on_claim(*this); }
+
+    /// @brief Only set by timed waiters, claims the waiter from its timer.  Plain waiters can always be claimed.
+    auto (*m_on_claim)(acquire_operation&) noexcept -> bool {nullptr};
+    acquire_operation<max_value>* m_next{nullptr};
+    acquire_operation<max_value>* m_prev{nullptr};
+    /// @brief True while this waiter is linked in the semaphore's queue, guarded by the semaphore's mutex.
+    bool m_queued{false};
+    semaphore<max_value>&         m_semaphore;
+    /// @brief The number of resources this operation is acquiring.
+    std::ptrdiff_t m_count;
+    /// @brief Set by the releaser or shutdown before resuming this operation.
+    semaphore_acquire_result m_result{semaphore_acquire_result::acquired};
+    std::coroutine_handle<>  m_awaiting_coroutine;
+};
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+/**
+ * An acquire that gives up after a timeout, the awaiter's timer entry is registered with the io executor so
+ * waiting does not require any additional coroutine frames.  On timeout the timer callback unlinks the waiter
+ * from the queue under the semaphore's mutex, inline if the mutex is free, otherwise through a
+ * detail::locked_callback that is run by whoever hands it the mutex.
+ */
+template<std::ptrdiff_t max_value, concepts::io_executor io_executor_type>
+class timed_acquire_operation : public acquire_operation<max_value>
+{
+public:
+    enum class state_t : uint8_t
+    {
+        waiting,
+        acquired,
+        timed_out
+    };
+
+    /// @brief The timer entry handed to the io executor, it points back at its awaiter.
+    struct timer_entry : public detail::poll_info
+    {
+        explicit timer_entry(timed_acquire_operation& operation) : m_operation(operation) {}
+        timed_acquire_operation& m_operation;
+    };
+
+    /// @brief Unlinks the timed out awaiter while holding the semaphore's mutex.
+    struct unlink_entry : public detail::locked_callback
+    {
+        explicit unlink_entry(timed_acquire_operation& operation)
+            : detail::locked_callback(operation.m_semaphore.m_mutex, &timed_acquire_operation::on_unlink),
+              m_operation(operation)
         {
-            return false;
         }
+        timed_acquire_operation& m_operation;
+    };
+
+    timed_acquire_operation(
+        semaphore<max_value>&              s,
+        std::ptrdiff_t                     count,
+        std::unique_ptr<io_executor_type>& executor,
+        std::chrono::nanoseconds           timeout)
+        : acquire_operation<max_value>(s, count),
+          m_executor(executor),
+          m_timeout(timeout),
+          m_timer(*this),
+          m_unlink(*this)
+    {
+        this->m_on_claim = &timed_acquire_operation::on_claim;
+    }
 
-        m_awaiting_coroutine = awaiting_coroutine;
-        detail::awaiter_list_push(m_semaphore.m_acquire_waiters, this);
-        m_semaphore.m_mutex.unlock();
-        return true;
+    auto await_suspend(const std::coroutine_handle<> awaiting_coroutine) noexcept -> void
+    {
+        // The semaphore's mutex is still held so the timer is armed before anyone can grant this waiter.
+        this->m_awaiting_coroutine = awaiting_coroutine;
+        m_timer.m_on_timeout       = &timed_acquire_operation::on_timeout;
+        this->m_semaphore.push_waiter(this);
+        m_executor->add_timer(clock::now() + m_timeout, m_timer);
+        this->m_semaphore.m_mutex.unlock();
     }
 
-    [[nodiscard]] auto await_resume() const -> semaphore_acquire_result
+    [[nodiscard]] auto await_resume() noexcept -> semaphore_acquire_result
     {
-        if (m_semaphore.m_shutdown.load(std::memory_order::acquire))
+        if (m_state.load(std::memory_order::acquire) == state_t::acquired)
         {
-            return semaphore_acquire_result::shutdown;
+            // The waiter was granted or woken by shutdown first, if the timer is concurrently firing this waits for
+            // its callback to back off.
+            m_executor->cancel_timer(m_timer);
         }
-        return semaphore_acquire_result::acquired;
+        return this->m_result;
     }
 
-    acquire_operation<max_value>* m_next{nullptr};
-    semaphore<max_value>&         m_semaphore;
-    std::coroutine_handle<>       m_awaiting_coroutine;
+    /**
+     * Claims the waiter from its timer, this only flips the state so it can be called from a timer callback.
+     */
+    static auto on_claim(acquire_operation<max_value>& operation) noexcept -> bool
+    {
+        auto& self     = static_cast<timed_acquire_operation&>(operation);
+        auto  expected = state_t::waiting;
+        return self.m_state.compare_exchange_strong(
+            expected, state_t::acquired, std::memory_order::acq_rel, std::memory_order::acquire);
+    }
+
+    /**
+     * @brief Called by the io executor when the timer expires while holding its timer lock.
+     * @return The awaiting coroutine if the waiter was unlinked inline, or nullptr if it was granted first or
+     *         will be unlinked and resumed by the current holder of the semaphore's mutex.
+     */
+    static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+    {
+        auto& self     = static_cast<timer_entry&>(pi).m_operation;
+        auto  expected = state_t::waiting;
+        if (!self.m_state.compare_exchange_strong(
+                expected, state_t::timed_out, std::memory_order::acq_rel, std::memory_order::acquire))
+        {
+            return nullptr;
+        }
+
+        self.m_result = semaphore_acquire_result::timeout;
+        auto handle   = self.m_awaiting_coroutine;
+        if (self.m_unlink.run(self.m_executor))
+        {
+            return handle;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Unlinks the timed out waiter while holding the semaphore's mutex.  Nothing is resumed inline, this runs within
+     * the timer callback or the unlock of whoever handed it the mutex.
+     */
+    static auto on_unlink(detail::locked_callback& callback, bool ran_inline) noexcept -> void
+    {
+        auto& self     = static_cast<unlink_entry&>(callback).m_operation;
+        auto& executor = self.m_executor;
+        auto  handle   = self.m_awaiting_coroutine;
+        semaphore<max_value>::resume_waiters(executor, self.m_semaphore.remove_timed_out_waiter_locked(self));
+
+        // Inline the timer callback hands the awaiting coroutine back to the io executor itself.
+        if (!ran_inline && !executor->resume(handle))
+        {
+            handle.resume();
+        }
+    }
+
+private:
+    std::unique_ptr<io_executor_type>& m_executor;
+    std::chrono::nanoseconds           m_timeout;
+    std::atomic<state_t>               m_state{state_t::waiting};
+    timer_entry                        m_timer;
+    unlink_entry                       m_unlink;
 };
 
+#endif
+
 } // namespace detail
 
 template<std::ptrdiff_t max_value>
@@ -98,60 +259,97 @@ public:
     auto operator=(semaphore&&) noexcept -> semaphore&      = delete;
 
     /**
-     * @brief Acquires a resource from the semaphore, if the semaphore has no resources available then
-     * this will suspend and wait until a resource becomes available.
+     * @brief Acquires `count` resources from the semaphore, if the semaphore does not have enough resources
+     * available then this will suspend and wait until they become available.  Waiters are granted their
+     * resources in FIFO order so a large acquire is never starved by smaller acquires arriving after it.
+     * @param count The number of resources to acquire, must be in the range [0, max()].
+     * @throw std::invalid_argument If count is negative or larger than max().
      */
-    [[nodiscard]] auto acquire() -> coro::task<semaphore_acquire_result>
+    [[nodiscard]] auto acquire(std::ptrdiff_t count = 1) -> coro::task<semaphore_acquire_result>
     {
+        if (count < 0 || count > max())
+        {
+            throw std::invalid_argument{"coro::semaphore::acquire count must be in the range [0, max()]"};
+        }
+
         co_await m_mutex.lock();
-        co_return co_await detail::acquire_operation<max_value>{*this};
+        co_return co_await detail::acquire_operation<max_value>{*this, count};
     }
 
+#ifdef LIBCORO_FEATURE_NETWORKING
     /**
-     * @brief Releases a resources back to the semaphore, if the semaphore is already at value() == max() this does nothing.
-     * @return
+     * @brief Acquires `count` resources from the semaphore like acquire() but gives up if they have not been
+     * acquired before the timeout expires.  A waiter that times out is removed from the queue, this allows
+     * shedding load instead of queueing forever.
+     * @param executor The io executor that drives the timeout.
+     * @param timeout How long to wait for the resources.
+     * @param count The number of resources to acquire, must be in the range [0, max()].
+     * @throw std::invalid_argument If count is negative or larger than max().
+     * @return semaphore_acquire_result::timeout if the resources were not acquired in time.
      */
-    [[nodiscard]] auto release() -> coro::task<void>
+    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    [[nodiscard]] auto try_acquire_for(
+        std::unique_ptr<io_executor_type>&                 executor,
+        const std::chrono::duration<rep_type, period_type> timeout,
+        std::ptrdiff_t                                     count = 1) -> coro::task<semaphore_acquire_result>
     {
-        co_await m_mutex.lock();
-        // Do not resume or increment resources past the max_value.
-        if (value() == max())
+        if (count < 0 || count > max())
         {
-            m_mutex.unlock();
-            co_return;
+            throw std::invalid_argument{"coro::semaphore::try_acquire_for count must be in the range [0, max()]"};
         }
 
-        // If there are any waiters just transfer resource ownership to the waiter.
-        auto* waiter = detail::awaiter_list_pop(m_acquire_waiters);
-        if (waiter != nullptr)
-        {
-            m_mutex.unlock();
-            waiter->m_awaiting_coroutine.resume();
-        }
-        else
+        co_await m_mutex.lock();
+        co_return co_await detail::timed_acquire_operation<max_value, io_executor_type>{
+            *this, count, executor, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)};
+    }
+#endif
+
+    /**
+     * @brief Releases `count` resources back to the semaphore, the semaphore's value will never exceed max().
+     * Any waiters at the front of the queue whose acquire can now be satisfied are resumed.
+     * @param count The number of resources to release, must be in the range [1, max()].
+     * @throw std::invalid_argument If count is not positive or is larger than max().
+     */
+    [[nodiscard]] auto release(std::ptrdiff_t count = 1) -> coro::task<void>
+    {
+        if (count <= 0 || count > max())
         {
-            // Release the resource.
-            m_counter.fetch_add(1, std::memory_order::release);
-            m_mutex.unlock();
+            throw std::invalid_argument{"coro::semaphore::release count must be in the range [1, max()]"};
         }
+
+        co_await m_mutex.lock();
+
+        // Do not increment resources past the max_value.
+        auto expected = m_counter.load(std::memory_order::acquire);
+        while (!m_counter.compare_exchange_weak(
+            expected, std::min(expected + count, max()), std::memory_order::acq_rel, std::memory_order::acquire))
+        { }
+
+        auto* granted = grant_waiters_locked();
+        m_mutex.unlock();
+        resume_waiters(granted);
     }
 
     /**
-     * @brief Attempts to acquire a resource if there are any resources available.
-     * @return True if the acquire operation was able to acquire a resource.
+     * @brief Attempts to acquire `count` resources if they are available.  This will fail while other
+     * acquire operations are waiting so it cannot take resources ahead of them.
+     * @param count The number of resources to acquire, must be in the range [0, max()].
+     * @throw std::invalid_argument If count is negative or larger than max().
+     * @return True if the acquire operation was able to acquire the resources.
      */
-    auto try_acquire() -> bool
+    auto try_acquire(std::ptrdiff_t count = 1) -> bool
     {
-        auto expected = m_counter.load(std::memory_order::acquire);
-        do
+        if (count < 0 || count > max())
         {
-            if (expected <= 0)
-            {
-                return false;
-            }
-        } while (!m_counter.compare_exchange_weak(expected, expected - 1, std::memory_order::acq_rel, std::memory_order::acquire));
+            throw std::invalid_argument{"coro::semaphore::try_acquire count must be in the range [0, max()]"};
+        }
 
-        return true;
+        if (m_waiter_count.load(std::memory_order::acquire) > 0)
+        {
+            return false;
+        }
+
+        return try_take(count);
     }
 
     /**
@@ -179,14 +377,21 @@ public:
         bool expected{false};
         if (m_shutdown.compare_exchange_strong(expected, true, std::memory_order::release, std::memory_order::relaxed))
         {
-            auto* waiter = detail::awaiter_list_pop_all(m_acquire_waiters);
-            lock.unlock();
-            while (waiter != nullptr)
+            detail::acquire_operation<max_value>* woken{nullptr};
+            detail::acquire_operation<max_value>* woken_tail{nullptr};
+            while (m_waiters_head != nullptr)
             {
-                auto* next = waiter->m_next;
-                waiter->m_awaiting_coroutine.resume();
-                waiter = next;
+                auto* waiter = m_waiters_head;
+                remove_waiter(waiter);
+                // Timed out waiters are unlinked and resumed by their own timer.
+                if (waiter->try_claim())
+                {
+                    waiter->m_result = semaphore_acquire_result::shutdown;
+                    append_waiter(woken, woken_tail, waiter);
+                }
             }
+            lock.unlock();
+            resume_waiters(woken);
         }
     }
 
@@ -197,11 +402,168 @@ public:
 
 private:
     friend class detail::acquire_operation<max_value>;
+#ifdef LIBCORO_FEATURE_NETWORKING
+    template<std::ptrdiff_t, concepts::io_executor>
+    friend class detail::timed_acquire_operation;
+#endif
+
+    /**
+     * Atomically takes `count` resources if that many are available.
+     */
+    auto try_take(std::ptrdiff_t count) -> bool
+    {
+        auto expected = m_counter.load(std::memory_order::acquire);
+        do
+        {
+            if (expected < count)
+            {
+                return false;
+            }
+        } while (!m_counter.compare_exchange_weak(expected, expected - count, std::memory_order::acq_rel, std::memory_order::acquire));
+
+        return true;
+    }
+
+    /**
+     * Appends the waiter to the back of the queue, must be called with m_mutex held.
+     */
+    auto push_waiter(detail::acquire_operation<max_value>* waiter) -> void
+    {
+        waiter->m_next   = nullptr;
+        waiter->m_prev   = m_waiters_tail;
+        waiter->m_queued = true;
+        if (m_waiters_tail == nullptr)
+        {
+            m_waiters_head = waiter;
+        }
+        else
+        {
+            m_waiters_tail->m_next = waiter;
+        }
+        m_waiters_tail = waiter;
+        m_waiter_count.fetch_add(1, std::memory_order::release);
+    }
+
+    /**
+     * Unlinks the waiter from anywhere in the queue, must be called with m_mutex held.
+     */
+    auto remove_waiter(detail::acquire_operation<max_value>* waiter) -> void
+    {
+        if (waiter->m_prev == nullptr)
+        {
+            m_waiters_head = waiter->m_next;
+        }
+        else
+        {
+            waiter->m_prev->m_next = waiter->m_next;
+        }
+
+        if (waiter->m_next == nullptr)
+        {
+            m_waiters_tail = waiter->m_prev;
+        }
+        else
+        {
+            waiter->m_next->m_prev = waiter->m_prev;
+        }
+
+        waiter->m_next   = nullptr;
+        waiter->m_prev   = nullptr;
+        waiter->m_queued = false;
+        m_waiter_count.fetch_sub(1, std::memory_order::release);
+    }
+
+    static auto append_waiter(
+        detail::acquire_operation<max_value>*& head,
+        detail::acquire_operation<max_value>*& tail,
+        detail::acquire_operation<max_value>*  waiter) -> void
+    {
+        if (tail == nullptr)
+        {
+            head = waiter;
+        }
+        else
+        {
+            tail->m_next = waiter;
+        }
+        tail = waiter;
+    }
+
+    /**
+     * Grants resources to the waiters in order and unlinks them, stops at the first one that cannot be
+     * satisfied so it keeps its place at the front of the queue.  Must be called with m_mutex held.
+     * @return The granted waiters which must be resumed via resume_waiters() after releasing m_mutex.
+     */
+    auto grant_waiters_locked() -> detail::acquire_operation<max_value>*
+    {
+        detail::acquire_operation<max_value>* granted{nullptr};
+        detail::acquire_operation<max_value>* granted_tail{nullptr};
+        while (m_waiters_head != nullptr && try_take(m_waiters_head->m_count))
+        {
+            auto* waiter = m_waiters_head;
+            remove_waiter(waiter);
+            if (waiter->try_claim())
+            {
+                append_waiter(granted, granted_tail, waiter);
+            }
+            else
+            {
+                // The waiter timed out, give its resources back to whoever is next in line.
+                m_counter.fetch_add(waiter->m_count, std::memory_order::release);
+            }
+        }
+        return granted;
+    }
+
+    static auto resume_waiters(detail::acquire_operation<max_value>* waiter) -> void
+    {
+        while (waiter != nullptr)
+        {
+            auto* next = waiter->m_next;
+            waiter->m_awaiting_coroutine.resume();
+            waiter = next;
+        }
+    }
+
+    /**
+     * Resumes the granted waiters on the given executor, or inline if the executor refuses them.
+     */
+    template<concepts::executor executor_type>
+    static auto resume_waiters(std::unique_ptr<executor_type>& e, detail::acquire_operation<max_value>* waiter) -> void
+    {
+        while (waiter != nullptr)
+        {
+            auto* next = waiter->m_next;
+            if (!e->resume(waiter->m_awaiting_coroutine))
+            {
+                waiter->m_awaiting_coroutine.resume();
+            }
+            waiter = next;
+        }
+    }
+
+    /**
+     * Unlinks a waiter whose timer expired, must be called with m_mutex held.  Removing the waiter can unblock the
+     * waiters queued behind it so they are granted as well.
+     * @return The granted waiters, these must be resumed on an executor since m_mutex is still held.
+     */
+    auto remove_timed_out_waiter_locked(detail::acquire_operation<max_value>& waiter)
+        -> detail::acquire_operation<max_value>*
+    {
+        if (waiter.m_queued)
+        {
+            remove_waiter(&waiter);
+        }
+        return grant_waiters_locked();
+    }
 
     /// @brief The current number of resources that are available to acquire.
     std::atomic<std::ptrdiff_t> m_counter;
-    /// @brief The current list of awaiters attempting to acquire the semaphore.
-    std::atomic<detail::acquire_operation<max_value>*> m_acquire_waiters{nullptr};
+    /// @brief FIFO queue of awaiters attempting to acquire the semaphore, guarded by m_mutex.
+    detail::acquire_operation<max_value>* m_waiters_head{nullptr};
+    detail::acquire_operation<max_value>* m_waiters_tail{nullptr};
+    /// @brief The number of queued awaiters, lets try_acquire() avoid cutting in line without the mutex.
+    std::atomic<std::size_t> m_waiter_count{0};
     /// @brief mutex used to do acquire and release operations
     coro::mutex m_mutex;
     /// @brief Flag to denote that all waiters should be woken up with the shutdown result.
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "coro/concepts/executor.hpp"
+#include "coro/detail/task_self_deleting.hpp"
 #include "coro/mutex.hpp"
 #include "coro/task.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <coroutine>
 
+#ifdef LIBCORO_FEATURE_NETWORKING
+    #include "coro/detail/poll_info.hpp"
+#endif
+
 namespace coro
 {
 template<concepts::executor executor_type>
@@ -51,11 +57,28 @@ struct shared_lock_operation
 
     auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
     {
+        if (m_exclusive)
+        {
+            // Close the reader fast path so the current readers drain, the last one out will see the flag
+            // and wake us. If they have already drained between await_ready() and now take the lock.
+            auto previous = m_shared_mutex.m_reader_state.fetch_or(
+                coro::shared_mutex<executor_type>::slow_path_flag, std::memory_order::acq_rel);
+            if ((previous & coro::shared_mutex<executor_type>::reader_mask) == 0 &&
+                !m_shared_mutex.m_locked_exclusive && m_shared_mutex.m_head_waiter.load(std::memory_order::acquire) == nullptr)
+            {
+                m_shared_mutex.m_locked_exclusive = true;
+                m_shared_mutex.m_mutex.unlock();
+                return false;
+            }
+        }
+
         // For sure the lock is currently held in a manner that it cannot be acquired, suspend ourself
         // at the end of the waiter list.
 
         auto* tail_waiter = m_shared_mutex.m_tail_waiter.load(std::memory_order::acquire);
 
+        m_prev   = tail_waiter;
+        m_queued = true;
         if (tail_waiter == nullptr)
         {
             m_shared_mutex.m_head_waiter = this;
@@ -75,6 +98,10 @@ struct shared_lock_operation
         }
 
         m_awaiting_coroutine = awaiting_coroutine;
+        if (m_on_queued != nullptr)
+        {
+            m_on_queued(*this);
+        }
         m_shared_mutex.m_mutex.unlock();
         return true;
     }
@@ -84,12 +111,202 @@ struct shared_lock_operation
 protected:
     friend class coro::shared_mutex<executor_type>;
 
+    /**
+     * Called with the internal mutex held before this waiter is granted the lock.
+     * @return False if the waiter has already timed out and must be skipped.
+     */
+    auto try_claim() noexcept -> bool { return m_on_claim == nullptr || m_on_claim(*this); }
+
+    /// Only set by timed waiters, called with the internal mutex held once this waiter has been queued.
+    auto (*m_on_queued)(shared_lock_operation&) noexcept -> void {nullptr};
+    /// Only set by timed waiters, claims the waiter from its timer.  Plain waiters can always be claimed.
+    auto (*m_on_claim)(shared_lock_operation&) noexcept -> bool {nullptr};
     std::coroutine_handle<> m_awaiting_coroutine;
     shared_lock_operation* m_next{nullptr};
+    shared_lock_operation* m_prev{nullptr};
+    /// True while this waiter is linked in the waiter list, guarded by the internal mutex.
+    bool m_queued{false};
     coro::shared_mutex<executor_type>& m_shared_mutex;
     bool m_exclusive{false};
 };
 
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+/**
+ * A shared or exclusive lock acquire that gives up after a timeout.  The awaiter's timer entry is registered
+ * with the io executor, on timeout the timer callback unlinks the waiter from the waiter list under the internal
+ * mutex, inline if the mutex is free, otherwise through a detail::locked_callback that is run by whoever hands it
+ * the mutex.
+ */
+template<concepts::executor executor_type, concepts::io_executor io_executor_type>
+struct timed_shared_lock_operation : public shared_lock_operation<executor_type>
+{
+    enum class state_t : uint8_t
+    {
+        waiting,
+        acquired,
+        timed_out
+    };
+
+    /// @brief The timer entry handed to the io executor, it points back at its awaiter.
+    struct timer_entry : public detail::poll_info
+    {
+        explicit timer_entry(timed_shared_lock_operation& operation) : m_operation(operation) {}
+        timed_shared_lock_operation& m_operation;
+    };
+
+    /// @brief Unlinks the timed out awaiter while holding the internal mutex.
+    struct unlink_entry : public detail::locked_callback
+    {
+        explicit unlink_entry(timed_shared_lock_operation& operation)
+            : detail::locked_callback(operation.m_shared_mutex.m_mutex, &timed_shared_lock_operation::on_unlink),
+              m_operation(operation)
+        {
+        }
+        timed_shared_lock_operation& m_operation;
+    };
+
+    timed_shared_lock_operation(
+        coro::shared_mutex<executor_type>& shared_mutex,
+        const bool                         exclusive,
+        std::unique_ptr<io_executor_type>& executor,
+        std::chrono::nanoseconds           timeout)
+        : shared_lock_operation<executor_type>(shared_mutex, exclusive),
+          m_executor(executor),
+          m_timeout(timeout),
+          m_timer(*this),
+          m_unlink(*this)
+    {
+        this->m_on_queued = &timed_shared_lock_operation::on_queued;
+        this->m_on_claim  = &timed_shared_lock_operation::on_claim;
+    }
+
+    /**
+     * @return True if the lock was acquired, false if the timeout expired first.
+     */
+    auto await_resume() noexcept -> bool
+    {
+        auto state = m_state.load(std::memory_order::acquire);
+        if (state == state_t::acquired)
+        {
+            // The waiter was granted the lock, if the timer is concurrently firing this waits for its callback
+            // to back off.
+            m_executor->cancel_timer(m_timer);
+        }
+        return state != state_t::timed_out;
+    }
+
+protected:
+    static auto on_queued(shared_lock_operation<executor_type>& operation) noexcept -> void
+    {
+        auto& self                = static_cast<timed_shared_lock_operation&>(operation);
+        self.m_timer.m_on_timeout = &timed_shared_lock_operation::on_timeout;
+        self.m_executor->add_timer(clock::now() + self.m_timeout, self.m_timer);
+    }
+
+    /**
+     * Claims the waiter from its timer, this only flips the state so it can be called from a timer callback.
+     */
+    static auto on_claim(shared_lock_operation<executor_type>& operation) noexcept -> bool
+    {
+        auto& self     = static_cast<timed_shared_lock_operation&>(operation);
+        auto  expected = state_t::waiting;
+        return self.m_state.compare_exchange_strong(
+            expected, state_t::acquired, std::memory_order::acq_rel, std::memory_order::acquire);
+    }
+
+    /**
+     * @brief Called by the io executor when the timer expires while holding its timer lock.
+     * @return The awaiting coroutine if the waiter was unlinked inline, or nullptr if it was granted first or
+     *         will be unlinked and resumed by the current holder of the internal mutex.
+     */
+    static auto on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+    {
+        auto& self     = static_cast<timer_entry&>(pi).m_operation;
+        auto  expected = state_t::waiting;
+        if (!self.m_state.compare_exchange_strong(
+                expected, state_t::timed_out, std::memory_order::acq_rel, std::memory_order::acquire))
+        {
+            return nullptr;
+        }
+
+        auto handle = self.m_awaiting_coroutine;
+        if (self.m_unlink.run(self.m_executor))
+        {
+            return handle;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Unlinks the timed out waiter while holding the internal mutex.  Nothing is resumed inline, this runs within
+     * the timer callback or the unlock of whoever handed it the mutex.
+     */
+    static auto on_unlink(detail::locked_callback& callback, bool ran_inline) noexcept -> void
+    {
+        auto& self     = static_cast<unlink_entry&>(callback).m_operation;
+        auto& executor = self.m_executor;
+        auto  handle   = self.m_awaiting_coroutine;
+        coro::shared_mutex<executor_type>::resume_waiter(
+            executor, self.m_shared_mutex.remove_timed_out_waiter_locked(self));
+
+        // Inline the timer callback hands the awaiting coroutine back to the io executor itself.
+        if (!ran_inline && !executor->resume(handle))
+        {
+            handle.resume();
+        }
+    }
+
+private:
+    std::unique_ptr<io_executor_type>& m_executor;
+    std::chrono::nanoseconds           m_timeout;
+    std::atomic<state_t>               m_state{state_t::waiting};
+    timer_entry                        m_timer;
+    unlink_entry                       m_unlink;
+};
+
+#endif
+
+template<concepts::executor executor_type>
+struct lock_shared_operation
+{
+    explicit lock_shared_operation(coro::shared_mutex<executor_type>& shared_mutex) : m_shared_mutex(shared_mutex) {}
+
+    auto await_ready() noexcept -> bool { return m_shared_mutex.try_lock_shared_fast(); }
+
+    auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> std::coroutine_handle<>
+    {
+        // A writer holds or is waiting on the lock, queue up behind it on the internal mutex.  The slow path
+        // deletes itself once it resumes the awaiting coroutine so it is only ever started, never touched again.
+        return m_shared_mutex.lock_shared_slow(awaiting_coroutine).handle();
+    }
+
+    auto await_resume() noexcept -> void {}
+
+private:
+    coro::shared_mutex<executor_type>& m_shared_mutex;
+};
+
+template<concepts::executor executor_type>
+struct unlock_shared_operation
+{
+    explicit unlock_shared_operation(coro::shared_mutex<executor_type>& shared_mutex) : m_shared_mutex(shared_mutex) {}
+
+    auto await_ready() noexcept -> bool { return m_shared_mutex.unlock_shared_fast(); }
+
+    auto await_suspend(std::coroutine_handle<> awaiting_coroutine) -> std::coroutine_handle<>
+    {
+        // This was the last reader and a writer is waiting, hand the lock over.  The slow path deletes itself
+        // once it resumes the awaiting coroutine so it is only ever started, never touched again.
+        return m_shared_mutex.unlock_shared_slow(awaiting_coroutine).handle();
+    }
+
+    auto await_resume() noexcept -> void {}
+
+private:
+    coro::shared_mutex<executor_type>& m_shared_mutex;
+};
+
 } // namespace detail
 
 template<concepts::executor executor_type>
@@ -117,14 +334,13 @@ public:
 
     /**
      * Acquires the lock in a shared state, executes the scoped task, and then unlocks the shared lock.
-     * Because unlocking a coro::shared_mutex is a task this scoped version cannot be returned as a RAII
+     * Because unlocking a coro::shared_mutex can suspend this scoped version cannot be returned as a RAII
      * object due to destructors not being able to be co_await'ed.
      * @param scoped_task The user's scoped task to execute after acquiring the shared lock.
      */
     [[nodiscard]] auto scoped_lock_shared(coro::task<void> scoped_task) -> coro::task<void>
     {
-        co_await m_mutex.lock();
-        co_await detail::shared_lock_operation<executor_type>{*this, false};
+        co_await lock_shared();
         co_await scoped_task;
         co_await unlock_shared();
         co_return;
@@ -147,13 +363,13 @@ public:
 
     /**
      * Acquires the lock in a shared state. The shared_mutex must be unlock_shared() to release.
-     * @return task
+     * While no writer holds or is waiting on the lock this is a single CAS and does not suspend or
+     * allocate, otherwise the reader queues behind the writers in FIFO order.
+     * @return awaitable
      */
-    [[nodiscard]] auto lock_shared() -> coro::task<void>
+    [[nodiscard]] auto lock_shared() -> detail::lock_shared_operation<executor_type>
     {
-        co_await m_mutex.lock();
-        co_await detail::shared_lock_operation<executor_type>{*this, false};
-        co_return;
+        return detail::lock_shared_operation<executor_type>{*this};
     }
 
     /**
@@ -167,6 +383,47 @@ public:
         co_return;
     }
 
+#ifdef LIBCORO_FEATURE_NETWORKING
+    /**
+     * Acquires the lock in a shared state like lock_shared() but gives up if it has not been acquired before
+     * the timeout expires.  A waiter that times out is removed from the waiter list.
+     * @param executor The io executor that drives the timeout.
+     * @param timeout How long to wait for the lock.
+     * @return True if the lock was acquired, the shared_mutex must then be unlock_shared()'ed to release.
+     */
+    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    [[nodiscard]] auto try_lock_shared_for(
+        std::unique_ptr<io_executor_type>& executor, const std::chrono::duration<rep_type, period_type> timeout)
+        -> coro::task<bool>
+    {
+        if (try_lock_shared_fast())
+        {
+            co_return true;
+        }
+
+        co_await m_mutex.lock();
+        co_return co_await detail::timed_shared_lock_operation<executor_type, io_executor_type>{
+            *this, false, executor, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)};
+    }
+
+    /**
+     * Acquires the lock in an exclusive state like lock() but gives up if it has not been acquired before
+     * the timeout expires.  A waiter that times out is removed from the waiter list.
+     * @param executor The io executor that drives the timeout.
+     * @param timeout How long to wait for the lock.
+     * @return True if the lock was acquired, the shared_mutex must then be unlock()'ed to release.
+     */
+    template<concepts::io_executor io_executor_type, class rep_type, class period_type>
+    [[nodiscard]] auto try_lock_for(
+        std::unique_ptr<io_executor_type>& executor, const std::chrono::duration<rep_type, period_type> timeout)
+        -> coro::task<bool>
+    {
+        co_await m_mutex.lock();
+        co_return co_await detail::timed_shared_lock_operation<executor_type, io_executor_type>{
+            *this, true, executor, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)};
+    }
+#endif
+
     /**
      * @return True if the lock could immediately be acquired in a shared state.
      */
@@ -178,6 +435,11 @@ public:
         //          Zero exclusive waiters prevents exclusive starvation if shared locks are
         //          always continuously happening.
 
+        if (try_lock_shared_fast())
+        {
+            return true;
+        }
+
         if (m_mutex.try_lock())
         {
             coro::scoped_lock lk{m_mutex};
@@ -206,28 +468,12 @@ public:
      * behavior.
      *
      * If the shared user count drops to zero and this lock has an exclusive waiter then the exclusive
-     * waiter acquires the lock.
+     * waiter acquires the lock. Only that final reader suspends, every other reader releases with a
+     * single atomic decrement.
      */
-    [[nodiscard]] auto unlock_shared() -> coro::task<void>
+    [[nodiscard]] auto unlock_shared() -> detail::unlock_shared_operation<executor_type>
     {
-        auto lk = co_await m_mutex.scoped_lock();
-        auto users = m_shared_users.fetch_sub(1, std::memory_order::acq_rel);
-
-        // If this is the final unlock_shared() see if there is anyone to wakeup.
-        if (users == 1)
-        {
-            auto* head_waiter = m_head_waiter.load(std::memory_order::acquire);
-            if (head_waiter != nullptr)
-            {
-                wake_waiters(lk, head_waiter);
-            }
-            else
-            {
-                m_state = state::unlocked;
-            }
-        }
-
-        co_return;
+        return detail::unlock_shared_operation<executor_type>{*this};
     }
 
     /**
@@ -239,14 +485,16 @@ public:
     [[nodiscard]] auto unlock() -> coro::task<void>
     {
         auto lk = co_await m_mutex.scoped_lock();
+        m_locked_exclusive = false;
         auto* head_waiter = m_head_waiter.load(std::memory_order::acquire);
         if (head_waiter != nullptr)
         {
-            wake_waiters(lk, head_waiter);
+            wake_waiters(lk);
         }
         else
         {
-            m_state = state::unlocked;
+            // Re-open the reader fast path.
+            m_reader_state.fetch_and(reader_mask, std::memory_order::release);
         }
 
         co_return;
@@ -264,26 +512,29 @@ public:
 
 private:
     friend struct detail::shared_lock_operation<executor_type>;
-
-    enum class state
-    {
-        /// @brief The shared mutex is unlocked.
-        unlocked,
-        /// @brief The shared mutex is locked in shared mode.
-        locked_shared,
-        /// @brief The shared mutex is locked in exclusive mode.
-        locked_exclusive
-    };
+    friend struct detail::lock_shared_operation<executor_type>;
+    friend struct detail::unlock_shared_operation<executor_type>;
+#ifdef LIBCORO_FEATURE_NETWORKING
+    template<concepts::executor, concepts::io_executor>
+    friend struct detail::timed_shared_lock_operation;
+#endif
+
+    /// @brief Set in m_reader_state while a writer holds the lock or anyone is queued, readers must then
+    ///        take the slow path through m_mutex.
+    static constexpr uint64_t slow_path_flag = uint64_t{1} << 63;
+    /// @brief The bits of m_reader_state that count the shared users holding the lock.
+    static constexpr uint64_t reader_mask = slow_path_flag - 1;
 
     /// @brief This executor is for resuming multiple shared waiters.
     executor_type* m_executor{nullptr};
     /// @brief Exclusive access for mutating the shared mutex's state.
     coro::mutex m_mutex;
-    /// @brief The current state of the shared mutex.
-    std::atomic<state> m_state{state::unlocked};
+    /// @brief True while a writer holds the lock, guarded by m_mutex.
+    bool m_locked_exclusive{false};
 
-    /// @brief The current number of shared users that have acquired the lock.
-    std::atomic<uint64_t> m_shared_users{0};
+    /// @brief The number of shared users that have acquired the lock plus the slow_path_flag. While the flag
+    ///        is clear readers acquire and release the lock with a single atomic operation on this word.
+    std::atomic<uint64_t> m_reader_state{0};
     /// @brief The current number of exclusive waiters waiting to acquire the lock.  This is used to block
     ///        new incoming shared lock attempts so the exclusive waiter is not starved.
     std::atomic<uint64_t> m_exclusive_waiters{0};
@@ -291,98 +542,255 @@ private:
     std::atomic<detail::shared_lock_operation<executor_type>*> m_head_waiter{nullptr};
     std::atomic<detail::shared_lock_operation<executor_type>*> m_tail_waiter{nullptr};
 
-    auto try_lock_shared_locked() -> bool
+    auto try_lock_shared_fast() noexcept -> bool
     {
-        if (m_state == state::unlocked)
+        auto state = m_reader_state.load(std::memory_order::relaxed);
+        while ((state & slow_path_flag) == 0)
         {
-            // If the shared mutex is unlocked put it into shared mode and add ourself as using the lock.
-            m_state = state::locked_shared;
-            ++m_shared_users;
-            return true;
+            if (m_reader_state.compare_exchange_weak(
+                    state, state + 1, std::memory_order::acquire, std::memory_order::relaxed))
+            {
+                return true;
+            }
         }
-        else if (m_state == state::locked_shared && m_exclusive_waiters == 0)
+        return false;
+    }
+
+    auto unlock_shared_fast() noexcept -> bool
+    {
+        auto state = m_reader_state.fetch_sub(1, std::memory_order::acq_rel);
+        // Only the final reader out while the fast path is closed has anyone to wake up.
+        return (state & slow_path_flag) == 0 || (state & reader_mask) != 1;
+    }
+
+    auto lock_shared_slow(std::coroutine_handle<> awaiting_coroutine) -> detail::task_self_deleting
+    {
+        co_await m_mutex.lock();
+        co_await detail::shared_lock_operation<executor_type>{*this, false};
+        awaiting_coroutine.resume();
+        co_return;
+    }
+
+    auto unlock_shared_slow(std::coroutine_handle<> awaiting_coroutine) -> detail::task_self_deleting
+    {
         {
-            // If the shared mutex is in a shared locked state and there are no exclusive waiters
-            // the add ourself as using the lock.
-            ++m_shared_users;
-            return true;
+            auto lk = co_await m_mutex.scoped_lock();
+            // New readers could have joined through the slow path before we acquired the internal mutex.
+            if ((m_reader_state.load(std::memory_order::acquire) & reader_mask) == 0 && !m_locked_exclusive)
+            {
+                auto* head_waiter = m_head_waiter.load(std::memory_order::acquire);
+                if (head_waiter != nullptr)
+                {
+                    wake_waiters(lk);
+                }
+                else
+                {
+                    m_reader_state.fetch_and(reader_mask, std::memory_order::release);
+                }
+            }
         }
+        awaiting_coroutine.resume();
+        co_return;
+    }
 
+    auto try_lock_shared_locked() -> bool
+    {
         // If the lock is in shared mode but there are exclusive waiters then we will also wait so
         // the writers are not starved.
 
         // If the lock is in exclusive mode already then we need to wait.
 
-        return false;
+        if (m_locked_exclusive || m_exclusive_waiters > 0)
+        {
+            return false;
+        }
+
+        m_reader_state.fetch_add(1, std::memory_order::acquire);
+        return true;
     }
 
     auto try_lock_locked() -> bool
     {
-        if (m_state == state::unlocked)
+        if (m_locked_exclusive || m_head_waiter.load(std::memory_order::acquire) != nullptr)
         {
-            m_state = state::locked_exclusive;
-            return true;
+            return false;
+        }
+
+        // Only take the lock if there are no readers, closing the fast path in the same step.
+        auto state = m_reader_state.load(std::memory_order::relaxed);
+        while ((state & reader_mask) == 0)
+        {
+            if (m_reader_state.compare_exchange_weak(
+                    state, state | slow_path_flag, std::memory_order::acquire, std::memory_order::relaxed))
+            {
+                m_locked_exclusive = true;
+                return true;
+            }
         }
         return false;
     }
 
-    auto wake_waiters(coro::scoped_lock& lk, detail::shared_lock_operation<executor_type>* head_waiter) -> void
+    /**
+     * Unlinks the waiter from anywhere in the waiter list, must be called with m_mutex held.
+     */
+    auto remove_waiter(detail::shared_lock_operation<executor_type>* waiter) -> void
     {
+        if (waiter->m_prev == nullptr)
+        {
+            m_head_waiter.store(waiter->m_next, std::memory_order::release);
+        }
+        else
+        {
+            waiter->m_prev->m_next = waiter->m_next;
+        }
+
+        if (waiter->m_next == nullptr)
+        {
+            m_tail_waiter.store(waiter->m_prev, std::memory_order::release);
+        }
+        else
+        {
+            waiter->m_next->m_prev = waiter->m_prev;
+        }
+
+        if (waiter->m_exclusive)
+        {
+            m_exclusive_waiters.fetch_sub(1, std::memory_order::release);
+        }
+
+        waiter->m_next   = nullptr;
+        waiter->m_prev   = nullptr;
+        waiter->m_queued = false;
+    }
+
+    /**
+     * Claims the first waiter that has not timed out, timed out waiters in front of it are unlinked since
+     * their own timer resumes them.
+     * @param exclusive_allowed If false an exclusive waiter at the front is left queued and unclaimed.
+     * @return The claimed waiter which is still linked, or nullptr if there is none to claim.
+     */
+    auto next_waiter(bool exclusive_allowed) -> detail::shared_lock_operation<executor_type>*
+    {
+        auto* waiter = m_head_waiter.load(std::memory_order::acquire);
+        while (waiter != nullptr && (exclusive_allowed || !waiter->m_exclusive) && !waiter->try_claim())
+        {
+            remove_waiter(waiter);
+            waiter = m_head_waiter.load(std::memory_order::acquire);
+        }
+
+        if (waiter != nullptr && !exclusive_allowed && waiter->m_exclusive)
+        {
+            return nullptr;
+        }
+        return waiter;
+    }
+
+    auto wake_waiters(coro::scoped_lock& lk) -> void
+    {
+        auto* exclusive_waiter = wake_waiters_locked();
+
+        // Cannot unlock until the entire set of shared waiters has been traversed. I think this
+        // makes more sense than allocating space for all the shared waiters, unlocking, and then
+        // resuming in a batch?
+        lk.unlock();
+
+        // Since this is an exclusive lock waiting we can resume it directly.
+        if (exclusive_waiter != nullptr)
+        {
+            exclusive_waiter->m_awaiting_coroutine.resume();
+        }
+    }
+
+    /**
+     * Grants the lock to the next waiters, must be called with m_mutex held.  Shared waiters are resumed
+     * on m_executor.
+     * @return The exclusive waiter that now holds the lock and must be resumed by the caller, or nullptr.
+     */
+    auto wake_waiters_locked() -> detail::shared_lock_operation<executor_type>*
+    {
+        auto* head_waiter = next_waiter(true);
+        if (head_waiter == nullptr)
+        {
+            // Every waiter had timed out, re-open the reader fast path.
+            m_reader_state.fetch_and(reader_mask, std::memory_order::release);
+            return nullptr;
+        }
+
         // First determine what the next lock state will be based on the first waiter.
         if (head_waiter->m_exclusive)
         {
-            // If its exclusive then only this waiter can be woken up.
-            m_state.store(state::locked_exclusive, std::memory_order::release);
-            if (head_waiter->m_next == nullptr)
-            {
-                // This is the final waiter, set the list to null.
-                m_head_waiter.store(nullptr, std::memory_order::release);
-                m_tail_waiter.store(nullptr, std::memory_order::release);
-            }
-            else
-            {
-                // Advance the head waiter to next.
-                m_head_waiter.store(head_waiter->m_next, std::memory_order::release);
-            }
+            // If its exclusive then only this waiter can be woken up, the fast path stays closed.
+            m_locked_exclusive = true;
+            remove_waiter(head_waiter);
+            return head_waiter;
+        }
 
-            m_exclusive_waiters.fetch_sub(1, std::memory_order::release);
+        wake_shared_waiters(head_waiter);
+        return nullptr;
+    }
 
-            // Since this is an exclusive lock waiting we can resume it directly.
-            lk.unlock();
-            head_waiter->m_awaiting_coroutine.resume();
+    /**
+     * Grants the lock in a shared state to the claimed waiter and every shared waiter up to the next
+     * exclusive waiter, must be called with m_mutex held.
+     */
+    auto wake_shared_waiters(detail::shared_lock_operation<executor_type>* to_resume) -> void
+    {
+        // Scan forward and awake all shared waiters onto the given thread pool so they can run in parallel.
+        while (to_resume != nullptr)
+        {
+            remove_waiter(to_resume);
+            m_reader_state.fetch_add(1, std::memory_order::release);
+            m_executor->resume(to_resume->m_awaiting_coroutine);
+
+            to_resume = next_waiter(false);
         }
-        else
+
+        // With no writer left in line re-open the reader fast path.
+        if (m_head_waiter.load(std::memory_order::acquire) == nullptr)
         {
-            // If its shared then we will scan forward and awake all shared waiters onto the given
-            // thread pool so they can run in parallel.
-            m_state.store(state::locked_shared, std::memory_order::release);
-            while (true)
-            {
-                auto* to_resume = m_head_waiter.load(std::memory_order::acquire);
-                if (to_resume == nullptr || to_resume->m_exclusive)
-                {
-                    break;
-                }
+            m_reader_state.fetch_and(reader_mask, std::memory_order::release);
+        }
+    }
 
-                if (to_resume->m_next == nullptr)
-                {
-                    m_head_waiter.store(nullptr, std::memory_order::release);
-                    m_tail_waiter.store(nullptr, std::memory_order::release);
-                }
-                else
-                {
-                    m_head_waiter.store(to_resume->m_next, std::memory_order::release);
-                }
+    /**
+     * Unlinks a waiter whose timer expired, must be called with m_mutex held.  Removing a writer can unblock
+     * the readers queued behind it or re-open the reader fast path.
+     * @return The exclusive waiter that now holds the lock, it must be resumed on an executor since m_mutex is
+     *         still held.
+     */
+    auto remove_timed_out_waiter_locked(detail::shared_lock_operation<executor_type>& waiter)
+        -> detail::shared_lock_operation<executor_type>*
+    {
+        if (waiter.m_queued)
+        {
+            remove_waiter(&waiter);
+        }
 
-                m_shared_users.fetch_add(1, std::memory_order::release);
+        if (m_locked_exclusive)
+        {
+            return nullptr;
+        }
 
-                m_executor->resume(to_resume->m_awaiting_coroutine);
-            }
+        if ((m_reader_state.load(std::memory_order::acquire) & reader_mask) == 0)
+        {
+            return wake_waiters_locked();
+        }
+
+        // Readers hold the lock, the readers that were queued behind a timed out writer can join them.
+        wake_shared_waiters(next_waiter(false));
+        return nullptr;
+    }
 
-            // Cannot unlock until the entire set of shared waiters has been traversed. I think this
-            // makes more sense than allocating space for all the shared waiters, unlocking, and then
-            // resuming in a batch?
-            lk.unlock();
+    /**
+     * Resumes the waiter on the given executor, or inline if the executor refuses it.
+     */
+    template<concepts::executor resume_executor_type>
+    static auto resume_waiter(
+        std::unique_ptr<resume_executor_type>& e, detail::shared_lock_operation<executor_type>* waiter) -> void
+    {
+        if (waiter != nullptr && !e->resume(waiter->m_awaiting_coroutine))
+        {
+            waiter->m_awaiting_coroutine.resume();
         }
     }
 };
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace coro
+{
+template<typename return_type = void>
+class shared_task;
+
+namespace detail
+{
+struct shared_task_waiter
+{
+    std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+    shared_task_waiter*     m_next{nullptr};
+};
+
+class shared_promise_base
+{
+    friend struct final_awaitable;
+    struct final_awaitable
+    {
+        auto await_ready() const noexcept -> bool { return false; }
+
+        template<typename promise_type>
+        auto await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept -> void
+        {
+            // Publish the result and resume every awaiter that arrived while the task was running.  The
+            // awaiters may destroy this frame, so only the detached list is touched from here on.
+            shared_promise_base& promise = coroutine.promise();
+            void* waiters = promise.m_state.exchange(static_cast<void*>(&promise), std::memory_order::acq_rel);
+
+            auto* waiter = static_cast<shared_task_waiter*>(waiters);
+            while (waiter != nullptr)
+            {
+                auto* next = waiter->m_next;
+                waiter->m_awaiting_coroutine.resume();
+                waiter = next;
+            }
+        }
+
+        auto await_resume() noexcept -> void {}
+    };
+
+public:
+    shared_promise_base() noexcept = default;
+    ~shared_promise_base()         = default;
+
+    auto initial_suspend() noexcept { return std::suspend_always{}; }
+
+    auto final_suspend() noexcept { return final_awaitable{}; }
+
+    /**
+     * @return True if the task has completed and its result is available.
+     */
+    auto is_ready() const noexcept -> bool
+    {
+        return m_state.load(std::memory_order::acquire) == static_cast<const void*>(this);
+    }
+
+    /**
+     * Registers the waiter to be resumed when the task completes, the first waiter to register starts the task.
+     * @return The coroutine to resume next, the task itself if it needs to start, noop if the waiter was queued
+     *         or the waiter's own coroutine if the task has already completed.
+     */
+    auto try_await(shared_task_waiter& waiter, std::coroutine_handle<> coroutine) noexcept -> std::coroutine_handle<>
+    {
+        void* const completed = static_cast<void*>(this);
+
+        void* state = m_state.load(std::memory_order::acquire);
+        do
+        {
+            if (state == completed)
+            {
+                return waiter.m_awaiting_coroutine;
+            }
+
+            waiter.m_next = static_cast<shared_task_waiter*>(state);
+        } while (!m_state.compare_exchange_weak(
+            state, static_cast<void*>(&waiter), std::memory_order::acq_rel, std::memory_order::acquire));
+
+        // The first waiter starts the task, the list is never empty again until the task completes.
+        return (state == nullptr) ? coroutine : std::noop_coroutine();
+    }
+
+    auto add_ref() noexcept -> void { m_ref_count.fetch_add(1, std::memory_order::relaxed); }
+
+    /**
+     * @return True if this was the final reference and the coroutine frame must be destroyed.
+     */
+    auto release_ref() noexcept -> bool { return m_ref_count.fetch_sub(1, std::memory_order::acq_rel) == 1; }
+
+private:
+    /// Either nullptr if the task has not started, the address of the promise if the task has completed,
+    /// or the head of the list of waiters while the task is running.
+    std::atomic<void*> m_state{nullptr};
+    /// The number of shared_task objects referencing this coroutine.
+    std::atomic<std::uint32_t> m_ref_count{1};
+};
+
+template<typename return_type>
+class shared_promise final : public shared_promise_base
+{
+public:
+    using task_type        = shared_task<return_type>;
+    using coroutine_handle = std::coroutine_handle<shared_promise<return_type>>;
+    using stored_type      = std::remove_const_t<return_type>;
+
+    shared_promise() noexcept                        = default;
+    shared_promise(const shared_promise&)            = delete;
+    shared_promise(shared_promise&&)                 = delete;
+    shared_promise& operator=(const shared_promise&) = delete;
+    shared_promise& operator=(shared_promise&&)      = delete;
+    ~shared_promise()                                = default;
+
+    auto get_return_object() noexcept -> task_type;
+
+    template<typename value_type>
+    requires std::is_constructible_v<stored_type, value_type&&>
+    auto return_value(value_type&& value) -> void
+    {
+        m_storage.template emplace<stored_type>(std::forward<value_type>(value));
+    }
+
+    auto unhandled_exception() noexcept -> void
+    {
+        m_storage.template emplace<std::exception_ptr>(std::current_exception());
+    }
+
+    /**
+     * @return The result shared by every awaiter, it cannot be moved out since other awaiters observe it.
+     */
+    auto result() const -> const stored_type&
+    {
+        if (std::holds_alternative<stored_type>(m_storage))
+        {
+            return std::get<stored_type>(m_storage);
+        }
+        else if (std::holds_alternative<std::exception_ptr>(m_storage))
+        {
+            std::rethrow_exception(std::get<std::exception_ptr>(m_storage));
+        }
+        else
+        {
+            throw std::runtime_error{"The return value was never set, did you execute the coroutine?"};
+        }
+    }
+
+private:
+    std::variant<std::monostate, stored_type, std::exception_ptr> m_storage{};
+};
+
+template<>
+class shared_promise<void> final : public shared_promise_base
+{
+public:
+    using task_type        = shared_task<void>;
+    using coroutine_handle = std::coroutine_handle<shared_promise<void>>;
+
+    shared_promise() noexcept                        = default;
+    shared_promise(const shared_promise&)            = delete;
+    shared_promise(shared_promise&&)                 = delete;
+    shared_promise& operator=(const shared_promise&) = delete;
+    shared_promise& operator=(shared_promise&&)      = delete;
+    ~shared_promise()                                = default;
+
+    auto get_return_object() noexcept -> task_type;
+
+    auto return_void() noexcept -> void {}
+
+    auto unhandled_exception() noexcept -> void { m_exception_ptr = std::current_exception(); }
+
+    auto result() const -> void
+    {
+        if (m_exception_ptr)
+        {
+            std::rethrow_exception(m_exception_ptr);
+        }
+    }
+
+private:
+    std::exception_ptr m_exception_ptr{nullptr};
+};
+
+} // namespace detail
+
+/**
+ * A shared_task is a lazily started coroutine that can be co_await'ed any number of times by any number of
+ * coroutines, concurrently or after it has completed.  The first awaiter starts the task, every other awaiter
+ * suspends until it completes and then all of them observe the same result or exception.  This is useful to
+ * de-duplicate concurrent requests for the same expensive work, see coro::single_flight.
+ *
+ * Copies of a shared_task reference the same coroutine, the coroutine frame is destroyed when the final
+ * copy is destroyed.  Awaiters receive a const reference to the shared result, copy it to keep it beyond
+ * the lifetime of the shared_task.  The task runs on the thread of its first awaiter and every waiter is
+ * resumed inline on the thread that completes it.
+ */
+template<typename return_type>
+class [[nodiscard]] shared_task
+{
+public:
+    using task_type        = shared_task<return_type>;
+    using promise_type     = detail::shared_promise<return_type>;
+    using coroutine_handle = std::coroutine_handle<promise_type>;
+
+    struct awaitable : private detail::shared_task_waiter
+    {
+        explicit awaitable(coroutine_handle coroutine) noexcept : m_coroutine(coroutine) {}
+
+        auto await_ready() const noexcept -> bool { return !m_coroutine || m_coroutine.promise().is_ready(); }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> std::coroutine_handle<>
+        {
+            this->m_awaiting_coroutine = awaiting_coroutine;
+            return m_coroutine.promise().try_await(*this, m_coroutine);
+        }
+
+        auto await_resume() -> decltype(auto)
+        {
+            if (!m_coroutine)
+            {
+                throw std::runtime_error{"coro::shared_task is empty, it cannot be awaited"};
+            }
+            return m_coroutine.promise().result();
+        }
+
+    private:
+        coroutine_handle m_coroutine{nullptr};
+    };
+
+    shared_task() noexcept : m_coroutine(nullptr) {}
+
+    explicit shared_task(coroutine_handle handle) noexcept : m_coroutine(handle) {}
+    shared_task(const shared_task& other) noexcept : m_coroutine(other.m_coroutine)
+    {
+        if (m_coroutine != nullptr)
+        {
+            m_coroutine.promise().add_ref();
+        }
+    }
+    shared_task(shared_task&& other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {}
+
+    ~shared_task() { destroy(); }
+
+    auto operator=(const shared_task& other) noexcept -> shared_task&
+    {
+        if (m_coroutine != other.m_coroutine)
+        {
+            destroy();
+            m_coroutine = other.m_coroutine;
+            if (m_coroutine != nullptr)
+            {
+                m_coroutine.promise().add_ref();
+            }
+        }
+
+        return *this;
+    }
+
+    auto operator=(shared_task&& other) noexcept -> shared_task&
+    {
+        if (std::addressof(other) != this)
+        {
+            destroy();
+            m_coroutine = std::exchange(other.m_coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @return True if the task has completed or if this shared_task is empty.
+     */
+    auto is_ready() const noexcept -> bool { return m_coroutine == nullptr || m_coroutine.promise().is_ready(); }
+
+    /**
+     * Drops this reference to the coroutine, the frame is destroyed if this was the final reference.
+     * @return True if this shared_task referenced a coroutine.
+     */
+    auto destroy() noexcept -> bool
+    {
+        if (m_coroutine != nullptr)
+        {
+            if (m_coroutine.promise().release_ref())
+            {
+                m_coroutine.destroy();
+            }
+            m_coroutine = nullptr;
+            return true;
+        }
+
+        return false;
+    }
+
+    auto operator co_await() const noexcept -> awaitable { return awaitable{m_coroutine}; }
+
+    auto operator==(const shared_task& other) const noexcept -> bool { return m_coroutine == other.m_coroutine; }
+
+    auto handle() -> coroutine_handle { return m_coroutine; }
+
+private:
+    coroutine_handle m_coroutine{nullptr};
+};
+
+namespace detail
+{
+template<typename return_type>
+inline auto shared_promise<return_type>::get_return_object() noexcept -> shared_task<return_type>
+{
+    return shared_task<return_type>{coroutine_handle::from_promise(*this)};
+}
+
+inline auto shared_promise<void>::get_return_object() noexcept -> shared_task<>
+{
+    return shared_task<>{coroutine_handle::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace coro
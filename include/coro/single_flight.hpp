@@ -0,0 +1,129 @@
+#pragma once
+
+#include "coro/concepts/awaitable.hpp"
+#include "coro/shared_task.hpp"
+#include "coro/task.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace coro
+{
+/**
+ * Single flight de-duplicates concurrent work by key, while the work for a key is in flight every other
+ * caller requesting the same key suspends on it and receives a copy of the same result instead of starting
+ * the work again.  Once the work completes the key is forgotten so the next caller starts it afresh, results
+ * are not cached.
+ *
+ * This prevents a thundering herd against a backend when many tasks miss a cache for the same key at once.
+ * \code
+coro::single_flight<std::string, std::string> flights{};
+...
+auto value = co_await flights.run(key, [&]() { return fetch_from_backend(key); });
+ * \endcode
+ *
+ * @tparam key_type The key identifying the work to de-duplicate.
+ * @tparam value_type The result of the work, every caller receives a copy.
+ */
+template<typename key_type, typename value_type, typename hash_type = std::hash<key_type>>
+class single_flight
+{
+public:
+    single_flight() = default;
+    ~single_flight() = default;
+
+    single_flight(const single_flight&)                    = delete;
+    single_flight(single_flight&&)                         = delete;
+    auto operator=(const single_flight&) -> single_flight& = delete;
+    auto operator=(single_flight&&) -> single_flight&      = delete;
+
+    /**
+     * Runs the work for the key, or joins it if it is already in flight.  The work executes on the thread of
+     * the caller that started it and the joined callers resume on the thread that completes it.
+     * @param key The key identifying the work.
+     * @param work A callable returning an awaitable that produces the value, it is only invoked if this caller
+     *             starts the work.
+     * @return The value produced by the in flight work, exceptions are rethrown to every caller.
+     */
+    template<std::invocable functor_type>
+    requires concepts::awaitable<std::invoke_result_t<functor_type>>
+    [[nodiscard]] auto run(key_type key, functor_type work) -> coro::task<value_type>
+    {
+        shared_task<value_type> flight{};
+        {
+            std::scoped_lock lk{m_mutex};
+            auto             it = m_flights.find(key);
+            if (it != m_flights.end())
+            {
+                flight = it->second;
+            }
+            else
+            {
+                flight = make_flight(key, std::move(work));
+                m_flights.emplace(std::move(key), flight);
+            }
+        }
+
+        if constexpr (std::is_void_v<value_type>)
+        {
+            co_await flight;
+            co_return;
+        }
+        else
+        {
+            // Copy the shared result out since the other callers observe it too.
+            value_type value = co_await flight;
+            co_return value;
+        }
+    }
+
+    /**
+     * @return The number of keys with work in flight.
+     */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        std::scoped_lock lk{m_mutex};
+        return m_flights.size();
+    }
+
+private:
+    /// Guards the in flight work.
+    mutable std::mutex m_mutex{};
+    /// The work currently in flight by key.
+    std::unordered_map<key_type, shared_task<value_type>, hash_type> m_flights{};
+
+    /// Forgets the key when the flight completes, even if the work threw.
+    struct erase_on_exit
+    {
+        single_flight&  m_single_flight;
+        const key_type& m_key;
+
+        ~erase_on_exit()
+        {
+            std::scoped_lock lk{m_single_flight.m_mutex};
+            m_single_flight.m_flights.erase(m_key);
+        }
+    };
+
+    template<typename functor_type>
+    auto make_flight(key_type key, functor_type work) -> shared_task<value_type>
+    {
+        // The callers awaiting this flight keep it alive after it is erased from the map.
+        erase_on_exit guard{*this, key};
+        if constexpr (std::is_void_v<value_type>)
+        {
+            co_await work();
+            co_return;
+        }
+        else
+        {
+            co_return co_await work();
+        }
+    }
+};
+
+} // namespace coro
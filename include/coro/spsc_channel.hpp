@@ -0,0 +1,392 @@
+#pragma once
+
+#include "coro/detail/asymmetric_fence.hpp"
+#include "coro/expected.hpp"
+#include "coro/ring_buffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+/**
+ * A bounded single producer single consumer channel.  Exactly one coroutine may produce into the
+ * channel and exactly one coroutine may consume from it at any given time, in exchange produce and
+ * consume operations are wait-free when the channel is neither full nor empty and do not allocate
+ * a coroutine frame.  The producer only suspends when the channel is full and the consumer only
+ * suspends when the channel is empty, the opposite side resumes it inline once it can make progress.
+ *
+ * The produce and consume operations return the same results as coro::ring_buffer so the two can
+ * be swapped for each other when a pipeline stage is known to be single producer single consumer.
+ *
+ * @tparam element The type of element the channel will store.  Note that this type should be
+ *         cheap to move if possible as it is moved into and out of the channel.
+ * @tparam num_elements The maximum number of elements the channel can store, must be >= 1.
+ */
+template<typename element, std::size_t num_elements>
+class spsc_channel
+{
+    static_assert(num_elements != 0, "num_elements cannot be zero");
+
+    /// The assumed cache line size, the producer and consumer indexes and waiters are kept on separate lines.
+    static constexpr std::size_t cache_line_size = 64;
+
+    enum class try_result
+    {
+        /// @brief The operation completed.
+        completed,
+        /// @brief The channel is full (produce) or empty (consume).
+        would_suspend,
+        /// @brief The channel has been shutdown.
+        stopped
+    };
+
+public:
+    struct produce_operation
+    {
+        produce_operation(spsc_channel<element, num_elements>& channel, element e)
+            : m_channel(channel),
+              m_e(std::move(e))
+        {
+        }
+
+        auto await_ready() noexcept -> bool
+        {
+            m_result = m_channel.try_produce_impl(m_e);
+            return m_result != try_result::would_suspend;
+        }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+            m_channel.m_producer_waiter.store(this, std::memory_order::seq_cst);
+            detail::asymmetric_fence_heavy();
+
+            // The consumer could have made room (or the channel was shutdown) while registering, this
+            // check must not modify any state since the consumer is allowed to resume this coroutine
+            // as soon as it has been published.
+            if (!m_channel.can_produce())
+            {
+                return true;
+            }
+
+            // If the waiter can't be retracted the consumer is already resuming this coroutine.
+            produce_operation* expected = this;
+            return !m_channel.m_producer_waiter.compare_exchange_strong(
+                expected, nullptr, std::memory_order::acq_rel, std::memory_order::acquire);
+        }
+
+        /**
+         * @return produce_result
+         */
+        auto await_resume() noexcept -> ring_buffer_result::produce
+        {
+            // Woken up by the consumer, there is now space available or the channel was shutdown.
+            if (m_result == try_result::would_suspend)
+            {
+                m_result = m_channel.try_produce_impl(m_e);
+            }
+
+            return m_result == try_result::completed ? ring_buffer_result::produce::produced
+                                                     : ring_buffer_result::produce::stopped;
+        }
+
+    private:
+        template<typename element_subtype, std::size_t num_elements_subtype>
+        friend class spsc_channel;
+
+        /// The channel the element is being produced into.
+        spsc_channel<element, num_elements>& m_channel;
+        /// The element this produce operation is producing into the channel.
+        std::optional<element> m_e{std::nullopt};
+        /// The coroutine to resume when the element can be produced.
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        /// The result of the last produce attempt.
+        try_result m_result{try_result::would_suspend};
+    };
+
+    struct consume_operation
+    {
+        explicit consume_operation(spsc_channel<element, num_elements>& channel) : m_channel(channel) {}
+
+        auto await_ready() noexcept -> bool
+        {
+            m_result = m_channel.try_consume_impl(m_e);
+            return m_result != try_result::would_suspend;
+        }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            m_awaiting_coroutine = awaiting_coroutine;
+            m_channel.m_consumer_waiter.store(this, std::memory_order::seq_cst);
+            detail::asymmetric_fence_heavy();
+
+            // The producer could have produced an element (or the channel was shutdown) while registering,
+            // this check must not modify any state since the producer is allowed to resume this coroutine
+            // as soon as it has been published.
+            if (!m_channel.can_consume())
+            {
+                return true;
+            }
+
+            // If the waiter can't be retracted the producer is already resuming this coroutine.
+            consume_operation* expected = this;
+            return !m_channel.m_consumer_waiter.compare_exchange_strong(
+                expected, nullptr, std::memory_order::acq_rel, std::memory_order::acquire);
+        }
+
+        /**
+         * @return The consumed element or ring_buffer_result::consume::stopped if the channel has been
+         *         shutdown and all of its elements have been consumed.
+         */
+        auto await_resume() -> expected<element, ring_buffer_result::consume>
+        {
+            // Woken up by the producer, there is now an element available or the channel was shutdown.
+            if (m_result == try_result::would_suspend)
+            {
+                m_result = m_channel.try_consume_impl(m_e);
+            }
+
+            if (m_result == try_result::completed)
+            {
+                return expected<element, ring_buffer_result::consume>(std::move(m_e).value());
+            }
+            return unexpected<ring_buffer_result::consume>(ring_buffer_result::consume::stopped);
+        }
+
+    private:
+        template<typename element_subtype, std::size_t num_elements_subtype>
+        friend class spsc_channel;
+
+        /// The channel to consume an element from.
+        spsc_channel<element, num_elements>& m_channel;
+        /// The element this consume operation will consume.
+        std::optional<element> m_e{std::nullopt};
+        /// The coroutine to resume when an element can be consumed.
+        std::coroutine_handle<> m_awaiting_coroutine{nullptr};
+        /// The result of the last consume attempt.
+        try_result m_result{try_result::would_suspend};
+    };
+
+    spsc_channel() = default;
+
+    ~spsc_channel()
+    {
+        // Wake up anyone still using the channel.
+        shutdown();
+    }
+
+    spsc_channel(const spsc_channel<element, num_elements>&) = delete;
+    spsc_channel(spsc_channel<element, num_elements>&&)      = delete;
+
+    auto operator=(const spsc_channel<element, num_elements>&) noexcept -> spsc_channel<element, num_elements>& = delete;
+    auto operator=(spsc_channel<element, num_elements>&&) noexcept -> spsc_channel<element, num_elements>&      = delete;
+
+    /**
+     * Produces the given element into the channel.  This operation only suspends if the channel is
+     * full, it is resumed by the consumer once a slot becomes available.  Must only be called from
+     * the single producer.
+     * @param e The element to produce.
+     */
+    [[nodiscard]] auto produce(element e) -> produce_operation { return produce_operation{*this, std::move(e)}; }
+
+    /**
+     * Consumes an element from the channel.  This operation only suspends if the channel is empty,
+     * it is resumed by the producer once an element becomes available.  Must only be called from the
+     * single consumer.
+     */
+    [[nodiscard]] auto consume() -> consume_operation { return consume_operation{*this}; }
+
+    /**
+     * Attempts to produce the element without suspending.  The element is only moved from if it
+     * was produced.
+     * @param e The element to produce.
+     * @return True if the element was produced, false if the channel is full or shutdown.
+     */
+    template<typename element_type>
+    [[nodiscard]] auto try_produce(element_type&& e) -> bool
+    {
+        return try_produce_impl(std::forward<element_type>(e)) == try_result::completed;
+    }
+
+    /**
+     * Attempts to consume an element without suspending.
+     * @return The consumed element, or std::nullopt if the channel is empty or shutdown.
+     */
+    [[nodiscard]] auto try_consume() -> std::optional<element>
+    {
+        std::optional<element> e{std::nullopt};
+        try_consume_impl(e);
+        return e;
+    }
+
+    /**
+     * @return The current number of elements contained in the channel.
+     */
+    auto size() const -> std::size_t
+    {
+        auto head = m_head.load(std::memory_order::acquire);
+        auto tail = m_tail.load(std::memory_order::acquire);
+        return tail - head;
+    }
+
+    /**
+     * @return True if the channel contains zero elements.
+     */
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    /**
+     * Shuts down the channel, the producer will be woken up with produce::stopped and no more elements
+     * can be produced.  The consumer can still consume any elements remaining in the channel, once the
+     * channel is empty it will be woken up with consume::stopped.
+     */
+    auto shutdown() -> void
+    {
+        if (m_stopped.exchange(true, std::memory_order::seq_cst))
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+
+        if (auto* producer = m_producer_waiter.exchange(nullptr, std::memory_order::acq_rel); producer != nullptr)
+        {
+            producer->m_awaiting_coroutine.resume();
+        }
+
+        if (auto* consumer = m_consumer_waiter.exchange(nullptr, std::memory_order::acq_rel); consumer != nullptr)
+        {
+            consumer->m_awaiting_coroutine.resume();
+        }
+    }
+
+    /**
+     * @return True if shutdown() has been called on this coro::spsc_channel.
+     */
+    [[nodiscard]] auto is_shutdown() const -> bool { return m_stopped.load(std::memory_order::acquire); }
+
+private:
+    friend produce_operation;
+    friend consume_operation;
+
+    auto can_produce() const -> bool
+    {
+        return m_stopped.load(std::memory_order::acquire) ||
+               m_tail.load(std::memory_order::relaxed) - m_head.load(std::memory_order::acquire) != num_elements;
+    }
+
+    auto can_consume() const -> bool
+    {
+        return m_stopped.load(std::memory_order::acquire) ||
+               m_head.load(std::memory_order::relaxed) != m_tail.load(std::memory_order::acquire);
+    }
+
+    template<typename element_type>
+    auto try_produce_impl(element_type&& e) -> try_result
+    {
+        if (m_stopped.load(std::memory_order::acquire))
+        {
+            return try_result::stopped;
+        }
+
+        auto tail = m_tail.load(std::memory_order::relaxed);
+        if (tail - m_head_cache == num_elements)
+        {
+            m_head_cache = m_head.load(std::memory_order::acquire);
+            if (tail - m_head_cache == num_elements)
+            {
+                return try_result::would_suspend;
+            }
+        }
+
+        if constexpr (std::is_same_v<std::remove_cvref_t<element_type>, std::optional<element>>)
+        {
+            m_elements[tail % num_elements].emplace(std::move(e).value());
+        }
+        else
+        {
+            m_elements[tail % num_elements].emplace(std::forward<element_type>(e));
+        }
+        m_tail.store(tail + 1, std::memory_order::release);
+
+        wake(m_consumer_waiter);
+        return try_result::completed;
+    }
+
+    auto try_consume_impl(std::optional<element>& e) -> try_result
+    {
+        auto head = m_head.load(std::memory_order::relaxed);
+        if (head == m_tail_cache)
+        {
+            m_tail_cache = m_tail.load(std::memory_order::acquire);
+            if (head == m_tail_cache)
+            {
+                // Elements produced prior to the shutdown are still consumable.
+                if (m_stopped.load(std::memory_order::acquire))
+                {
+                    m_tail_cache = m_tail.load(std::memory_order::acquire);
+                    if (head == m_tail_cache)
+                    {
+                        return try_result::stopped;
+                    }
+                }
+                else
+                {
+                    return try_result::would_suspend;
+                }
+            }
+        }
+
+        auto& slot = m_elements[head % num_elements];
+        e.emplace(std::move(slot).value());
+        slot = std::nullopt;
+        m_head.store(head + 1, std::memory_order::release);
+
+        wake(m_producer_waiter);
+        return try_result::completed;
+    }
+
+    template<typename operation_type>
+    auto wake(std::atomic<operation_type*>& waiter) -> void
+    {
+        // Pairs with the heavy fence in the operation's await_suspend() so a waiter registering concurrently
+        // either sees the new index or is seen here, the cost of the handshake is paid by the side suspending.
+        detail::asymmetric_fence_light();
+        if (waiter.load(std::memory_order::relaxed) != nullptr)
+        {
+            if (auto* op = waiter.exchange(nullptr, std::memory_order::acq_rel); op != nullptr)
+            {
+                op->m_awaiting_coroutine.resume();
+            }
+        }
+    }
+
+    /// The consumer's index of the next element to consume, only written by the consumer.
+    alignas(cache_line_size) std::atomic<std::size_t> m_head{0};
+    /// The consumer's cached copy of m_tail to avoid touching the producer's cache line.
+    std::size_t m_tail_cache{0};
+
+    /// The producer's index of the next slot to produce into, only written by the producer.
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail{0};
+    /// The producer's cached copy of m_head to avoid touching the consumer's cache line.
+    std::size_t m_head_cache{0};
+
+    /// The consumer waiting for an element to be produced.  On its own line since it is only written when the
+    /// consumer suspends, the producer's check stays a read of a shared line.
+    alignas(cache_line_size) std::atomic<consume_operation*> m_consumer_waiter{nullptr};
+
+    /// The producer waiting for a slot to become available, only written when the producer suspends.
+    alignas(cache_line_size) std::atomic<produce_operation*> m_producer_waiter{nullptr};
+
+    /// Has the channel been shutdown?
+    alignas(cache_line_size) std::atomic<bool> m_stopped{false};
+
+    /// The element slots.
+    alignas(cache_line_size) std::array<std::optional<element>, num_elements> m_elements{};
+};
+
+} // namespace coro
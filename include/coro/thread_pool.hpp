@@ -178,7 +178,18 @@ public:
     template<coro::concepts::sized_range_of<std::coroutine_handle<>> range_type>
     auto resume(const range_type& handles) noexcept -> std::size_t
     {
+        if (std::size(handles) == 0)
+        {
+            return 0;
+        }
+
+        // Count the batch before checking for shutdown so shutdown() cannot drain past it, see resume(handle).
         m_size.fetch_add(std::size(handles), std::memory_order::release);
+        if (m_shutdown_requested.load(std::memory_order::acquire))
+        {
+            m_size.fetch_sub(std::size(handles), std::memory_order::release);
+            return 0;
+        }
 
         std::size_t null_handles{0};
 
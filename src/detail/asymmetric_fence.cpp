@@ -0,0 +1,46 @@
+#include "coro/detail/asymmetric_fence.hpp"
+
+#if defined(__linux__)
+    #include <linux/membarrier.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace coro::detail
+{
+std::atomic<bool> asymmetric_fence_expedited{false};
+
+#if defined(__linux__)
+namespace
+{
+auto membarrier(int cmd) noexcept -> bool
+{
+    return ::syscall(__NR_membarrier, cmd, 0, 0) == 0;
+}
+
+auto register_expedited() noexcept -> bool
+{
+    // The light fences only drop to a compiler barrier once every heavy fence is a process wide barrier.
+    if (!membarrier(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED))
+    {
+        return false;
+    }
+    asymmetric_fence_expedited.store(true, std::memory_order::relaxed);
+    return true;
+}
+} // namespace
+#endif
+
+auto asymmetric_fence_heavy() noexcept -> void
+{
+#if defined(__linux__)
+    static const bool expedited = register_expedited();
+    if (expedited && membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED))
+    {
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+}
+
+} // namespace coro::detail
@@ -0,0 +1,127 @@
+#include "coro/detail/event_fd.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <sys/eventfd.h>
+#endif
+
+namespace coro::detail
+{
+#if defined(__linux__)
+
+event_fd_t::event_fd_t() : m_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (m_fd == -1)
+    {
+        const std::string msg = "Failed to create eventfd, errno=[" + std::string{std::strerror(errno)} + "]";
+        throw std::runtime_error(msg);
+    }
+}
+
+event_fd_t::~event_fd_t()
+{
+    close();
+}
+
+auto event_fd_t::read_fd() const -> fd_t
+{
+    return m_fd;
+}
+
+auto event_fd_t::notify() noexcept -> void
+{
+    // The kernel adds the value to the eventfd's counter, so concurrent rings never fill it up like a pipe.
+    const std::uint64_t value{1};
+    ::write(m_fd, &value, sizeof(value));
+}
+
+auto event_fd_t::drain() noexcept -> void
+{
+    // A single read returns and resets the counter, it fails with EAGAIN if the doorbell was not rung.
+    std::uint64_t value{0};
+    if (::read(m_fd, &value, sizeof(value)) == -1 && errno != EAGAIN)
+    {
+        // Not much we can do here, we're in a very bad state, lets report to stderr.
+        std::cerr << "::read(eventfd) error[" << errno << "] " << ::strerror(errno) << " fd=[" << m_fd << "]"
+                  << std::endl;
+    }
+}
+
+auto event_fd_t::close() -> void
+{
+    if (m_fd != -1)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+#else
+
+event_fd_t::event_fd_t() = default;
+
+event_fd_t::~event_fd_t()
+{
+    close();
+}
+
+auto event_fd_t::read_fd() const -> fd_t
+{
+    return m_pipe.read_fd();
+}
+
+auto event_fd_t::notify() noexcept -> void
+{
+    const int value{1};
+    ::write(m_pipe.write_fd(), reinterpret_cast<const void*>(&value), sizeof(value));
+}
+
+auto event_fd_t::drain() noexcept -> void
+{
+    // Clear the notification by reading until the pipe is cleared.
+    while (true)
+    {
+        constexpr std::size_t       READ_COUNT{4};
+        constexpr ssize_t           READ_COUNT_BYTES = READ_COUNT * sizeof(int);
+        std::array<int, READ_COUNT> control{};
+        const ssize_t result = ::read(m_pipe.read_fd(), reinterpret_cast<void*>(control.data()), READ_COUNT_BYTES);
+        if (result == READ_COUNT_BYTES)
+        {
+            continue;
+        }
+
+        // If we got nothing, or we got a partial read break the loop since the pipe is empty.
+        if (result >= 0)
+        {
+            break;
+        }
+
+        // pipe is set to O_NONBLOCK so ignore empty blocking reads.
+        if (errno == EAGAIN)
+        {
+            break;
+        }
+
+        // Not much we can do here, we're in a very bad state, lets report to stderr.
+        std::cerr << "::read(m_pipe.read_fd()) error[" << errno << "] " << ::strerror(errno) << " fd=["
+                  << m_pipe.read_fd() << "]" << std::endl;
+        break;
+    }
+}
+
+auto event_fd_t::close() -> void
+{
+    m_pipe.close();
+}
+
+#endif
+
+} // namespace coro::detail
@@ -0,0 +1,119 @@
+#include "coro/detail/fd_registration.hpp"
+
+namespace coro::detail
+{
+namespace
+{
+/// The readiness that completes a poll for reading, a closed or failed file descriptor must be read to find out.
+constexpr std::uint8_t read_mask =
+    fd_registration::readable | fd_registration::read_closed | fd_registration::closed | fd_registration::error;
+/// The readiness that completes a poll for writing.
+constexpr std::uint8_t write_mask = fd_registration::writable | fd_registration::closed | fd_registration::error;
+} // namespace
+
+auto fd_registration::wait(poll_info& pi) -> bool
+{
+    std::scoped_lock lk{m_mutex};
+    if (ready_for_locked(pi))
+    {
+        pi.m_poll_status = complete_locked(pi);
+        return false;
+    }
+
+    auto reader = poll_op_readable(pi.m_op);
+    auto writer = poll_op_writeable(pi.m_op);
+    if ((reader && m_reader != nullptr) || (writer && m_writer != nullptr))
+    {
+        pi.m_poll_status = poll_status::error;
+        return false;
+    }
+
+    if (reader)
+    {
+        m_reader = &pi;
+    }
+    if (writer)
+    {
+        m_writer = &pi;
+    }
+    return true;
+}
+
+auto fd_registration::cancel(poll_info& pi) -> void
+{
+    std::scoped_lock lk{m_mutex};
+    if (m_reader == &pi)
+    {
+        m_reader = nullptr;
+    }
+    if (m_writer == &pi)
+    {
+        m_writer = nullptr;
+    }
+}
+
+auto fd_registration::clear(coro::poll_op op) -> void
+{
+    std::scoped_lock lk{m_mutex};
+    if (poll_op_readable(op) && m_read_tick == m_tick)
+    {
+        m_ready &= static_cast<std::uint8_t>(~readable);
+    }
+    if (poll_op_writeable(op) && m_write_tick == m_tick)
+    {
+        m_ready &= static_cast<std::uint8_t>(~writable);
+    }
+}
+
+auto fd_registration::notify(std::uint8_t ready, std::vector<std::pair<poll_info*, coro::poll_status>>& ready_events)
+    -> void
+{
+    std::scoped_lock lk{m_mutex};
+    m_ready |= ready;
+    ++m_tick;
+
+    for (auto* pi : {m_reader, m_writer})
+    {
+        // A read_write poll sits in both slots, complete_locked() empties both so it is only woken once.
+        if (pi != nullptr && (m_reader == pi || m_writer == pi) && ready_for_locked(*pi))
+        {
+            ready_events.emplace_back(pi, complete_locked(*pi));
+        }
+    }
+}
+
+auto fd_registration::ready_for_locked(const poll_info& pi) const noexcept -> bool
+{
+    return (poll_op_readable(pi.m_op) && (m_ready & read_mask)) ||
+           (poll_op_writeable(pi.m_op) && (m_ready & write_mask));
+}
+
+auto fd_registration::complete_locked(poll_info& pi) noexcept -> coro::poll_status
+{
+    auto reader = poll_op_readable(pi.m_op);
+    auto writer = poll_op_writeable(pi.m_op);
+    if (reader)
+    {
+        m_read_tick = m_tick;
+        if (m_reader == &pi)
+        {
+            m_reader = nullptr;
+        }
+    }
+    if (writer)
+    {
+        m_write_tick = m_tick;
+        if (m_writer == &pi)
+        {
+            m_writer = nullptr;
+        }
+    }
+
+    if ((reader && (m_ready & readable)) || (writer && (m_ready & writable)))
+    {
+        return poll_status::event;
+    }
+    return (m_ready & error) ? poll_status::error : poll_status::closed;
+}
+
+} // namespace coro::detail
@@ -13,8 +13,13 @@ using namespace std::chrono_literals;
 namespace coro::detail
 {
 
-io_notifier_epoll::io_notifier_epoll() : m_fd{::epoll_create1(EPOLL_CLOEXEC)}
+io_notifier_epoll::io_notifier_epoll(backend_t preferred)
+    : m_fd{::epoll_create1(EPOLL_CLOEXEC)},
+      m_events(default_event_batch_size),
+      m_max_event_batch_size(default_event_batch_size)
 {
+    // There is no other backend to choose.
+    (void)preferred;
 }
 
 io_notifier_epoll::~io_notifier_epoll()
@@ -69,15 +74,125 @@ auto io_notifier_epoll::watch(fd_t fd, coro::poll_op op, void* data, bool keep)
 
 auto io_notifier_epoll::watch(detail::poll_info& pi) -> bool
 {
-    auto event_data     = event_t{};
-    event_data.events   = static_cast<uint32_t>(pi.m_op) | EPOLLONESHOT | EPOLLRDHUP | EPOLLHUP;
-    event_data.data.ptr = static_cast<void*>(&pi);
-    return ::epoll_ctl(m_fd, EPOLL_CTL_ADD, pi.m_fd, &event_data) != -1;
+    auto reader = poll_op_readable(pi.m_op);
+    auto writer = poll_op_writeable(pi.m_op);
+    auto fd     = static_cast<std::size_t>(pi.m_fd);
+
+    std::scoped_lock lk{m_polled_mutex};
+    if (m_polled.size() <= fd)
+    {
+        m_polled.resize(fd + 1);
+    }
+
+    auto& polled = m_polled[fd];
+    if ((reader && polled.m_reader != nullptr) || (writer && polled.m_writer != nullptr))
+    {
+        return false;
+    }
+
+    // The first waiter adds the file descriptor, a waiter in the other direction merges its interest into it.
+    auto add      = polled.m_reader == nullptr && polled.m_writer == nullptr;
+    auto previous = polled;
+    if (reader)
+    {
+        polled.m_reader = &pi;
+    }
+    if (writer)
+    {
+        polled.m_writer = &pi;
+    }
+
+    if (!arm_polled_locked(pi.m_fd, polled, add))
+    {
+        polled = previous;
+        return false;
+    }
+    return true;
 }
 
 auto io_notifier_epoll::unwatch(detail::poll_info& pi) -> bool
 {
-    return ::epoll_ctl(m_fd, EPOLL_CTL_DEL, pi.m_fd, nullptr) != -1;
+    auto fd = static_cast<std::size_t>(pi.m_fd);
+
+    std::scoped_lock lk{m_polled_mutex};
+    if (fd >= m_polled.size())
+    {
+        return true;
+    }
+
+    auto& polled  = m_polled[fd];
+    auto  removed = false;
+    if (polled.m_reader == &pi)
+    {
+        polled.m_reader = nullptr;
+        removed         = true;
+    }
+    if (polled.m_writer == &pi)
+    {
+        polled.m_writer = nullptr;
+        removed         = true;
+    }
+
+    // Once the event was reported next_events() already removed the poll info and re-armed the file descriptor.
+    return !removed || arm_polled_locked(pi.m_fd, polled, false);
+}
+
+auto io_notifier_epoll::arm_polled_locked(fd_t fd, const polled_fd& polled, bool add) -> bool
+{
+    if (polled.m_reader == nullptr && polled.m_writer == nullptr)
+    {
+        return ::epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, nullptr) != -1;
+    }
+
+    auto event_data     = event_t{};
+    event_data.events   = EPOLLONESHOT | EPOLLRDHUP | EPOLLHUP;
+    event_data.data.u64 = (static_cast<std::uint64_t>(fd) << m_tag_bits) | m_polled_tag;
+    if (polled.m_reader != nullptr)
+    {
+        event_data.events |= static_cast<uint32_t>(polled.m_reader->m_op);
+    }
+    if (polled.m_writer != nullptr)
+    {
+        event_data.events |= static_cast<uint32_t>(polled.m_writer->m_op);
+    }
+    return ::epoll_ctl(m_fd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event_data) != -1;
+}
+
+auto io_notifier_epoll::watch(detail::fd_registration& registration) -> bool
+{
+    auto fd = static_cast<std::size_t>(registration.m_fd);
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        if (m_registered.size() <= fd)
+        {
+            m_registered.resize(fd + 1, nullptr);
+        }
+        m_registered[fd] = &registration;
+    }
+
+    auto event_data     = event_t{};
+    event_data.events   = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event_data.data.u64 = (static_cast<std::uint64_t>(fd) << m_tag_bits) | m_registered_tag;
+    if (::epoll_ctl(m_fd, EPOLL_CTL_ADD, registration.m_fd, &event_data) == -1)
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        m_registered[fd] = nullptr;
+        return false;
+    }
+    return true;
+}
+
+auto io_notifier_epoll::unwatch(detail::fd_registration& registration) -> bool
+{
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        auto             fd = static_cast<std::size_t>(registration.m_fd);
+        if (fd < m_registered.size() && m_registered[fd] == &registration)
+        {
+            m_registered[fd] = nullptr;
+        }
+    }
+    return ::epoll_ctl(m_fd, EPOLL_CTL_DEL, registration.m_fd, nullptr) != -1;
 }
 
 auto io_notifier_epoll::unwatch_timer(const detail::timer_handle& timer) -> bool
@@ -89,18 +204,77 @@ auto io_notifier_epoll::unwatch_timer(const detail::timer_handle& timer) -> bool
     return ::timerfd_settime(timer.get_fd(), 0, &ts, nullptr) != -1;
 }
 
+auto io_notifier_epoll::resize_event_batch(std::size_t size, std::size_t max_size) -> void
+{
+    m_events.resize(std::max(size, std::size_t{1}));
+    m_max_event_batch_size = std::max(max_size, m_events.size());
+}
+
 auto io_notifier_epoll::next_events(
     std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
     -> void
 {
-    auto ready_set = std::array<event_t, m_max_events>{};
-    int  num_ready = ::epoll_wait(m_fd, ready_set.data(), ready_set.size(), timeout.count());
+    auto& ready_set = m_events;
+    int   num_ready = ::epoll_wait(m_fd, ready_set.data(), static_cast<int>(ready_set.size()), timeout.count());
     for (int i = 0; i < num_ready; ++i)
     {
+        auto tag = ready_set[i].data.u64 & m_tag_mask;
+        auto fd  = static_cast<std::size_t>(ready_set[i].data.u64 >> m_tag_bits);
+        if (tag == m_polled_tag)
+        {
+            // Wake the polls the event satisfies, the others stay armed.  The polls may have timed out since.
+            std::scoped_lock lk{m_polled_mutex};
+            if (fd < m_polled.size())
+            {
+                auto& polled = m_polled[fd];
+                auto  woken  = false;
+                for (auto* pi : {polled.m_reader, polled.m_writer})
+                {
+                    // A read_write poll sits in both slots, it is only woken once.
+                    if (pi == nullptr || (polled.m_reader != pi && polled.m_writer != pi))
+                    {
+                        continue;
+                    }
+
+                    auto status = event_to_poll_status(ready_set[i], pi->m_op);
+                    if (status.has_value())
+                    {
+                        ready_events.emplace_back(pi, status.value());
+                        polled.m_reader = (polled.m_reader == pi) ? nullptr : polled.m_reader;
+                        polled.m_writer = (polled.m_writer == pi) ? nullptr : polled.m_writer;
+                        woken           = true;
+                    }
+                }
+
+                // The event disarmed the file descriptor, re-arm it for a poll still waiting or remove it.
+                if (woken || polled.m_reader != nullptr || polled.m_writer != nullptr)
+                {
+                    arm_polled_locked(static_cast<fd_t>(fd), polled, false);
+                }
+            }
+            continue;
+        }
+        if (tag == m_registered_tag)
+        {
+            // Registered file descriptors wake their waiters, the file descriptor may have been unwatched since.
+            std::scoped_lock lk{m_registered_mutex};
+            if (fd < m_registered.size() && m_registered[fd] != nullptr)
+            {
+                m_registered[fd]->notify(events_to_readiness(ready_set[i].events), ready_events);
+            }
+            continue;
+        }
+
         ready_events.emplace_back(
             static_cast<detail::poll_info*>(ready_set[i].data.ptr),
             io_notifier_epoll::event_to_poll_status(ready_set[i]));
     }
+
+    // A full batch likely left events behind, grow the batch so the next wait can take them all at once.
+    if (static_cast<std::size_t>(num_ready) == ready_set.size() && ready_set.size() < m_max_event_batch_size)
+    {
+        ready_set.resize(std::min(ready_set.size() * 2, m_max_event_batch_size));
+    }
 }
 
 auto io_notifier_epoll::event_to_poll_status(const event_t& event) -> poll_status
@@ -120,4 +294,49 @@ auto io_notifier_epoll::event_to_poll_status(const event_t& event) -> poll_statu
     throw std::runtime_error{"invalid epoll state"};
 }
 
+auto io_notifier_epoll::event_to_poll_status(const event_t& event, coro::poll_op op) -> std::optional<poll_status>
+{
+    if (event.events & static_cast<uint32_t>(op))
+    {
+        return poll_status::event;
+    }
+    else if (event.events & EPOLLERR)
+    {
+        return poll_status::error;
+    }
+    else if (event.events & EPOLLHUP || (poll_op_readable(op) && event.events & EPOLLRDHUP))
+    {
+        // The peer only shutting down its write side closes the read direction, a writer can still write.
+        return poll_status::closed;
+    }
+    // The event only concerns the other direction.
+    return std::nullopt;
+}
+
+auto io_notifier_epoll::events_to_readiness(std::uint32_t events) -> std::uint8_t
+{
+    std::uint8_t ready{0};
+    if (events & EPOLLIN)
+    {
+        ready |= detail::fd_registration::readable;
+    }
+    if (events & EPOLLOUT)
+    {
+        ready |= detail::fd_registration::writable;
+    }
+    if (events & EPOLLRDHUP)
+    {
+        ready |= detail::fd_registration::read_closed;
+    }
+    if (events & EPOLLHUP)
+    {
+        ready |= detail::fd_registration::closed;
+    }
+    if (events & EPOLLERR)
+    {
+        ready |= detail::fd_registration::error;
+    }
+    return ready;
+}
+
 } // namespace coro::detail
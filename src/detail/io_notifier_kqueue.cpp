@@ -13,8 +13,13 @@ using namespace std::chrono_literals;
 namespace coro::detail
 {
 
-io_notifier_kqueue::io_notifier_kqueue() : m_fd{::kqueue()}
+io_notifier_kqueue::io_notifier_kqueue(backend_t preferred)
+    : m_fd{::kqueue()},
+      m_events(default_event_batch_size),
+      m_max_event_batch_size(default_event_batch_size)
 {
+    // There is no other backend to choose.
+    (void)preferred;
 }
 
 io_notifier_kqueue::~io_notifier_kqueue()
@@ -132,6 +137,49 @@ auto io_notifier_kqueue::unwatch(detail::poll_info& pi) -> bool
     }
 }
 
+auto io_notifier_kqueue::watch(detail::fd_registration& registration) -> bool
+{
+    auto fd = static_cast<std::size_t>(registration.m_fd);
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        if (m_registered.size() <= fd)
+        {
+            m_registered.resize(fd + 1, nullptr);
+        }
+        m_registered[fd] = &registration;
+    }
+
+    // Both filters are edge triggered, readiness is latched by the registration until the operation would block.
+    std::array<event_t, 2> event_data{};
+    auto*                  tag = reinterpret_cast<void*>(m_registered_tag);
+    EV_SET(&event_data[0], registration.m_fd, EVFILT_READ, EV_ADD | EV_ENABLE | EV_CLEAR, 0, 0, tag);
+    EV_SET(&event_data[1], registration.m_fd, EVFILT_WRITE, EV_ADD | EV_ENABLE | EV_CLEAR, 0, 0, tag);
+    if (::kevent(m_fd, event_data.data(), event_data.size(), nullptr, 0, nullptr) == -1)
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        m_registered[fd] = nullptr;
+        return false;
+    }
+    return true;
+}
+
+auto io_notifier_kqueue::unwatch(detail::fd_registration& registration) -> bool
+{
+    {
+        std::scoped_lock lk{m_registered_mutex};
+        auto             fd = static_cast<std::size_t>(registration.m_fd);
+        if (fd < m_registered.size() && m_registered[fd] == &registration)
+        {
+            m_registered[fd] = nullptr;
+        }
+    }
+
+    std::array<event_t, 2> event_data{};
+    EV_SET(&event_data[0], registration.m_fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    EV_SET(&event_data[1], registration.m_fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+    return ::kevent(m_fd, event_data.data(), event_data.size(), nullptr, 0, nullptr) != -1;
+}
+
 auto io_notifier_kqueue::unwatch_timer(const detail::timer_handle& timer) -> bool
 {
     auto event_data = event_t{};
@@ -139,24 +187,67 @@ auto io_notifier_kqueue::unwatch_timer(const detail::timer_handle& timer) -> boo
     return ::kevent(m_fd, &event_data, 1, nullptr, 0, nullptr) != -1;
 }
 
+auto io_notifier_kqueue::resize_event_batch(std::size_t size, std::size_t max_size) -> void
+{
+    m_events.resize(std::max(size, std::size_t{1}));
+    m_max_event_batch_size = std::max(max_size, m_events.size());
+}
+
 auto io_notifier_kqueue::next_events(
     std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
     -> void
 {
-    auto       ready_set       = std::array<event_t, m_max_events>{};
+    auto&      ready_set       = m_events;
     const auto timeout_as_secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
     auto       timeout_spec    = ::timespec{
                  .tv_sec  = timeout_as_secs.count(),
                  .tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - timeout_as_secs).count(),
     };
-    const std::size_t num_ready = ::kevent(
-        m_fd, nullptr, 0, ready_set.data(), std::min(ready_set.size(), ready_events.capacity()), &timeout_spec);
+    const std::size_t num_ready =
+        ::kevent(m_fd, nullptr, 0, ready_set.data(), static_cast<int>(ready_set.size()), &timeout_spec);
     for (std::size_t i = 0; i < num_ready; i++)
     {
+        if (reinterpret_cast<std::uintptr_t>(ready_set[i].udata) == m_registered_tag)
+        {
+            // Registered file descriptors wake their waiters, the file descriptor may have been unwatched since.
+            std::uint8_t ready{0};
+            if (ready_set[i].flags & EV_ERROR)
+            {
+                ready |= detail::fd_registration::error;
+            }
+            else if (ready_set[i].filter == EVFILT_READ)
+            {
+                ready |= detail::fd_registration::readable;
+                if (ready_set[i].flags & EV_EOF)
+                {
+                    ready |= detail::fd_registration::read_closed;
+                }
+            }
+            else if (ready_set[i].filter == EVFILT_WRITE)
+            {
+                ready |= (ready_set[i].flags & EV_EOF) ? detail::fd_registration::closed
+                                                        : detail::fd_registration::writable;
+            }
+
+            auto             fd = static_cast<std::size_t>(ready_set[i].ident);
+            std::scoped_lock lk{m_registered_mutex};
+            if (fd < m_registered.size() && m_registered[fd] != nullptr)
+            {
+                m_registered[fd]->notify(ready, ready_events);
+            }
+            continue;
+        }
+
         ready_events.emplace_back(
             static_cast<detail::poll_info*>(ready_set[i].udata),
             io_notifier_kqueue::event_to_poll_status(ready_set[i]));
     }
+
+    // A full batch likely left events behind, grow the batch so the next wait can take them all at once.
+    if (num_ready == ready_set.size() && ready_set.size() < m_max_event_batch_size)
+    {
+        ready_set.resize(std::min(ready_set.size() * 2, m_max_event_batch_size));
+    }
 }
 
 auto io_notifier_kqueue::event_to_poll_status(const event_t& event) -> poll_status
@@ -0,0 +1,925 @@
+#include "coro/detail/io_notifier_uring.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "coro/detail/timer_handle.hpp"
+
+using namespace std::chrono_literals;
+
+namespace coro::detail
+{
+namespace
+{
+/// The number of submission queue entries, the completion queue is sized larger since polls are long lived.
+constexpr unsigned submission_entries{256};
+constexpr unsigned completion_entries{submission_entries * 4};
+
+auto io_uring_setup(unsigned entries, io_uring_params& params) -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+auto io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+auto io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg, std::size_t arg_size)
+    -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+auto load_acquire(unsigned* value) -> unsigned
+{
+    return std::atomic_ref<unsigned>{*value}.load(std::memory_order::acquire);
+}
+
+auto store_release(unsigned* ptr, unsigned value) -> void
+{
+    std::atomic_ref<unsigned>{*ptr}.store(value, std::memory_order::release);
+}
+
+auto to_poll32_events(std::uint32_t events) -> std::uint32_t
+{
+    // The kernel reads poll32_events as two swapped 16 bit halves on big endian machines.
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        events = (events << 16) | (events >> 16);
+    }
+    return events;
+}
+
+auto to_timespec(std::chrono::nanoseconds duration, __kernel_timespec& ts) -> void
+{
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+    duration -= seconds;
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+
+    // Same safeguard as timerfd, a zero or negative timeout fires as soon as possible.
+    if (seconds <= 0s)
+    {
+        seconds = 0s;
+        if (nanoseconds <= 0ns)
+        {
+            nanoseconds = 1ns;
+        }
+    }
+
+    ts.tv_sec  = seconds.count();
+    ts.tv_nsec = nanoseconds.count();
+}
+
+} // namespace
+
+io_notifier_uring::io_notifier_uring(backend_t preferred)
+{
+    if (preferred != backend_t::io_uring || !setup())
+    {
+        teardown();
+        m_epoll = std::make_unique<io_notifier_epoll>();
+    }
+}
+
+io_notifier_uring::~io_notifier_uring()
+{
+    teardown();
+}
+
+auto io_notifier_uring::setup() -> bool
+{
+    io_uring_params params{};
+    params.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = completion_entries;
+
+    m_fd = io_uring_setup(submission_entries, params);
+    if (m_fd == -1)
+    {
+        // ENOSYS or EPERM if io_uring is not built into the kernel or is disabled.
+        return false;
+    }
+
+    // Completions must never be dropped, waits need a timeout argument and multishot polls must be
+    // supported, the latter has no feature flag but was released alongside resource tags.
+    constexpr std::uint32_t required_features = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+    if ((params.features & required_features) != required_features)
+    {
+        return false;
+    }
+
+    m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_sq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        m_cq_ring_size = 0;
+    }
+
+    m_sq_ring =
+        ::mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (m_sq_ring == MAP_FAILED)
+    {
+        m_sq_ring = nullptr;
+        return false;
+    }
+
+    if (m_cq_ring_size == 0)
+    {
+        m_cq_ring = m_sq_ring;
+    }
+    else
+    {
+        m_cq_ring = ::mmap(
+            nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if (m_cq_ring == MAP_FAILED)
+        {
+            m_cq_ring = nullptr;
+            return false;
+        }
+    }
+
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    auto* sqes =
+        ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        return false;
+    }
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq      = static_cast<char*>(m_sq_ring);
+    m_sq_head     = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sq_tail_ptr = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sq_mask     = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sq_entries  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    m_sq_tail     = *m_sq_tail_ptr;
+
+    // Every submission queue entry is always submitted from its own index.
+    auto* sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < m_sq_entries; ++i)
+    {
+        sq_array[i] = i;
+    }
+
+    auto* cq  = static_cast<char*>(m_cq_ring);
+    m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    m_timespecs.resize(m_sq_entries);
+    return true;
+}
+
+auto io_notifier_uring::teardown() -> void
+{
+    if (m_sqes != nullptr)
+    {
+        ::munmap(m_sqes, m_sqes_size);
+        m_sqes = nullptr;
+    }
+    if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring)
+    {
+        ::munmap(m_cq_ring, m_cq_ring_size);
+    }
+    m_cq_ring = nullptr;
+    if (m_sq_ring != nullptr)
+    {
+        ::munmap(m_sq_ring, m_sq_ring_size);
+        m_sq_ring = nullptr;
+    }
+    if (m_fd != -1)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    // Closing the ring unregistered the provided buffer rings, their memory can now be released.
+    for (auto& ring : m_buffer_rings)
+    {
+        if (ring.m_bufs != nullptr)
+        {
+            ::munmap(ring.m_bufs, ring.m_ring_size);
+        }
+    }
+    m_buffer_rings.clear();
+}
+
+auto io_notifier_uring::watch_timer(const detail::timer_handle& timer, std::chrono::nanoseconds duration) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->watch_timer(timer, duration);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    auto*            sqe = next_sqe_locked();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    // The kernel copies the timespec when the entry is submitted, it lives alongside the entry until then.
+    auto& ts = m_timespecs[m_sq_tail & m_sq_mask];
+    to_timespec(duration, ts);
+
+    if (m_timer_id != 0)
+    {
+        // Move the armed timer rather than removing it and adding a new one.  If it already fired the update
+        // fails but the timer's completion is still pending and its processing re-arms the timer.
+        sqe->opcode        = IORING_OP_TIMEOUT_REMOVE;
+        sqe->addr          = m_timer_id;
+        sqe->addr2         = reinterpret_cast<std::uint64_t>(&ts);
+        sqe->timeout_flags = IORING_TIMEOUT_UPDATE;
+        sqe->user_data     = 0;
+    }
+    else
+    {
+        m_timer_id = add_registration_locked(
+            registration::kind_t::timer, const_cast<void*>(timer.get_inner()), -1, 0);
+        sqe->opcode    = IORING_OP_TIMEOUT;
+        sqe->fd        = -1;
+        sqe->addr      = reinterpret_cast<std::uint64_t>(&ts);
+        sqe->len       = 1;
+        sqe->off       = 0;
+        sqe->user_data = m_timer_id;
+    }
+
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::watch(fd_t fd, coro::poll_op op, void* data, bool keep) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->watch(fd, op, data, keep);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    auto             events = static_cast<std::uint32_t>(op) | POLLRDHUP;
+    auto             kind   = keep ? registration::kind_t::persistent : registration::kind_t::poll;
+    auto             id     = add_registration_locked(kind, data, fd, events);
+    if (!prepare_poll_locked(id, fd, events, keep))
+    {
+        release_registration_locked(id);
+        return false;
+    }
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::watch(detail::poll_info& pi) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->watch(pi);
+    }
+
+    // Only a reader is done when the peer shuts down its write side, a writer keeps waiting for POLLOUT.
+    auto events = static_cast<std::uint32_t>(pi.m_op) | POLLHUP;
+    if (poll_op_readable(pi.m_op))
+    {
+        events |= POLLRDHUP;
+    }
+
+    std::scoped_lock lk{m_mutex};
+    auto             id = add_registration_locked(registration::kind_t::poll, &pi, pi.m_fd, events);
+    if (!prepare_poll_locked(id, pi.m_fd, events, false))
+    {
+        release_registration_locked(id);
+        return false;
+    }
+    pi.m_registration_id = id;
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::unwatch(detail::poll_info& pi) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->unwatch(pi);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    auto             id   = std::exchange(pi.m_registration_id, 0);
+    auto*            info = find_registration_locked(id);
+    if (info == nullptr || info->m_data != &pi)
+    {
+        // The poll already completed, one shot polls are removed by the kernel when they trigger.
+        return true;
+    }
+    if (info->m_kind == registration::kind_t::operation)
+    {
+        // Operations always complete, the kernel owns their buffers until then so they are never removed.
+        pi.m_registration_id = id;
+        return true;
+    }
+
+    // Discard the completion of the cancelled poll since the poll info may be gone by the time it arrives.
+    release_registration_locked(id);
+
+    if (!prepare_poll_remove_locked(id))
+    {
+        return false;
+    }
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::watch(detail::fd_registration& registration) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->watch(registration);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    std::uint32_t    events = POLLIN | POLLOUT | POLLRDHUP | EPOLLET;
+    auto             id     =
+        add_registration_locked(registration::kind_t::registered, &registration, registration.m_fd, events);
+    if (!prepare_poll_locked(id, registration.m_fd, events, true))
+    {
+        release_registration_locked(id);
+        return false;
+    }
+    registration.m_registration_id = id;
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::unwatch(detail::fd_registration& registration) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->unwatch(registration);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    auto             id = std::exchange(registration.m_registration_id, 0);
+    if (find_registration_locked(id) == nullptr)
+    {
+        return true;
+    }
+
+    // Completions still in flight are discarded once the registration is released.
+    release_registration_locked(id);
+
+    if (!prepare_poll_remove_locked(id))
+    {
+        return false;
+    }
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::unwatch_timer(const detail::timer_handle& timer) -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return m_epoll->unwatch_timer(timer);
+    }
+
+    std::scoped_lock lk{m_mutex};
+    if (m_timer_id == 0)
+    {
+        return true;
+    }
+
+    auto id = std::exchange(m_timer_id, 0);
+    release_registration_locked(id);
+
+    auto* sqe = next_sqe_locked();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+    sqe->opcode    = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = id;
+    sqe->user_data = 0;
+    publish_locked();
+    return true;
+}
+
+auto io_notifier_uring::submit(detail::poll_info& pi, const detail::io_operation& op, std::chrono::nanoseconds timeout)
+    -> bool
+{
+    if (m_epoll != nullptr)
+    {
+        return false;
+    }
+
+    std::scoped_lock lk{m_mutex};
+    const bool       linked = timeout > 0ns;
+    auto*            sqe    = next_sqe_locked(linked ? 2 : 1);
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    auto id = add_registration_locked(registration::kind_t::operation, &pi, op.m_fd, 0);
+    switch (op.m_opcode)
+    {
+        case detail::io_operation::opcode_t::recv:
+            sqe->opcode = IORING_OP_RECV;
+            sqe->addr   = reinterpret_cast<std::uint64_t>(op.m_buffer);
+            sqe->len    = static_cast<std::uint32_t>(op.m_length);
+            if (op.m_buffer_group >= 0)
+            {
+                // The kernel picks a provided buffer once data arrives, the completion reports its id.
+                sqe->flags |= IOSQE_BUFFER_SELECT;
+                sqe->buf_group = static_cast<std::uint16_t>(op.m_buffer_group);
+                sqe->addr      = 0;
+            }
+            break;
+        case detail::io_operation::opcode_t::send:
+            sqe->opcode = IORING_OP_SEND;
+            sqe->addr   = reinterpret_cast<std::uint64_t>(op.m_buffer);
+            sqe->len    = static_cast<std::uint32_t>(op.m_length);
+            break;
+        case detail::io_operation::opcode_t::accept:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->addr   = reinterpret_cast<std::uint64_t>(op.m_buffer);
+            sqe->addr2  = reinterpret_cast<std::uint64_t>(op.m_address_length);
+            break;
+        case detail::io_operation::opcode_t::connect:
+            sqe->opcode = IORING_OP_CONNECT;
+            sqe->addr   = reinterpret_cast<std::uint64_t>(op.m_buffer);
+            sqe->off    = op.m_length;
+            break;
+    }
+    sqe->fd        = op.m_fd;
+    sqe->user_data = id;
+
+    if (linked)
+    {
+        // The kernel cancels the operation if the linked timeout expires first, the timeout's own completion
+        // is discarded.
+        sqe->flags |= IOSQE_IO_LINK;
+
+        auto& ts = m_timespecs[(m_sq_tail + 1) & m_sq_mask];
+        to_timespec(timeout, ts);
+
+        auto* timeout_sqe      = &m_sqes[(m_sq_tail + 1) & m_sq_mask];
+        timeout_sqe->opcode    = IORING_OP_LINK_TIMEOUT;
+        timeout_sqe->fd        = -1;
+        timeout_sqe->addr      = reinterpret_cast<std::uint64_t>(&ts);
+        timeout_sqe->len       = 1;
+        timeout_sqe->user_data = 0;
+    }
+
+    pi.m_registration_id = id;
+    publish_locked(linked ? 2 : 1);
+    return true;
+}
+
+auto io_notifier_uring::register_buffers(void* base, std::size_t buffer_size, std::uint16_t count) -> std::int32_t
+{
+    if (m_epoll != nullptr || count == 0)
+    {
+        return -1;
+    }
+
+    std::scoped_lock lk{m_mutex};
+
+    // The ring's entries must be a power of two, only the first count entries are ever filled.
+    buffer_ring ring{};
+    const auto  entries = std::bit_ceil(static_cast<std::uint32_t>(count));
+    ring.m_ring_size    = entries * sizeof(io_uring_buf);
+    auto* memory = ::mmap(nullptr, ring.m_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    // Re-use the group of an unregistered ring before growing.
+    std::size_t group{0};
+    while (group < m_buffer_rings.size() && m_buffer_rings[group].m_bufs != nullptr)
+    {
+        ++group;
+    }
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr    = reinterpret_cast<std::uint64_t>(memory);
+    reg.ring_entries = entries;
+    reg.bgid         = static_cast<std::uint16_t>(group);
+    if (group > std::numeric_limits<std::uint16_t>::max() ||
+        io_uring_register(m_fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1)
+    {
+        // EINVAL before Linux 5.19.
+        ::munmap(memory, ring.m_ring_size);
+        return -1;
+    }
+
+    ring.m_bufs        = static_cast<io_uring_buf*>(memory);
+    ring.m_tail_ptr    = reinterpret_cast<std::uint16_t*>(static_cast<char*>(memory) + offsetof(io_uring_buf_ring, tail));
+    ring.m_mask        = static_cast<std::uint16_t>(entries - 1);
+    ring.m_base        = static_cast<char*>(base);
+    ring.m_buffer_size = buffer_size;
+    for (std::uint16_t id = 0; id < count; ++id)
+    {
+        provide_buffer_locked(ring, id);
+    }
+
+    if (group == m_buffer_rings.size())
+    {
+        m_buffer_rings.emplace_back();
+    }
+    m_buffer_rings[group] = ring;
+    return static_cast<std::int32_t>(group);
+}
+
+auto io_notifier_uring::provide_buffer(std::int32_t group, std::uint16_t id) -> void
+{
+    std::scoped_lock lk{m_mutex};
+    provide_buffer_locked(m_buffer_rings[static_cast<std::size_t>(group)], id);
+}
+
+auto io_notifier_uring::unregister_buffers(std::int32_t group) -> void
+{
+    std::scoped_lock lk{m_mutex};
+    auto&            ring = m_buffer_rings[static_cast<std::size_t>(group)];
+    if (ring.m_bufs == nullptr)
+    {
+        return;
+    }
+
+    io_uring_buf_reg reg{};
+    reg.bgid = static_cast<std::uint16_t>(group);
+    io_uring_register(m_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    ::munmap(ring.m_bufs, ring.m_ring_size);
+    ring = buffer_ring{};
+}
+
+auto io_notifier_uring::resize_event_batch(std::size_t size, std::size_t max_size) -> void
+{
+    if (m_epoll != nullptr)
+    {
+        m_epoll->resize_event_batch(size, max_size);
+    }
+}
+
+auto io_notifier_uring::next_events(
+    std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+    -> void
+{
+    if (m_epoll != nullptr)
+    {
+        m_epoll->next_events(ready_events, timeout);
+        return;
+    }
+
+    m_event_loop_thread.store(std::this_thread::get_id(), std::memory_order::relaxed);
+
+    const auto ready_before = ready_events.size();
+    const auto deadline     = std::chrono::steady_clock::now() + timeout;
+    while (true)
+    {
+        unsigned to_submit{0};
+        {
+            std::scoped_lock lk{m_mutex};
+            to_submit = pending_locked();
+        }
+
+        // Hand the pending submissions to the kernel and wait for completions in a single syscall.
+        unsigned               flags{0};
+        unsigned               min_complete{0};
+        io_uring_getevents_arg arg{};
+        __kernel_timespec      ts{};
+        const bool             completions_ready = load_acquire(m_cq_tail) != *m_cq_head;
+        if (timeout != 0ms && !completions_ready)
+        {
+            flags        = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+            min_complete = 1;
+            if (timeout > 0ms)
+            {
+                to_timespec(std::max(deadline - std::chrono::steady_clock::now(), std::chrono::nanoseconds{0}), ts);
+                arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+            }
+        }
+
+        if (to_submit > 0 || min_complete > 0)
+        {
+            auto result = (flags & IORING_ENTER_EXT_ARG)
+                              ? io_uring_enter(m_fd, to_submit, min_complete, flags, &arg, sizeof(arg))
+                              : io_uring_enter(m_fd, to_submit, 0, 0, nullptr, 0);
+            if (result == -1 && errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+            {
+                throw std::runtime_error{std::string{"io_uring_enter failed: "} + std::strerror(errno)};
+            }
+        }
+
+        reap(ready_events);
+
+        // Completions of removals are discarded, keep waiting until something is ready or the timeout expires.
+        if (ready_events.size() != ready_before || timeout == 0ms ||
+            (timeout > 0ms && std::chrono::steady_clock::now() >= deadline))
+        {
+            break;
+        }
+    }
+}
+
+auto io_notifier_uring::events_to_poll_status(std::int32_t events) -> poll_status
+{
+    if (events < 0)
+    {
+        return poll_status::error;
+    }
+    else if (events & (POLLIN | POLLOUT))
+    {
+        return poll_status::event;
+    }
+    else if (events & POLLERR)
+    {
+        return poll_status::error;
+    }
+    else if (events & (POLLRDHUP | POLLHUP))
+    {
+        return poll_status::closed;
+    }
+    return poll_status::error;
+}
+
+auto io_notifier_uring::next_sqe_locked(unsigned count) -> io_uring_sqe*
+{
+    if (m_sq_tail - load_acquire(m_sq_head) + count > m_sq_entries)
+    {
+        // The ring is full of submissions made on the event loop thread, hand them to the kernel to make room.
+        submit_locked();
+        if (m_sq_tail - load_acquire(m_sq_head) + count > m_sq_entries)
+        {
+            return nullptr;
+        }
+    }
+
+    // Linked entries must be consecutive, the caller fills them in order from the returned entry.
+    for (unsigned i = 0; i < count; ++i)
+    {
+        std::memset(&m_sqes[(m_sq_tail + i) & m_sq_mask], 0, sizeof(io_uring_sqe));
+    }
+    return &m_sqes[m_sq_tail & m_sq_mask];
+}
+
+auto io_notifier_uring::publish_locked(unsigned count) -> void
+{
+    m_sq_tail += count;
+    store_release(m_sq_tail_ptr, m_sq_tail);
+
+    // The event loop thread submits on its next wait, any other thread could be racing a blocked wait.
+    if (m_event_loop_thread.load(std::memory_order::relaxed) != std::this_thread::get_id())
+    {
+        submit_locked();
+    }
+}
+
+auto io_notifier_uring::submit_locked() -> void
+{
+    auto to_submit = pending_locked();
+    while (to_submit > 0)
+    {
+        auto result = io_uring_enter(m_fd, to_submit, 0, 0, nullptr, 0);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // EBUSY or EAGAIN, the entries stay in the ring and are submitted by the next wait.
+            break;
+        }
+        to_submit = pending_locked();
+    }
+}
+
+auto io_notifier_uring::pending_locked() const -> unsigned
+{
+    return m_sq_tail - load_acquire(m_sq_head);
+}
+
+auto io_notifier_uring::add_registration_locked(registration::kind_t kind, void* data, fd_t fd, std::uint32_t events)
+    -> std::uint64_t
+{
+    std::uint32_t index{0};
+    if (!m_free_registrations.empty())
+    {
+        index = m_free_registrations.back();
+        m_free_registrations.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(m_registrations.size());
+        m_registrations.emplace_back();
+    }
+
+    auto& info    = m_registrations[index];
+    info.m_kind   = kind;
+    info.m_data   = data;
+    info.m_fd     = fd;
+    info.m_events = events;
+    // The generation is never zero so a valid id is never zero, which marks completions to ignore.
+    return (static_cast<std::uint64_t>(info.m_generation) << 32) | index;
+}
+
+auto io_notifier_uring::find_registration_locked(std::uint64_t id) -> registration*
+{
+    auto index      = static_cast<std::uint32_t>(id);
+    auto generation = static_cast<std::uint32_t>(id >> 32);
+    if (index >= m_registrations.size())
+    {
+        return nullptr;
+    }
+
+    auto& info = m_registrations[index];
+    if (info.m_kind == registration::kind_t::free || info.m_generation != generation)
+    {
+        return nullptr;
+    }
+    return &info;
+}
+
+auto io_notifier_uring::release_registration_locked(std::uint64_t id) -> void
+{
+    auto  index = static_cast<std::uint32_t>(id);
+    auto& info  = m_registrations[index];
+    info.m_kind = registration::kind_t::free;
+    info.m_data = nullptr;
+    if (++info.m_generation == 0)
+    {
+        info.m_generation = 1;
+    }
+    m_free_registrations.emplace_back(index);
+}
+
+auto io_notifier_uring::provide_buffer_locked(buffer_ring& ring, std::uint16_t id) -> void
+{
+    // The tail overlays the first entry's reserved field, so each entry's fields are written individually.
+    auto& buf = ring.m_bufs[ring.m_tail & ring.m_mask];
+    buf.addr  = reinterpret_cast<std::uint64_t>(ring.m_base + static_cast<std::size_t>(id) * ring.m_buffer_size);
+    buf.len   = static_cast<std::uint32_t>(ring.m_buffer_size);
+    buf.bid   = id;
+    std::atomic_ref<std::uint16_t>{*ring.m_tail_ptr}.store(++ring.m_tail, std::memory_order::release);
+}
+
+auto io_notifier_uring::prepare_poll_locked(std::uint64_t id, fd_t fd, std::uint32_t events, bool multishot) -> bool
+{
+    auto* sqe = next_sqe_locked();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->poll32_events = to_poll32_events(events);
+    sqe->len           = multishot ? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data     = id;
+    return true;
+}
+
+auto io_notifier_uring::prepare_poll_remove_locked(std::uint64_t id) -> bool
+{
+    auto* sqe = next_sqe_locked();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = id;
+    sqe->user_data = 0;
+    return true;
+}
+
+auto io_notifier_uring::reap(std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events) -> void
+{
+    std::scoped_lock lk{m_mutex};
+
+    auto head = *m_cq_head;
+    auto tail = load_acquire(m_cq_tail);
+    for (; head != tail; ++head)
+    {
+        const auto& cqe = m_cqes[head & m_cq_mask];
+        if (cqe.user_data == 0)
+        {
+            // The completion of a removal or timer update.
+            continue;
+        }
+
+        auto* info = find_registration_locked(cqe.user_data);
+        if (info == nullptr)
+        {
+            // The registration was removed, this is its cancellation or it raced the removal.
+            continue;
+        }
+
+        switch (info->m_kind)
+        {
+            case registration::kind_t::poll:
+            {
+                auto* data   = info->m_data;
+                auto  events = cqe.res;
+                if (events > 0 && !(events & (info->m_events | POLLERR | POLLHUP | POLLNVAL)))
+                {
+                    // io_uring always reports POLLRDHUP, but a writer is not done when the peer only shut down its
+                    // write side.  A one shot poll would complete again right away, wait for the next wake-up with
+                    // an edge triggered multishot poll instead, its completions flagged as more are filtered here.
+                    if (!(cqe.flags & IORING_CQE_F_MORE) &&
+                        prepare_poll_locked(cqe.user_data, info->m_fd, info->m_events | EPOLLET, true))
+                    {
+                        publish_locked();
+                    }
+                    continue;
+                }
+                if (events > 0 && (events & POLLERR))
+                {
+                    // The kernel completes the poll with the waker's mask, an error wake-up can hide a hangup
+                    // that epoll would have reported, e.g. a shutdown listening socket, so ask for the full state.
+                    ::pollfd pfd{.fd = info->m_fd, .events = static_cast<short>(info->m_events), .revents = 0};
+                    if (::poll(&pfd, 1, 0) > 0)
+                    {
+                        events = pfd.revents;
+                    }
+                }
+                release_registration_locked(cqe.user_data);
+                if ((cqe.flags & IORING_CQE_F_MORE) && prepare_poll_remove_locked(cqe.user_data))
+                {
+                    // The poll was re-armed as a multishot poll above, the kernel keeps it until it is removed.
+                    publish_locked();
+                }
+                ready_events.emplace_back(static_cast<detail::poll_info*>(data), events_to_poll_status(events));
+            }
+            break;
+            case registration::kind_t::persistent:
+                if (!(cqe.flags & IORING_CQE_F_MORE))
+                {
+                    // The kernel terminated the multishot poll, e.g. the completion queue overflowed, re-arm it.
+                    if (prepare_poll_locked(cqe.user_data, info->m_fd, info->m_events, true))
+                    {
+                        publish_locked();
+                    }
+                }
+                if (cqe.res >= 0)
+                {
+                    ready_events.emplace_back(
+                        static_cast<detail::poll_info*>(info->m_data), events_to_poll_status(cqe.res));
+                }
+                break;
+            case registration::kind_t::registered:
+                if (!(cqe.flags & IORING_CQE_F_MORE))
+                {
+                    // The kernel terminated the multishot poll, re-arm it.
+                    if (prepare_poll_locked(cqe.user_data, info->m_fd, info->m_events, true))
+                    {
+                        publish_locked();
+                    }
+                }
+                if (cqe.res > 0)
+                {
+                    static_cast<detail::fd_registration*>(info->m_data)
+                        ->notify(io_notifier_epoll::events_to_readiness(cqe.res), ready_events);
+                }
+                break;
+            case registration::kind_t::timer:
+                if (cqe.res == -ETIME)
+                {
+                    auto* data = info->m_data;
+                    release_registration_locked(cqe.user_data);
+                    m_timer_id = 0;
+                    ready_events.emplace_back(static_cast<detail::poll_info*>(data), poll_status::event);
+                }
+                break;
+            case registration::kind_t::operation:
+            {
+                auto* pi = static_cast<detail::poll_info*>(info->m_data);
+                release_registration_locked(cqe.user_data);
+                pi->m_result          = cqe.res;
+                pi->m_selected_buffer = (cqe.flags & IORING_CQE_F_BUFFER)
+                                            ? static_cast<std::int32_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT)
+                                            : -1;
+                ready_events.emplace_back(pi, poll_status::event);
+            }
+            break;
+            case registration::kind_t::free:
+                break;
+        }
+    }
+
+    store_release(m_cq_head, head);
+}
+
+} // namespace coro::detail
@@ -0,0 +1,35 @@
+#include "coro/detail/io_operation.hpp"
+
+#include <cerrno>
+
+namespace coro::detail
+{
+auto io_operation::execute() const noexcept -> std::int64_t
+{
+    if (m_buffer_group >= 0)
+    {
+        // Only the kernel selects provided buffers.
+        return -ENOBUFS;
+    }
+
+    std::int64_t result{-1};
+    switch (m_opcode)
+    {
+        case opcode_t::recv:
+            result = ::recv(m_fd, m_buffer, m_length, 0);
+            break;
+        case opcode_t::send:
+            result = ::send(m_fd, m_buffer, m_length, 0);
+            break;
+        case opcode_t::accept:
+            result = ::accept(m_fd, static_cast<sockaddr*>(m_buffer), m_address_length);
+            break;
+        case opcode_t::connect:
+            result = ::connect(m_fd, static_cast<const sockaddr*>(m_buffer), static_cast<socklen_t>(m_length));
+            break;
+    }
+
+    return (result < 0) ? -static_cast<std::int64_t>(errno) : result;
+}
+
+} // namespace coro::detail
@@ -19,9 +19,18 @@ timer_handle::timer_handle(const void* timer_handle_ptr, io_notifier& notifier)
 #elif defined(__linux__)
 
 timer_handle::timer_handle(const void* timer_handle_ptr, io_notifier& notifier)
-    : m_fd(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+    : m_fd(-1),
       m_timer_handle_ptr(timer_handle_ptr)
 {
+    #if defined(LIBCORO_FEATURE_IO_URING)
+    // io_uring submits the timeouts to the ring directly, a timerfd is only needed for the epoll fallback.
+    if (notifier.backend() == io_notifier::backend_t::io_uring)
+    {
+        return;
+    }
+    #endif
+
+    m_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
     notifier.watch(m_fd, coro::poll_op::read, const_cast<void*>(m_timer_handle_ptr), true);
 }
 
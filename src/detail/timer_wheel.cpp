@@ -0,0 +1,323 @@
+#include "coro/detail/timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace coro::detail
+{
+timer_wheel::timer_wheel(time_point epoch) noexcept : m_epoch(epoch)
+{
+}
+
+auto timer_wheel::add(poll_info& pi, time_point deadline) noexcept -> void
+{
+    // Deadlines that have already passed land in the current tick and expire with the next expire() call.
+    pi.m_timer_deadline = deadline;
+    pi.m_timer_tick     = std::max(to_tick(deadline), m_current);
+    link(pi);
+    ++m_size;
+}
+
+auto timer_wheel::remove(poll_info& pi) noexcept -> bool
+{
+    if (!pi.timer_armed())
+    {
+        return false;
+    }
+
+    unlink(pi);
+    --m_size;
+    return true;
+}
+
+auto timer_wheel::expire(time_point now) noexcept -> poll_info*
+{
+    const auto now_tick = to_tick(now);
+
+    poll_info* expired{nullptr};
+    poll_info* expired_tail{nullptr};
+    auto       append = [&](poll_info* first)
+    {
+        if (first == nullptr)
+        {
+            return;
+        }
+
+        if (expired == nullptr)
+        {
+            expired = first;
+        }
+        else
+        {
+            expired_tail->m_timer_next = first;
+        }
+        for (auto* pi = first; pi != nullptr; pi = pi->m_timer_next)
+        {
+            expired_tail = pi;
+            --m_size;
+        }
+    };
+
+    // Every tick before the one now falls within has passed in full.
+    while (m_current < now_tick)
+    {
+        if (m_size == 0)
+        {
+            // Nothing can cascade out of an empty wheel, skip straight to now.
+            m_current = now_tick;
+            break;
+        }
+
+        if (auto pending = m_occupied[0] & (~std::uint64_t{0} << (m_current & slot_mask)); pending != 0)
+        {
+            auto tick = (m_current & ~slot_mask) | static_cast<std::uint64_t>(std::countr_zero(pending));
+            if (tick >= now_tick)
+            {
+                m_current = now_tick;
+                break;
+            }
+
+            // Every timer in a level 0 slot falls within exactly this tick.
+            append(take(static_cast<std::uint16_t>(tick & slot_mask)));
+
+            m_current = tick + 1;
+            if ((m_current & slot_mask) == 0)
+            {
+                cascade();
+            }
+            continue;
+        }
+
+        // Nothing is left on level 0 this turn, skip the empty turns up to the next occupied higher slot.
+        auto tick = next_cascade();
+        if (tick >= now_tick)
+        {
+            m_current = now_tick;
+            if (m_current == tick)
+            {
+                cascade();
+            }
+            break;
+        }
+
+        m_current = tick;
+        cascade();
+    }
+
+    // The timers of the current tick expire individually once their exact deadline has passed.
+    if (m_size != 0)
+    {
+        append(take_due(static_cast<std::uint16_t>(m_current & slot_mask), now));
+    }
+
+    return expired;
+}
+
+auto timer_wheel::next_expiry() const noexcept -> std::optional<time_point>
+{
+    if (m_size == 0)
+    {
+        return std::nullopt;
+    }
+
+    if (auto pending = m_occupied[0] & (~std::uint64_t{0} << (m_current & slot_mask)); pending != 0)
+    {
+        // The earliest occupied level 0 slot holds the earliest timers, all within the same tick.
+        auto* head     = m_slots[static_cast<std::size_t>(std::countr_zero(pending))];
+        auto  deadline = head->m_timer_deadline;
+        for (auto* pi = head->m_timer_next; pi != head; pi = pi->m_timer_next)
+        {
+            deadline = std::min(deadline, pi->m_timer_deadline);
+        }
+        return deadline;
+    }
+
+    return to_time_point(next_cascade());
+}
+
+auto timer_wheel::next_cascade() const noexcept -> std::uint64_t
+{
+    // Timers on a higher level are always in a later slot than the current one, the earliest of them is
+    // cascaded once the current tick reaches the start of the lowest level's next occupied slot.
+    for (std::uint64_t level = 1; level < level_count; ++level)
+    {
+        auto shift   = level * slot_bits;
+        auto index   = (m_current >> shift) & slot_mask;
+        auto pending = (index == slot_mask) ? std::uint64_t{0} : m_occupied[level] & (~std::uint64_t{0} << (index + 1));
+        if (pending != 0)
+        {
+            auto turn = (m_current >> (shift + slot_bits)) << (shift + slot_bits);
+            return turn | (static_cast<std::uint64_t>(std::countr_zero(pending)) << shift);
+        }
+    }
+
+    // Only overflowed timers remain, they are re-examined when the top level wraps.
+    constexpr auto top_shift = level_count * slot_bits;
+    return ((m_current >> top_shift) + 1) << top_shift;
+}
+
+auto timer_wheel::to_tick(time_point tp) const noexcept -> std::uint64_t
+{
+    if (tp <= m_epoch)
+    {
+        return 0;
+    }
+
+    // Round down, the tick only picks the timer's list and its exact deadline decides when it expires.
+    return static_cast<std::uint64_t>(std::chrono::floor<tick_duration>(tp - m_epoch).count());
+}
+
+auto timer_wheel::to_time_point(std::uint64_t tick) const noexcept -> time_point
+{
+    return m_epoch + tick_duration{static_cast<tick_duration::rep>(tick)};
+}
+
+auto timer_wheel::link(poll_info& pi) noexcept -> void
+{
+    // The level is the highest group of slot bits in which the deadline differs from the current tick.
+    auto difference = pi.m_timer_tick ^ m_current;
+    auto level      = (difference == 0) ? std::uint64_t{0}
+                                        : static_cast<std::uint64_t>(std::bit_width(difference) - 1) / slot_bits;
+
+    std::uint16_t slot{overflow_slot};
+    if (level < level_count)
+    {
+        auto index = (pi.m_timer_tick >> (level * slot_bits)) & slot_mask;
+        slot       = static_cast<std::uint16_t>(level * slot_count + index);
+        m_occupied[level] |= std::uint64_t{1} << index;
+    }
+
+    // Append to the circular list so timers sharing a tick expire in the order they were added.
+    auto*& head = m_slots[slot];
+    if (head == nullptr)
+    {
+        pi.m_timer_next = &pi;
+        pi.m_timer_prev = &pi;
+        head            = &pi;
+    }
+    else
+    {
+        pi.m_timer_next                  = head;
+        pi.m_timer_prev                  = head->m_timer_prev;
+        head->m_timer_prev->m_timer_next = &pi;
+        head->m_timer_prev               = &pi;
+    }
+    pi.m_timer_slot = slot;
+}
+
+auto timer_wheel::unlink(poll_info& pi) noexcept -> void
+{
+    auto   slot = pi.m_timer_slot;
+    auto*& head = m_slots[slot];
+    if (pi.m_timer_next == &pi)
+    {
+        head = nullptr;
+        if (slot != overflow_slot)
+        {
+            m_occupied[slot / slot_count] &= ~(std::uint64_t{1} << (slot % slot_count));
+        }
+    }
+    else
+    {
+        pi.m_timer_prev->m_timer_next = pi.m_timer_next;
+        pi.m_timer_next->m_timer_prev = pi.m_timer_prev;
+        if (head == &pi)
+        {
+            head = pi.m_timer_next;
+        }
+    }
+
+    pi.m_timer_next = nullptr;
+    pi.m_timer_prev = nullptr;
+    pi.m_timer_slot = poll_info::timer_unlinked;
+}
+
+auto timer_wheel::take(std::uint16_t slot) noexcept -> poll_info*
+{
+    auto* head = m_slots[slot];
+    if (head == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Break the circle into a nullptr terminated chain and mark every timer as unlinked.
+    head->m_timer_prev->m_timer_next = nullptr;
+    for (auto* pi = head; pi != nullptr; pi = pi->m_timer_next)
+    {
+        pi->m_timer_prev = nullptr;
+        pi->m_timer_slot = poll_info::timer_unlinked;
+    }
+
+    m_slots[slot] = nullptr;
+    if (slot != overflow_slot)
+    {
+        m_occupied[slot / slot_count] &= ~(std::uint64_t{1} << (slot % slot_count));
+    }
+    return head;
+}
+
+auto timer_wheel::take_due(std::uint16_t slot, time_point now) noexcept -> poll_info*
+{
+    auto* pi = m_slots[slot];
+    if (pi == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Unlink the timers whose deadline has passed into a nullptr terminated chain, keeping their order.
+    poll_info* due{nullptr};
+    poll_info* due_tail{nullptr};
+    auto*      last = pi->m_timer_prev;
+    while (true)
+    {
+        auto* next    = pi->m_timer_next;
+        auto  is_last = pi == last;
+        if (pi->m_timer_deadline <= now)
+        {
+            unlink(*pi);
+            if (due == nullptr)
+            {
+                due = pi;
+            }
+            else
+            {
+                due_tail->m_timer_next = pi;
+            }
+            due_tail = pi;
+        }
+
+        if (is_last)
+        {
+            return due;
+        }
+        pi = next;
+    }
+}
+
+auto timer_wheel::cascade() noexcept -> void
+{
+    // The current tick has just entered a new level 0 turn, move the timers of every higher level slot it
+    // has entered down onto the lower levels.
+    for (std::uint64_t level = 1; level <= level_count; ++level)
+    {
+        auto shift = level * slot_bits;
+        auto slot  = (level < level_count)
+                         ? static_cast<std::uint16_t>(level * slot_count + ((m_current >> shift) & slot_mask))
+                         : overflow_slot;
+
+        auto* pi = take(slot);
+        while (pi != nullptr)
+        {
+            auto* next = pi->m_timer_next;
+            link(*pi);
+            pi = next;
+        }
+
+        if (level < level_count && ((m_current >> shift) & slot_mask) != 0)
+        {
+            break;
+        }
+    }
+}
+
+} // namespace coro::detail
@@ -1,9 +1,13 @@
 #include "coro/io_scheduler.hpp"
 #include "coro/detail/task_self_deleting.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <cstring>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -26,20 +30,16 @@ static auto
 
 io_scheduler::io_scheduler(options&& opts, private_constructor)
     : m_opts(opts),
-      m_io_notifier(),
+      m_io_notifier(m_opts.backend),
       m_timer(static_cast<const void*>(&m_timer_object), m_io_notifier)
 {
-    if (!m_io_notifier.watch(m_shutdown_pipe.read_fd(), coro::poll_op::read, const_cast<void*>(m_shutdown_ptr), true))
+    if (!m_io_notifier.watch(m_schedule_fd.read_fd(), coro::poll_op::read, const_cast<void*>(m_schedule_ptr), true))
     {
-        throw std::runtime_error("Failed to register m_shutdown_pipe.read_fd() for read events.");
+        throw std::runtime_error("Failed to register m_schedule_fd.read_fd() for read events.");
     }
 
-    if (!m_io_notifier.watch(m_schedule_pipe.read_fd(), coro::poll_op::read, const_cast<void*>(m_schedule_ptr), true))
-    {
-        throw std::runtime_error("Failed to register m_schedule.pipe.read_rd() for read events.");
-    }
-
-    m_recent_events.reserve(m_max_events);
+    m_io_notifier.resize_event_batch(m_opts.event_batch_size, m_opts.max_event_batch_size);
+    m_recent_events.reserve(std::max(m_opts.event_batch_size, m_opts.max_event_batch_size));
 
     if (m_opts.execution_strategy == execution_strategy_t::process_tasks_on_thread_pool)
     {
@@ -71,8 +71,7 @@ io_scheduler::~io_scheduler()
         m_io_thread.join();
     }
 
-    m_shutdown_pipe.close();
-    m_schedule_pipe.close();
+    m_schedule_fd.close();
 }
 
 auto io_scheduler::process_events(std::chrono::milliseconds timeout) -> std::size_t
@@ -95,65 +94,238 @@ auto io_scheduler::spawn_joinable(coro::task<void>&& task) -> coro::task<void>
     return detail::make_spawned_joinable_wait_task(std::move(group_ptr));
 }
 
-auto io_scheduler::schedule_at(time_point time) -> coro::task<void>
+auto io_scheduler::yield_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void
 {
-    return yield_until(time);
-}
+    auto now  = clock::now();
+    auto time = (m_amount > std::chrono::nanoseconds{0}) ? now + m_amount : m_time;
 
-auto io_scheduler::yield_until(time_point time) -> coro::task<void>
-{
-    auto now = clock::now();
-
-    // If the requested time is in the past (or now!) bail out!
+    // If the requested time is in the past (or now!) just schedule the awaiting coroutine.
     if (time <= now)
     {
-        co_await schedule();
+        schedule_operation{m_scheduler}.await_suspend(awaiting_coroutine);
+        return;
     }
-    else
-    {
-        m_size.fetch_add(1, std::memory_order::release);
 
-        auto amount = std::chrono::duration_cast<std::chrono::milliseconds>(time - now);
+    // Yield/timeout tasks are considered live in the scheduler and must be accounted for.
+    m_scheduler.m_size.fetch_add(1, std::memory_order::release);
+    m_timed = true;
 
-        detail::poll_info pi{};
-        add_timer_token(now + amount, pi);
-        co_await pi;
+    // Yielding doesn't have a corresponding 'event' that can trigger, it always waits for the timeout
+    // to occur before resuming so the awaiting coroutine can be published before arming the timer.
+    m_pi.m_awaiting_coroutine = awaiting_coroutine;
+    std::atomic_thread_fence(std::memory_order::release);
+    m_scheduler.add_timer_token(time, m_pi);
+}
 
-        m_size.fetch_sub(1, std::memory_order::release);
+auto io_scheduler::yield_operation::await_resume() noexcept -> void
+{
+    if (m_timed)
+    {
+        m_scheduler.m_size.fetch_sub(1, std::memory_order::release);
     }
-    co_return;
 }
 
-auto io_scheduler::poll(fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout) -> coro::task<poll_status>
+auto io_scheduler::poll_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
-    // Because the size will drop when this coroutine suspends every poll needs to undo the subtraction
-    // on the number of active tasks in the scheduler.  When this task is resumed by the event loop.
-    m_size.fetch_add(1, std::memory_order::release);
+    // A registered file descriptor is always watched, the poll waits in the registration's waiter slot unless
+    // its latched readiness already satisfies the poll, in which case the awaiting coroutine resumes right away.
+    if (m_pi.m_fd_registration != nullptr && !m_pi.m_fd_registration->wait(m_pi))
+    {
+        return false;
+    }
+
+    // Because the size will drop when the awaiting coroutine suspends every poll needs to undo the
+    // subtraction on the number of active tasks in the scheduler.  When this is resumed by the event loop.
+    m_scheduler.m_size.fetch_add(1, std::memory_order::release);
+    m_suspended = true;
 
     // Setup two events, a timeout event and the actual poll for op event.
     // Whichever triggers first will delete the other to guarantee only one wins.
     // The resume token will be set by the scheduler to what the event turned out to be.
+    if (m_timeout > 0ms)
+    {
+        m_scheduler.add_timer_token(clock::now() + m_timeout, m_pi);
+    }
 
-    bool timeout_requested = (timeout > 0ms);
+    if (m_pi.m_fd_registration == nullptr && !m_scheduler.m_io_notifier.watch(m_pi))
+    {
+        std::cerr << "Failed to add " << m_pi.m_fd << " to watch list\n";
+    }
 
-    auto pi = detail::poll_info{fd, op};
+    // The event loop will 'clean-up' whichever event didn't win and waits for the awaiting coroutine
+    // to be published before resuming it.  This operation lives in the awaiting coroutine's frame so
+    // it must not be touched once the awaiting coroutine is published.
+    m_pi.m_awaiting_coroutine = awaiting_coroutine;
+    std::atomic_thread_fence(std::memory_order::release);
+    return true;
+}
 
-    if (timeout_requested)
+auto io_scheduler::poll_operation::await_resume() noexcept -> poll_status
+{
+    if (m_suspended)
     {
-        pi.m_timer_pos = add_timer_token(clock::now() + timeout, pi);
+        m_scheduler.m_size.fetch_sub(1, std::memory_order::release);
     }
+    return m_pi.m_poll_status;
+}
 
-    if (!m_io_notifier.watch(pi))
+auto io_scheduler::registered_fd::reset() noexcept -> void
+{
+    if (m_registration != nullptr)
     {
-        std::cerr << "Failed to add " << fd << " to watch list\n";
+        m_scheduler->m_io_notifier.unwatch(*m_registration);
+        m_registration.reset();
     }
+}
 
-    // The event loop will 'clean-up' whichever event didn't win since the coroutine is scheduled
-    // onto the thread poll its possible the other type of event could trigger while its waiting
-    // to execute again, thus restarting the coroutine twice, that would be quite bad.
-    auto result = co_await pi;
-    m_size.fetch_sub(1, std::memory_order::release);
-    co_return result;
+auto io_scheduler::register_fd(fd_t fd) -> registered_fd
+{
+    auto registration = std::make_unique<detail::fd_registration>(fd);
+    if (!m_io_notifier.watch(*registration))
+    {
+        throw std::runtime_error("Failed to register " + std::to_string(fd) + " with the io notifier");
+    }
+    return registered_fd{*this, std::move(registration)};
+}
+
+auto io_scheduler::perform_operation::await_ready() noexcept -> bool
+{
+    m_deadline = clock::now() + m_timeout;
+#ifdef LIBCORO_FEATURE_IO_URING
+    // The kernel performs the operation, it is submitted once the awaiting coroutine suspends.
+    if (m_scheduler.m_io_notifier.backend() == io_notifier::backend_t::io_uring)
+    {
+        return false;
+    }
+#endif
+    return execute();
+}
+
+auto io_scheduler::perform_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+{
+    m_scheduler.m_size.fetch_add(1, std::memory_order::release);
+    m_suspended = true;
+    m_pi.m_fd   = m_op.m_fd;
+    m_pi.m_op   = m_op.poll_operation();
+
+#ifdef LIBCORO_FEATURE_IO_URING
+    if (m_scheduler.m_io_notifier.backend() == io_notifier::backend_t::io_uring)
+    {
+        // The kernel performs the operation and cancels it if the timeout expires first, the poll info is
+        // resumed exactly once with the operation's result.
+        if (m_scheduler.m_io_notifier.submit(m_pi, m_op, m_timeout))
+        {
+            m_pi.m_awaiting_coroutine = awaiting_coroutine;
+            std::atomic_thread_fence(std::memory_order::release);
+            return true;
+        }
+
+        // The submission ring is full, fall back to performing the operation directly.
+        if (execute())
+        {
+            m_scheduler.m_size.fetch_sub(1, std::memory_order::release);
+            m_suspended = false;
+            return false;
+        }
+    }
+#endif
+
+    // The operation would block, the event loop retries it through on_event() once the socket is ready.
+    m_polled        = true;
+    m_pi.m_on_event = &on_event;
+    if (m_timeout > 0ms)
+    {
+        m_scheduler.add_timer_token(m_deadline, m_pi);
+    }
+
+    if (!m_scheduler.m_io_notifier.watch(m_pi))
+    {
+        std::cerr << "Failed to add " << m_pi.m_fd << " to watch list\n";
+    }
+
+    // Like a poll_operation this lives in the awaiting coroutine's frame and must not be touched once the
+    // awaiting coroutine is published.
+    m_pi.m_awaiting_coroutine = awaiting_coroutine;
+    std::atomic_thread_fence(std::memory_order::release);
+    return true;
+}
+
+auto io_scheduler::perform_operation::await_resume() noexcept -> std::int64_t
+{
+    if (!m_suspended)
+    {
+        return m_result;
+    }
+
+    m_scheduler.m_size.fetch_sub(1, std::memory_order::release);
+    if (m_polled)
+    {
+        return (m_pi.m_poll_status == poll_status::timeout) ? -ETIMEDOUT : m_result;
+    }
+
+    if (m_op.m_selected_buffer != nullptr)
+    {
+        *m_op.m_selected_buffer = m_pi.m_selected_buffer;
+    }
+    return (m_timeout > 0ms && m_pi.m_result == -ECANCELED) ? -ETIMEDOUT : m_pi.m_result;
+}
+
+auto io_scheduler::perform_operation::execute() noexcept -> bool
+{
+    m_result = m_op.execute();
+    if (m_op.m_opcode == detail::io_operation::opcode_t::connect)
+    {
+        // The connection is established in the background, the socket is writable once it completes.
+        return m_result != -EINPROGRESS && m_result != -EAGAIN;
+    }
+    return m_result != -EAGAIN && m_result != -EWOULDBLOCK;
+}
+
+auto io_scheduler::perform_operation::on_event(detail::poll_info& pi) -> bool
+{
+    auto& self = static_cast<entry&>(pi).m_operation;
+    if (self.m_op.m_opcode == detail::io_operation::opcode_t::connect)
+    {
+        int       error{0};
+        socklen_t error_length{sizeof(error)};
+        if (::getsockopt(self.m_op.m_fd, SOL_SOCKET, SO_ERROR, &error, &error_length) < 0)
+        {
+            error = errno;
+        }
+        self.m_result = -static_cast<std::int64_t>(error);
+        return true;
+    }
+
+    // A closed or errored socket is left for the retried syscall to report.
+    if (self.execute())
+    {
+        return true;
+    }
+
+    if (self.m_timeout > 0ms && clock::now() >= self.m_deadline)
+    {
+        self.m_result = -ETIMEDOUT;
+        return true;
+    }
+
+    // Another reader or writer got to the socket first, poll it again for what is left of the timeout.  The
+    // event loop has already unwatched the socket and removed the timeout.
+    pi.m_processed = false;
+    if (self.m_timeout > 0ms)
+    {
+        self.m_scheduler.add_timer_token(self.m_deadline, pi);
+    }
+    if (!self.m_scheduler.m_io_notifier.watch(pi))
+    {
+        // Nothing would ever wake the poll, hand the would block result back instead.
+        if (pi.timer_armed())
+        {
+            self.m_scheduler.remove_timer_token(pi);
+        }
+        pi.m_processed = true;
+        return true;
+    }
+    return false;
 }
 
 auto io_scheduler::resume(std::coroutine_handle<> handle) -> bool
@@ -177,11 +349,10 @@ auto io_scheduler::resume(std::coroutine_handle<> handle) -> bool
         }
 
         bool expected{false};
-        if (m_schedule_pipe_triggered.compare_exchange_strong(
+        if (m_schedule_fd_triggered.compare_exchange_strong(
                 expected, true, std::memory_order::release, std::memory_order::relaxed))
         {
-            const int value = 1;
-            ::write(m_schedule_pipe.write_fd(), reinterpret_cast<const void*>(&value), sizeof(value));
+            m_schedule_fd.notify();
         }
 
         return true;
@@ -192,14 +363,35 @@ auto io_scheduler::resume(std::coroutine_handle<> handle) -> bool
     }
 }
 
+auto io_scheduler::add_timer(time_point time, detail::poll_info& pi) -> void
+{
+    // Pending timers keep the event loop alive just like yield_for() does.
+    m_size.fetch_add(1, std::memory_order::release);
+
+    std::scoped_lock lk{m_timed_events_mutex};
+    m_timed_events.add(pi, time);
+    arm_timer(time, clock::now());
+}
+
+auto io_scheduler::cancel_timer(detail::poll_info& pi) -> bool
+{
+    std::scoped_lock lk{m_timed_events_mutex};
+    if (!m_timed_events.remove(pi))
+    {
+        return false;
+    }
+
+    m_size.fetch_sub(1, std::memory_order::release);
+    return true;
+}
+
 auto io_scheduler::shutdown() noexcept -> void
 {
     // Only allow shutdown to occur once.
     if (m_shutdown_requested.exchange(true, std::memory_order::acq_rel) == false)
     {
-        // Signal the event loop to stop asap.
-        const int value{1};
-        ::write(m_shutdown_pipe.write_fd(), reinterpret_cast<const void*>(&value), sizeof(value));
+        // Signal the event loop to stop asap, the doorbell is rung even if a schedule already rang it.
+        m_schedule_fd.notify();
 
         if (m_io_thread.joinable())
         {
@@ -213,32 +405,6 @@ auto io_scheduler::shutdown() noexcept -> void
     }
 }
 
-auto io_scheduler::yield_for_internal(std::chrono::nanoseconds amount) -> coro::task<void>
-{
-    if (amount <= 0ms)
-    {
-        co_await schedule();
-    }
-    else
-    {
-        // Yield/timeout tasks are considered live in the scheduler and must be accounted for. Note
-        // that if the user gives an invalid amount and schedule() is directly called it will account
-        // for the scheduled task there.
-        m_size.fetch_add(1, std::memory_order::release);
-
-        // Yielding does not require setting the timer position on the poll info since
-        // it doesn't have a corresponding 'event' that can trigger, it always waits for
-        // the timeout to occur before resuming.
-
-        detail::poll_info pi{};
-        add_timer_token(clock::now() + amount, pi);
-        co_await pi;
-
-        m_size.fetch_sub(1, std::memory_order::release);
-    }
-    co_return;
-}
-
 auto io_scheduler::process_events_manual(std::chrono::milliseconds timeout) -> void
 {
     bool expected{false};
@@ -260,7 +426,14 @@ auto io_scheduler::process_events_dedicated_thread() -> void
     // Execute tasks until stopped or there are no more tasks to complete.
     while (!m_shutdown_requested.load(std::memory_order::acquire) || size() > 0)
     {
-        process_events_execute(m_default_timeout);
+        if (m_opts.busy_poll_budget > std::chrono::microseconds{0})
+        {
+            process_events_busy_poll();
+        }
+        else
+        {
+            process_events_execute(m_default_timeout);
+        }
     }
     m_io_processing.exchange(false, std::memory_order::release);
 
@@ -270,6 +443,42 @@ auto io_scheduler::process_events_dedicated_thread() -> void
     }
 }
 
+auto io_scheduler::process_events_busy_poll() -> void
+{
+    // Hold the doorbell triggered so scheduling a task only queues it, the inbox is checked on every spin.
+    m_busy_polling = true;
+    m_schedule_fd_triggered.store(true, std::memory_order::release);
+
+    auto idle_since = clock::now();
+    while (!m_shutdown_requested.load(std::memory_order::acquire))
+    {
+        process_events_execute(m_no_timeout);
+        auto active = !m_recent_events.empty();
+        active      = process_scheduled_execute_busy_poll() || active;
+
+        auto now = clock::now();
+        if (active)
+        {
+            idle_since = now;
+        }
+        else if (now - idle_since >= m_opts.busy_poll_budget)
+        {
+            break;
+        }
+    }
+
+    // Re-enable the doorbell before blocking, a task queued while it was held has to be picked up first.  Once
+    // shutdown is requested the spin is skipped but the polls and timers still pending must be waited on.
+    m_busy_polling = false;
+    m_schedule_fd_triggered.exchange(false, std::memory_order::acq_rel);
+    if (process_scheduled_execute_busy_poll())
+    {
+        return;
+    }
+
+    process_events_execute(m_default_timeout);
+}
+
 auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) -> void
 {
     // Clear the recent events without decreasing the allocated capacity to reduce allocations
@@ -285,13 +494,9 @@ auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) ->
         }
         else if (handle_ptr == m_schedule_ptr)
         {
-            // Process scheduled coroutines.
+            // Process scheduled coroutines, this is also how a shutdown wakes up the event loop.
             process_scheduled_execute_inline();
         }
-        else if (handle_ptr == m_shutdown_ptr) [[unlikely]]
-        {
-            // Nothing to do, just needed to wake-up and smell the flowers
-        }
         else
         {
             // Individual poll task wake-up.
@@ -303,7 +508,7 @@ auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) ->
     // and an event for the same handle happen in the same epoll_wait() call then inline processing
     // will destruct the poll_info object before the second event is handled.  This is also possible
     // with thread pool processing, but probably has an extremely low chance of occuring due to
-    // the thread switch required.  If m_max_events == 1 this would be unnecessary.
+    // the thread switch required.  If the event batch size were 1 this would be unnecessary.
 
     if (!m_handles_to_resume.empty())
     {
@@ -331,47 +536,40 @@ auto io_scheduler::process_scheduled_execute_inline() -> void
         std::scoped_lock lk{m_scheduled_tasks_mutex};
         tasks.swap(m_scheduled_tasks);
 
-        // Clear the notification by reading until the pipe is cleared.
-        while (true)
-        {
-            constexpr std::size_t       READ_COUNT{4};
-            constexpr ssize_t           READ_COUNT_BYTES = READ_COUNT * sizeof(int);
-            std::array<int, READ_COUNT> control{};
-            const ssize_t               result =
-                ::read(m_schedule_pipe.read_fd(), reinterpret_cast<void*>(control.data()), READ_COUNT_BYTES);
-            if (result == READ_COUNT_BYTES)
-            {
-                continue;
-            }
+        // Clear the notification, a single read regardless of how many times the doorbell was rung.
+        m_schedule_fd.drain();
 
-            // If we got nothing, or we got a partial read break the loop since the pipe is empty.
-            if (result >= 0)
-            {
-                break;
-            }
+        // Clear the in memory flag to reduce eventfd_* calls on scheduling, it stays set while busy polling.
+        m_schedule_fd_triggered.exchange(m_busy_polling, std::memory_order::release);
+    }
 
-            // pipe is set to O_NONBLOCK so ignore empty blocking reads.
-            if (errno == EAGAIN)
-            {
-                break;
-            }
+    // This set of handles can be safely resumed now since they do not have a corresponding timeout event.
+    for (auto& task : tasks)
+    {
+        task.resume();
+    }
+    m_size.fetch_sub(tasks.size(), std::memory_order::release);
+}
 
-            // Not much we can do here, we're in a very bad state, lets report to stderr.
-            std::cerr << "::read(m_schedule_pipe.read_fd()) error[" << errno << "] " << ::strerror(errno) << " fd=["
-                      << m_schedule_pipe.read_fd() << "]" << std::endl;
-            break;
+auto io_scheduler::process_scheduled_execute_busy_poll() -> bool
+{
+    std::vector<std::coroutine_handle<>> tasks{};
+    {
+        // The doorbell was not rung for these tasks so there is no notification to clear.
+        std::scoped_lock lk{m_scheduled_tasks_mutex};
+        if (m_scheduled_tasks.empty())
+        {
+            return false;
         }
-
-        // Clear the in memory flag to reduce eventfd_* calls on scheduling.
-        m_schedule_pipe_triggered.exchange(false, std::memory_order::release);
+        tasks.swap(m_scheduled_tasks);
     }
 
-    // This set of handles can be safely resumed now since they do not have a corresponding timeout event.
     for (auto& task : tasks)
     {
         task.resume();
     }
     m_size.fetch_sub(tasks.size(), std::memory_order::release);
+    return true;
 }
 
 auto io_scheduler::process_event_execute(detail::poll_info* pi, poll_status status) -> void
@@ -383,23 +581,32 @@ auto io_scheduler::process_event_execute(detail::poll_info* pi, poll_status stat
         // is ever processed, the other is discarded.
         pi->m_processed = true;
 
-        // Given a valid fd always remove it from epoll so the next poll can blindly EPOLL_CTL_ADD.
-        if (pi->m_fd != -1)
+        // Given a valid fd always remove it from epoll so the next poll can blindly EPOLL_CTL_ADD, a registered
+        // fd stays watched and its registration has already removed the poll from its waiter slot.
+        if (pi->m_fd != -1 && pi->m_fd_registration == nullptr)
         {
             m_io_notifier.unwatch(*pi);
         }
 
+        // A registered poll can be woken before its awaiter has armed the timeout, wait for the awaiting
+        // coroutine to be published as it is published after the timeout is armed.
+        while (pi->m_awaiting_coroutine == nullptr)
+        {
+            std::atomic_thread_fence(std::memory_order::acquire);
+        }
+
         // Since this event triggered, remove its corresponding timeout if it has one.
-        if (pi->m_timer_pos.has_value())
+        if (pi->timer_armed())
         {
-            remove_timer_token(pi->m_timer_pos.value());
+            remove_timer_token(*pi);
         }
 
         pi->m_poll_status = status;
 
-        while (pi->m_awaiting_coroutine == nullptr)
+        // A poll armed by perform() retries its operation first and stays pending if it would still block.
+        if (pi->m_on_event != nullptr && !pi->m_on_event(*pi))
         {
-            std::atomic_thread_fence(std::memory_order::acquire);
+            return;
         }
 
         m_handles_to_resume.emplace_back(pi->m_awaiting_coroutine);
@@ -408,30 +615,58 @@ auto io_scheduler::process_event_execute(detail::poll_info* pi, poll_status stat
 
 auto io_scheduler::process_timeout_execute() -> void
 {
-    std::vector<detail::poll_info*> poll_infos{};
-    auto                            now = clock::now();
+    // The expired poll infos that resume their awaiting coroutine, chained through m_timer_next.
+    detail::poll_info* poll_infos{nullptr};
+    detail::poll_info* poll_infos_tail{nullptr};
 
     {
         std::scoped_lock lk{m_timed_events_mutex};
-        while (!m_timed_events.empty())
+        auto*            pi = m_timed_events.expire(clock::now());
+        while (pi != nullptr)
         {
-            auto first    = m_timed_events.begin();
-            auto [tp, pi] = *first;
-
-            if (tp <= now)
+            auto* next = std::exchange(pi->m_timer_next, nullptr);
+            if (pi->m_on_timeout != nullptr)
             {
-                m_timed_events.erase(first);
-                poll_infos.emplace_back(pi);
+                // Callback timers run under the lock so cancel_timer() can never race their completion.
+                if (auto handle = pi->m_on_timeout(*pi); handle != nullptr)
+                {
+                    m_handles_to_resume.emplace_back(handle);
+                }
+                m_size.fetch_sub(1, std::memory_order::release);
             }
             else
             {
-                break;
+                if (poll_infos == nullptr)
+                {
+                    poll_infos = pi;
+                }
+                else
+                {
+                    poll_infos_tail->m_timer_next = pi;
+                }
+                poll_infos_tail = pi;
             }
+            pi = next;
+        }
+
+        // The timer has fired, re-arm it for the next expiry or disarm it, re-take the current now
+        // time since running the callbacks could shift the time.
+        m_timer_deadline = time_point::max();
+        if (m_timed_events.empty())
+        {
+            m_io_notifier.unwatch_timer(m_timer);
+        }
+        else
+        {
+            update_timeout(clock::now());
         }
     }
 
-    for (auto pi : poll_infos)
+    while (poll_infos != nullptr)
     {
+        auto* pi   = poll_infos;
+        poll_infos = std::exchange(pi->m_timer_next, nullptr);
+
         if (!pi->m_processed)
         {
             // Its possible the event and the timeout occurred in the same epoll, make sure only one
@@ -439,7 +674,11 @@ auto io_scheduler::process_timeout_execute() -> void
             pi->m_processed = true;
 
             // Since this timed out, remove its corresponding event if it has one.
-            if (pi->m_fd != -1)
+            if (pi->m_fd_registration != nullptr)
+            {
+                pi->m_fd_registration->cancel(*pi);
+            }
+            else if (pi->m_fd != -1)
             {
                 m_io_notifier.unwatch(*pi);
             }
@@ -453,61 +692,50 @@ auto io_scheduler::process_timeout_execute() -> void
             pi->m_poll_status = coro::poll_status::timeout;
         }
     }
-
-    // Update the time to the next smallest time point, re-take the current now time
-    // since updating and resuming tasks could shift the time.
-    update_timeout(clock::now());
 }
 
-auto io_scheduler::add_timer_token(time_point tp, detail::poll_info& pi) -> timed_events::iterator
+auto io_scheduler::add_timer_token(time_point tp, detail::poll_info& pi) -> void
 {
     std::scoped_lock lk{m_timed_events_mutex};
-    auto             pos = m_timed_events.emplace(tp, &pi);
-
-    // If this item was inserted as the smallest time point, update the timeout.
-    if (pos == m_timed_events.begin())
-    {
-        update_timeout(clock::now());
-    }
+    m_timed_events.add(pi, tp);
+    arm_timer(tp, clock::now());
+}
 
-    return pos;
+auto io_scheduler::remove_timer_token(detail::poll_info& pi) -> void
+{
+    // The timer is not re-armed, if this was the earliest timeout the event loop ignores the timer
+    // firing with nothing to expire and re-arms it for the next one then.
+    std::scoped_lock lk{m_timed_events_mutex};
+    m_timed_events.remove(pi);
 }
 
-auto io_scheduler::remove_timer_token(timed_events::iterator pos) -> void
+auto io_scheduler::update_timeout(time_point now) -> void
 {
+    // This must be called while holding the timer lock.
+    auto next = m_timed_events.next_expiry();
+    if (next.has_value())
     {
-        std::scoped_lock lk{m_timed_events_mutex};
-        auto             is_first = (m_timed_events.begin() == pos);
-
-        m_timed_events.erase(pos);
-
-        // If this was the first item, update the timeout.  It would be acceptable to just let it
-        // also fire the timeout as the event loop will ignore it since nothing will have timed
-        // out but it feels like the right thing to do to update it to the correct timeout value.
-        if (is_first)
-        {
-            update_timeout(clock::now());
-        }
+        arm_timer(next.value(), now);
+    }
+    else if (m_timer_deadline != time_point::max())
+    {
+        m_timer_deadline = time_point::max();
+        m_io_notifier.unwatch_timer(m_timer);
     }
 }
 
-auto io_scheduler::update_timeout(time_point now) -> void
+auto io_scheduler::arm_timer(time_point deadline, time_point now) -> void
 {
-    if (!m_timed_events.empty())
+    // Only re-arm the timer when it needs to fire earlier than it already will, this must be called
+    // while holding the timer lock.  The timer is armed for the exact deadline, not a timing wheel tick.
+    if (deadline < m_timer_deadline)
     {
-        auto& [tp, pi] = *m_timed_events.begin();
-
-        auto amount = tp - now;
-
-        if (!m_io_notifier.watch_timer(m_timer, amount))
+        m_timer_deadline = deadline;
+        if (!m_io_notifier.watch_timer(m_timer, m_timer_deadline - now))
         {
             std::cerr << "Failed to set timerfd errorno=[" << std::string{strerror(errno)} << "].";
         }
     }
-    else
-    {
-        m_io_notifier.unwatch_timer(m_timer);
-    }
 }
 
 } // namespace coro
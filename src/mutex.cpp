@@ -1,4 +1,3 @@
-#include "coro/detail/awaiter_list.hpp"
 #include "coro/mutex.hpp"
 
 namespace coro
@@ -69,9 +68,59 @@ auto mutex::try_lock() -> bool
 
 auto mutex::unlock() -> void
 {
+    if (auto handle = handoff(); handle != nullptr)
+    {
+        // Directly transfer control to the waiter, they are now responsible for unlocking the mutex.
+        std::atomic_thread_fence(std::memory_order::acq_rel);
+        handle.resume();
+    }
+}
+
+auto mutex::handoff() -> std::coroutine_handle<>
+{
+    while (auto* waiter = pop_next_waiter())
+    {
+        if (waiter->m_on_handoff == nullptr)
+        {
+            return waiter->m_awaiting_coroutine;
+        }
+
+        // Timed waiters that have given up are skipped, the lock stays held while moving to the next one.
+        if (auto handle = waiter->m_on_handoff(*waiter); handle.has_value())
+        {
+            return handle.value();
+        }
+    }
+
+    return nullptr;
+}
+
+auto mutex::pop_next_waiter() -> detail::lock_operation_base*
+{
+    // While timed waiters are queued they can unlink themselves at any time, the waiter lists are then only changed
+    // while holding m_timed_mutex.  A timed waiter is counted before it is queued, so once a waiter list has been
+    // loaded a zero count means none of its waiters can be unlinking themselves.
+    std::unique_lock<std::mutex> lk{m_timed_mutex, std::defer_lock};
+    if (m_timed_waiters.load(std::memory_order::seq_cst) != 0)
+    {
+        lk.lock();
+    }
+
+    // FIFO waiters that were already taken from m_state go first, the mutex stays locked.
+    if (m_fifo_waiters != nullptr)
+    {
+        return std::exchange(m_fifo_waiters, m_fifo_waiters->m_next);
+    }
+
     void* current = m_state.load(std::memory_order::acquire);
     do
     {
+        if (!lk.owns_lock() && m_timed_waiters.load(std::memory_order::seq_cst) != 0)
+        {
+            lk.lock();
+            current = m_state.load(std::memory_order::acquire);
+        }
+
         // Sanity check that the mutex isn't already unlocked.
         if (current == const_cast<void*>(unlocked_value()))
         {
@@ -89,7 +138,7 @@ auto mutex::unlock() -> void
             {
                 // We've successfully unlocked the mutex, return since there are no current waiters.
                 std::atomic_thread_fence(std::memory_order::acq_rel);
-                return;
+                return nullptr;
             }
             else
             {
@@ -98,18 +147,72 @@ auto mutex::unlock() -> void
                 continue;
             }
         }
+        else if (m_policy == resume_order_policy::fifo)
+        {
+            // Take every waiter at once leaving the mutex locked with no waiters, the list is LIFO so
+            // reverse it to hand the lock out in the order the waiters suspended.
+            if (m_state.compare_exchange_weak(current, nullptr, std::memory_order::acq_rel, std::memory_order::acquire))
+            {
+                detail::lock_operation_base* reversed{nullptr};
+                auto*                        waiters = static_cast<detail::lock_operation_base*>(current);
+                while (waiters != nullptr)
+                {
+                    auto* next      = waiters->m_next;
+                    waiters->m_next = reversed;
+                    reversed        = waiters;
+                    waiters         = next;
+                }
+                m_fifo_waiters = reversed->m_next;
+                return reversed;
+            }
+        }
         else
         {
-            // There are waiters, lets wake the first one up. This will set the state to the next waiter, or nullptr (no waiters but locked).
-            std::atomic<detail::lock_operation_base*>* casted = reinterpret_cast<std::atomic<detail::lock_operation_base*>*>(&m_state);
-            auto* waiter = detail::awaiter_list_pop<detail::lock_operation_base>(*casted);
-            // assert waiter != nullptr, nobody else should be unlocking this mutex.
-            // Directly transfer control to the waiter, they are now responsible for unlocking the mutex.
-            std::atomic_thread_fence(std::memory_order::acq_rel);
-            waiter->m_awaiting_coroutine.resume();
-            return;
+            // There are waiters, pop the most recent one. This will set the state to the next waiter, or nullptr (no waiters but locked).
+            auto* waiter = static_cast<detail::lock_operation_base*>(current);
+            if (m_state.compare_exchange_weak(current, waiter->m_next, std::memory_order::acq_rel, std::memory_order::acquire))
+            {
+                return waiter;
+            }
         }
     } while (true);
 }
 
+auto mutex::unlink_waiter_locked(detail::lock_operation_base& waiter) -> bool
+{
+    // New waiters only ever replace the head of m_state, the links below it are only changed by the lock holder
+    // and by timed out waiters which both hold m_timed_mutex.
+    void* current = m_state.load(std::memory_order::acquire);
+    while (current == &waiter)
+    {
+        if (m_state.compare_exchange_weak(current, waiter.m_next, std::memory_order::acq_rel, std::memory_order::acquire))
+        {
+            return true;
+        }
+    }
+
+    if (current != unlocked_value())
+    {
+        for (auto* w = static_cast<detail::lock_operation_base*>(current); w != nullptr; w = w->m_next)
+        {
+            if (w->m_next == &waiter)
+            {
+                w->m_next = waiter.m_next;
+                return true;
+            }
+        }
+    }
+
+    for (auto** link = &m_fifo_waiters; *link != nullptr; link = &(*link)->m_next)
+    {
+        if (*link == &waiter)
+        {
+            *link = waiter.m_next;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 } // namespace coro
@@ -0,0 +1,363 @@
+#include "coro/net/buffer_pool.hpp"
+
+#include <cerrno>
+#include <stdexcept>
+#include <sys/socket.h>
+
+namespace coro::net
+{
+using namespace std::chrono_literals;
+
+buffer_pool::buffer_pool(std::unique_ptr<coro::io_scheduler>& scheduler, options opts)
+    : m_io_scheduler(scheduler.get()),
+      m_opts(opts)
+{
+    if (m_io_scheduler == nullptr)
+    {
+        throw std::runtime_error{"buffer_pool cannot have a nullptr io_scheduler"};
+    }
+    if (m_opts.buffer_size == 0 || m_opts.buffer_count == 0)
+    {
+        throw std::runtime_error{"buffer_pool requires a non zero buffer_size and buffer_count"};
+    }
+    if (m_opts.buffer_count > max_buffer_count)
+    {
+        // Larger provided buffer rings are rejected by the kernel, the pool would silently lose kernel selection.
+        throw std::runtime_error{"buffer_pool buffer_count must not exceed buffer_pool::max_buffer_count"};
+    }
+
+    // Pages are only committed by the operating system once a buffer is first received into.
+    m_storage = std::make_unique_for_overwrite<char[]>(m_opts.buffer_size * m_opts.buffer_count);
+
+#ifdef LIBCORO_FEATURE_IO_URING
+    m_buffer_group =
+        m_io_scheduler->notifier().register_buffers(m_storage.get(), m_opts.buffer_size, m_opts.buffer_count);
+#endif
+
+    if (m_buffer_group < 0)
+    {
+        m_free.reserve(m_opts.buffer_count);
+        for (std::uint16_t id = m_opts.buffer_count; id > 0; --id)
+        {
+            m_free.emplace_back(static_cast<std::uint16_t>(id - 1));
+        }
+    }
+}
+
+buffer_pool::~buffer_pool()
+{
+#ifdef LIBCORO_FEATURE_IO_URING
+    if (m_buffer_group >= 0)
+    {
+        m_io_scheduler->notifier().unregister_buffers(m_buffer_group);
+    }
+#endif
+}
+
+auto buffer_pool::recv(fd_t fd, std::chrono::milliseconds timeout) -> coro::task<std::pair<recv_status, buffer>>
+{
+    return kernel_provided() ? recv_kernel_provided(fd, timeout) : recv_on_readiness(fd, timeout);
+}
+
+auto buffer_pool::recycle(std::uint16_t id) noexcept -> void
+{
+    wait_operation* waiter{nullptr};
+#ifdef LIBCORO_FEATURE_IO_URING
+    if (m_buffer_group >= 0)
+    {
+        // The kernel selects the buffer, the oldest waiting recv is woken to submit its receive again.
+        m_io_scheduler->notifier().provide_buffer(m_buffer_group, id);
+        m_in_use.fetch_sub(1, std::memory_order::release);
+
+        {
+            std::scoped_lock lk{m_mutex};
+            m_recycled.fetch_add(1, std::memory_order::release);
+            waiter = pop_waiter_locked();
+        }
+        if (waiter != nullptr)
+        {
+            wake(*waiter);
+        }
+        return;
+    }
+#endif
+
+    {
+        std::scoped_lock lk{m_mutex};
+        waiter = pop_waiter_locked();
+        if (waiter == nullptr)
+        {
+            m_free.emplace_back(id);
+        }
+        else
+        {
+            // The buffer is handed straight to the oldest waiting recv and stays in use.
+            waiter->m_id = id;
+        }
+    }
+
+    if (waiter == nullptr)
+    {
+        m_in_use.fetch_sub(1, std::memory_order::release);
+    }
+    else
+    {
+        wake(*waiter);
+    }
+}
+
+auto buffer_pool::pop_waiter_locked() noexcept -> wait_operation*
+{
+    auto* waiter = m_waiters_head;
+    if (waiter != nullptr)
+    {
+        m_waiters_head = waiter->m_next;
+        if (m_waiters_head == nullptr)
+        {
+            m_waiters_tail = nullptr;
+        }
+        else
+        {
+            m_waiters_head->m_prev = nullptr;
+        }
+        waiter->m_state = wait_operation::state_t::granted;
+    }
+    return waiter;
+}
+
+auto buffer_pool::wake(wait_operation& waiter) noexcept -> void
+{
+    // The waiter is granted so its timer callback backs off, if it is concurrently firing this waits for it.
+    if (waiter.m_timed)
+    {
+        m_io_scheduler->cancel_timer(waiter.m_timer);
+    }
+
+    // Never resume the waiter on the thread returning the buffer unless the scheduler is shutting down.
+    if (!m_io_scheduler->resume(waiter.m_awaiting_coroutine))
+    {
+        waiter.m_awaiting_coroutine.resume();
+    }
+}
+
+buffer_pool::wait_operation::wait_operation(
+    buffer_pool& pool, std::uint64_t recycled, time_point deadline, bool timed) noexcept
+    : m_pool(pool),
+      m_recycled(recycled),
+      m_deadline(deadline),
+      m_timed(timed),
+      m_timer(*this)
+{
+    m_timer.m_on_timeout = &wait_operation::on_timeout;
+}
+
+auto buffer_pool::wait_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) -> bool
+{
+    m_awaiting_coroutine = awaiting_coroutine;
+
+    // The timer is armed before taking the pool's lock, its callback takes the lock while holding the
+    // scheduler's timer lock.
+    if (m_timed)
+    {
+        m_pool.m_io_scheduler->add_timer(m_deadline, m_timer);
+    }
+
+    {
+        std::unique_lock lk{m_pool.m_mutex};
+        if (m_state == state_t::timed_out)
+        {
+            return false;
+        }
+
+        auto available{false};
+        if (m_pool.kernel_provided())
+        {
+            available = m_pool.m_recycled.load(std::memory_order::acquire) != m_recycled;
+        }
+        else if (!m_pool.m_free.empty())
+        {
+            m_id = m_pool.m_free.back();
+            m_pool.m_free.pop_back();
+            m_pool.m_in_use.fetch_add(1, std::memory_order::release);
+            available = true;
+        }
+
+        if (!available)
+        {
+            m_state = state_t::waiting;
+            m_prev  = m_pool.m_waiters_tail;
+            if (m_prev == nullptr)
+            {
+                m_pool.m_waiters_head = this;
+            }
+            else
+            {
+                m_prev->m_next = this;
+            }
+            m_pool.m_waiters_tail = this;
+            return true;
+        }
+
+        m_state = state_t::granted;
+    }
+
+    if (m_timed)
+    {
+        m_pool.m_io_scheduler->cancel_timer(m_timer);
+    }
+    return false;
+}
+
+auto buffer_pool::wait_operation::await_resume() const noexcept -> std::optional<std::uint16_t>
+{
+    if (m_state == state_t::timed_out)
+    {
+        return std::nullopt;
+    }
+    return m_id;
+}
+
+auto buffer_pool::wait_operation::on_timeout(detail::poll_info& pi) -> std::coroutine_handle<>
+{
+    auto&            self = static_cast<timer_entry&>(pi).m_operation;
+    auto&            pool = self.m_pool;
+    std::scoped_lock lk{pool.m_mutex};
+    if (self.m_state == state_t::registering)
+    {
+        // The recv sees the timeout before it suspends.
+        self.m_state = state_t::timed_out;
+        return nullptr;
+    }
+    if (self.m_state != state_t::waiting)
+    {
+        // A buffer was handed over first.
+        return nullptr;
+    }
+
+    if (self.m_prev == nullptr)
+    {
+        pool.m_waiters_head = self.m_next;
+    }
+    else
+    {
+        self.m_prev->m_next = self.m_next;
+    }
+    if (self.m_next == nullptr)
+    {
+        pool.m_waiters_tail = self.m_prev;
+    }
+    else
+    {
+        self.m_next->m_prev = self.m_prev;
+    }
+    self.m_state = state_t::timed_out;
+    return self.m_awaiting_coroutine;
+}
+
+auto buffer_pool::recv_kernel_provided(fd_t fd, std::chrono::milliseconds timeout)
+    -> coro::task<std::pair<recv_status, buffer>>
+{
+    const auto deadline = clock::now() + timeout;
+    while (true)
+    {
+        auto recycled  = m_recycled.load(std::memory_order::acquire);
+        auto remaining = (timeout > 0ms)
+                             ? std::max(std::chrono::ceil<std::chrono::milliseconds>(deadline - clock::now()), 1ms)
+                             : 0ms;
+
+        std::int32_t selected{-1};
+        auto         result = co_await m_io_scheduler->perform(
+            detail::io_operation{
+                        .m_opcode          = detail::io_operation::opcode_t::recv,
+                        .m_fd              = fd,
+                        .m_length          = m_opts.buffer_size,
+                        .m_buffer_group    = m_buffer_group,
+                        .m_selected_buffer = &selected},
+            remaining);
+
+        if (selected >= 0)
+        {
+            m_in_use.fetch_add(1, std::memory_order::release);
+            auto id = static_cast<std::uint16_t>(selected);
+            if (result > 0)
+            {
+                co_return {
+                    recv_status::ok, buffer{this, id, std::span<char>{data(id), static_cast<std::size_t>(result)}}};
+            }
+
+            // Nothing was received into the selected buffer, hand it straight back.
+            recycle(id);
+        }
+
+        if (result == -ENOBUFS)
+        {
+            // Data arrived but every buffer is in use, wait for one to be returned and receive again.
+            if (!(co_await wait_operation{*this, recycled, deadline, timeout > 0ms}).has_value())
+            {
+                co_return {recv_status::timeout, buffer{}};
+            }
+            continue;
+        }
+
+        if (result == 0)
+        {
+            // On TCP stream sockets 0 indicates the connection has been closed by the peer.
+            co_return {recv_status::closed, buffer{}};
+        }
+
+        co_return {static_cast<recv_status>((result < 0) ? -result : EIO), buffer{}};
+    }
+}
+
+auto buffer_pool::recv_on_readiness(fd_t fd, std::chrono::milliseconds timeout)
+    -> coro::task<std::pair<recv_status, buffer>>
+{
+    const auto deadline = clock::now() + timeout;
+    while (true)
+    {
+        // Wait for data before taking a buffer so idle sockets never hold one.
+        auto remaining = (timeout > 0ms)
+                             ? std::max(std::chrono::ceil<std::chrono::milliseconds>(deadline - clock::now()), 1ms)
+                             : 0ms;
+        auto pstatus   = co_await m_io_scheduler->poll(fd, coro::poll_op::read, remaining);
+        if (pstatus == poll_status::timeout)
+        {
+            co_return {recv_status::timeout, buffer{}};
+        }
+
+        // Take a free buffer, or wait for one to be handed over once every buffer is in use.
+        auto id = co_await wait_operation{*this, 0, deadline, timeout > 0ms};
+        if (!id.has_value())
+        {
+            co_return {recv_status::timeout, buffer{}};
+        }
+
+        auto bytes_recv = ::recv(fd, data(id.value()), m_opts.buffer_size, 0);
+        if (bytes_recv > 0)
+        {
+            co_return {
+                recv_status::ok,
+                buffer{this, id.value(), std::span<char>{data(id.value()), static_cast<std::size_t>(bytes_recv)}}};
+        }
+
+        auto error = errno;
+        recycle(id.value());
+        if (bytes_recv == 0)
+        {
+            // On TCP stream sockets 0 indicates the connection has been closed by the peer.
+            co_return {recv_status::closed, buffer{}};
+        }
+
+        // Another reader raced this one to the data, wait for more.
+        if (error != EAGAIN && error != EWOULDBLOCK)
+        {
+            co_return {static_cast<recv_status>(error), buffer{}};
+        }
+        if (timeout > 0ms && clock::now() >= deadline)
+        {
+            co_return {recv_status::timeout, buffer{}};
+        }
+    }
+}
+
+} // namespace coro::net
@@ -15,6 +15,7 @@ static const std::string recv_status_no_memory{"no_memory"};
 static const std::string recv_status_not_connected{"not_connected"};
 static const std::string recv_status_not_a_socket{"not_a_socket"};
 static const std::string connection_reset_by_peer{"connection_reset_by_peer"};
+static const std::string recv_status_timeout{"timeout"};
 static const std::string recv_status_unknown{"unknown"};
 
 auto to_string(recv_status status) -> const std::string&
@@ -48,6 +49,8 @@ auto to_string(recv_status status) -> const std::string&
             return recv_status_not_a_socket;
         case recv_status::connection_reset_by_peer:
             return connection_reset_by_peer;
+        case recv_status::timeout:
+            return recv_status_timeout;
     }
 
     return recv_status_unknown;
@@ -129,4 +129,41 @@ auto client::connect(std::chrono::milliseconds timeout) -> coro::task<connect_st
     co_return return_value(connect_status::error);
 }
 
+auto client::async_connect(std::chrono::milliseconds timeout) -> coro::task<connect_status>
+{
+    // Only allow the user to connect per tcp client once, if they need to re-connect they should
+    // make a new tcp::client.
+    if (m_connect_status.has_value())
+    {
+        co_return m_connect_status.value();
+    }
+
+    sockaddr_in server{};
+    server.sin_family = static_cast<int>(m_options.address.domain());
+    server.sin_port   = htons(m_options.port);
+    server.sin_addr   = *reinterpret_cast<const in_addr*>(m_options.address.data().data());
+
+    auto result = co_await m_io_scheduler->perform(
+        detail::io_operation{
+            .m_opcode = detail::io_operation::opcode_t::connect,
+            .m_fd     = m_socket.native_handle(),
+            .m_buffer = static_cast<void*>(&server),
+            .m_length = sizeof(server)},
+        timeout);
+    if (result == 0)
+    {
+        m_connect_status = connect_status::connected;
+    }
+    else if (result == -ETIMEDOUT)
+    {
+        m_connect_status = connect_status::timeout;
+    }
+    else
+    {
+        m_connect_status = connect_status::error;
+    }
+
+    co_return m_connect_status.value();
+}
+
 } // namespace coro::net::tcp
@@ -61,4 +61,33 @@ auto server::accept() -> coro::net::tcp::client
         }};
 };
 
+auto server::async_accept(std::chrono::milliseconds timeout) -> coro::task<coro::net::tcp::client>
+{
+    sockaddr_in client{};
+    socklen_t   len = sizeof(struct sockaddr_in);
+
+    auto result = co_await m_io_scheduler->perform(
+        detail::io_operation{
+            .m_opcode         = detail::io_operation::opcode_t::accept,
+            .m_fd             = m_accept_socket.native_handle(),
+            .m_buffer         = static_cast<void*>(&client),
+            .m_length         = sizeof(client),
+            .m_address_length = &len},
+        timeout);
+    net::socket s{(result >= 0) ? static_cast<int>(result) : -1};
+
+    std::span<const uint8_t> ip_addr_view{
+        reinterpret_cast<uint8_t*>(&client.sin_addr.s_addr),
+        sizeof(client.sin_addr.s_addr),
+    };
+
+    co_return tcp::client{
+        m_io_scheduler,
+        std::move(s),
+        client::options{
+            .address = net::ip_address{ip_addr_view, static_cast<net::domain_t>(client.sin_family)},
+            .port    = ntohs(client.sin_port),
+        }};
+}
+
 } // namespace coro::net::tcp
@@ -6,6 +6,7 @@ using namespace std::string_literals;
 
 std::string semaphore_acquire_result_acquired = "acquired"s;
 std::string semaphore_acquire_result_shutdown = "shutdown"s;
+std::string semaphore_acquire_result_timeout  = "timeout"s;
 std::string semaphore_acquire_result_unknown  = "unknown"s;
 
 auto to_string(semaphore_acquire_result result) -> const std::string&
@@ -16,6 +17,8 @@ auto to_string(semaphore_acquire_result result) -> const std::string&
             return semaphore_acquire_result_acquired;
         case semaphore_acquire_result::shutdown:
             return semaphore_acquire_result_shutdown;
+        case semaphore_acquire_result::timeout:
+            return semaphore_acquire_result_timeout;
     }
 
     return semaphore_acquire_result_unknown;
@@ -374,6 +374,99 @@ TEST_CASE("benchmark counter task scheduler await event from another coroutine",
     REQUIRE(s->empty());
 }
 
+enum class mutex_unlock_mode
+{
+    /// The next waiter is resumed inline on the unlocking thread.
+    inline_resume,
+    /// The next waiter is resumed on the thread pool.
+    executor
+};
+
+static auto bench_mutex_contention(
+    const std::string& bench_name, coro::resume_order_policy policy, mutex_unlock_mode mode) -> void
+{
+    constexpr std::size_t iterations = 100'000; // per worker
+    constexpr std::size_t workers    = 64;
+    constexpr std::size_t ops        = iterations * workers;
+
+    auto                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    coro::mutex           m{policy};
+    uint64_t              counter{0};
+    std::atomic<uint64_t> max_wait_ns{0};
+
+    auto make_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                        coro::mutex&                        m,
+                        mutex_unlock_mode                   mode,
+                        uint64_t&                           counter,
+                        std::atomic<uint64_t>&              max_wait_ns) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        uint64_t local_max{0};
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            auto start = sc::now();
+            co_await m.lock();
+            auto waited = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sc::now() - start).count());
+            local_max   = std::max(local_max, waited);
+            ++counter;
+            if (mode == mutex_unlock_mode::executor)
+            {
+                m.unlock(tp);
+            }
+            else
+            {
+                m.unlock();
+            }
+        }
+
+        auto current = max_wait_ns.load(std::memory_order::relaxed);
+        while (current < local_max && !max_wait_ns.compare_exchange_weak(current, local_max, std::memory_order::relaxed)) {}
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    tasks.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i)
+    {
+        tasks.emplace_back(make_task(tp, m, mode, counter, max_wait_ns));
+    }
+
+    auto start = sc::now();
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+    auto stop = sc::now();
+
+    print_stats(bench_name, ops, start, stop);
+    std::cout << "    max lock wait: " << std::chrono::duration_cast<std::chrono::microseconds>(
+                                                std::chrono::nanoseconds{max_wait_ns.load()})
+                                                .count()
+              << "us\n";
+    REQUIRE(counter == ops);
+}
+
+TEST_CASE("benchmark mutex contention lifo inline unlock", "[benchmark]")
+{
+    bench_mutex_contention(
+        "benchmark mutex contention lifo inline unlock", coro::resume_order_policy::lifo, mutex_unlock_mode::inline_resume);
+}
+
+TEST_CASE("benchmark mutex contention fifo inline unlock", "[benchmark]")
+{
+    bench_mutex_contention(
+        "benchmark mutex contention fifo inline unlock", coro::resume_order_policy::fifo, mutex_unlock_mode::inline_resume);
+}
+
+TEST_CASE("benchmark mutex contention lifo executor unlock", "[benchmark]")
+{
+    bench_mutex_contention(
+        "benchmark mutex contention lifo executor unlock", coro::resume_order_policy::lifo, mutex_unlock_mode::executor);
+}
+
+TEST_CASE("benchmark mutex contention fifo executor unlock", "[benchmark]")
+{
+    bench_mutex_contention(
+        "benchmark mutex contention fifo executor unlock", coro::resume_order_policy::fifo, mutex_unlock_mode::executor);
+}
+
 #ifdef LIBCORO_FEATURE_NETWORKING
 TEST_CASE("benchmark tcp::server echo server thread pool", "[benchmark]")
 {
@@ -0,0 +1,208 @@
+#include "catch_amalgamated.hpp"
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+    #include <coro/coro.hpp>
+
+    #include <iostream>
+    #include <string_view>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("buffer_pool", "[buffer_pool]")
+{
+    std::cerr << "[buffer_pool]\n\n";
+}
+
+TEST_CASE("buffer_pool shares buffers between connections", "[buffer_pool]")
+{
+    constexpr std::size_t connections = 8;
+    auto                  scheduler   = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+    coro::net::buffer_pool pool{scheduler, coro::net::buffer_pool::options{.buffer_size = 64, .buffer_count = 2}};
+
+    auto make_task = [](std::unique_ptr<coro::io_scheduler>& scheduler, coro::net::buffer_pool& pool)
+        -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler, coro::net::tcp::server::options{.port = 8082}};
+
+        std::vector<coro::net::tcp::client> clients{};
+        std::vector<coro::net::tcp::client> peers{};
+        for (std::size_t i = 0; i < connections; ++i)
+        {
+            clients.emplace_back(scheduler, coro::net::tcp::client::options{.port = 8082});
+            auto cstatus = co_await clients.back().async_connect(1s);
+            REQUIRE(cstatus == coro::net::connect_status::connected);
+            peers.emplace_back(co_await server.async_accept(1s));
+            REQUIRE(peers.back().socket().is_valid());
+        }
+
+        // Far more connections than buffers, each only holds a buffer while it processes its data.
+        for (std::size_t i = 0; i < connections; ++i)
+        {
+            auto msg                  = std::string{"message "} + std::to_string(i);
+            auto [sstatus, remaining] = co_await clients[i].async_send(msg);
+            REQUIRE(sstatus == coro::net::send_status::ok);
+
+            auto [rstatus, buffer] = co_await peers[i].async_recv(pool, 1s);
+            REQUIRE(rstatus == coro::net::recv_status::ok);
+            REQUIRE(std::string_view{buffer.data().data(), buffer.size()} == msg);
+            REQUIRE(pool.available() == 1);
+        }
+        REQUIRE(pool.available() == 2);
+
+        // Holding every buffer exhausts the pool for the other connections.
+        auto [s1, remaining1] = co_await clients[0].async_send(std::string{"a"});
+        auto [s2, remaining2] = co_await clients[1].async_send(std::string{"b"});
+        auto [s3, remaining3] = co_await clients[2].async_send(std::string{"c"});
+        REQUIRE(s1 == coro::net::send_status::ok);
+        REQUIRE(s2 == coro::net::send_status::ok);
+        REQUIRE(s3 == coro::net::send_status::ok);
+        auto [r1, b1] = co_await peers[0].async_recv(pool, 1s);
+        auto [r2, b2] = co_await peers[1].async_recv(pool, 1s);
+        REQUIRE(r1 == coro::net::recv_status::ok);
+        REQUIRE(r2 == coro::net::recv_status::ok);
+        REQUIRE(pool.available() == 0);
+        auto [r3, b3] = co_await peers[2].async_recv(pool, 50ms);
+        REQUIRE(r3 == coro::net::recv_status::timeout);
+        REQUIRE(b3.empty());
+
+        // A recv waiting for a buffer receives the pending data once a buffer is returned.
+        auto make_release_task = [](std::unique_ptr<coro::io_scheduler>& scheduler,
+                                    coro::net::buffer_pool::buffer&      buffer) -> coro::task<void>
+        {
+            co_await scheduler->yield_for(20ms);
+            buffer.release();
+        };
+        auto results = co_await coro::when_all(peers[2].async_recv(pool, 1s), make_release_task(scheduler, b1));
+        auto [r4, b4] = std::move(std::get<0>(results).return_value());
+        REQUIRE(r4 == coro::net::recv_status::ok);
+        REQUIRE(std::string_view{b4.data().data(), b4.size()} == "c");
+        REQUIRE(pool.available() == 0);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(scheduler, pool));
+    REQUIRE(pool.available() == 2);
+}
+
+TEST_CASE("buffer_pool recv times out and reports closed connections", "[buffer_pool]")
+{
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+    coro::net::buffer_pool pool{scheduler, coro::net::buffer_pool::options{.buffer_size = 64, .buffer_count = 4}};
+
+    auto make_task = [](std::unique_ptr<coro::io_scheduler>& scheduler, coro::net::buffer_pool& pool)
+        -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler, coro::net::tcp::server::options{.port = 8083}};
+
+        auto client  = std::make_unique<coro::net::tcp::client>(
+            scheduler, coro::net::tcp::client::options{.port = 8083});
+        auto cstatus = co_await client->async_connect(1s);
+        REQUIRE(cstatus == coro::net::connect_status::connected);
+        auto peer = co_await server.async_accept(1s);
+        REQUIRE(peer.socket().is_valid());
+
+        auto [rstatus, buffer] = co_await peer.async_recv(pool, 50ms);
+        REQUIRE(rstatus == coro::net::recv_status::timeout);
+        REQUIRE(pool.available() == 4);
+
+        client.reset();
+        auto [cstatus2, cbuffer] = co_await peer.async_recv(pool, 1s);
+        REQUIRE(cstatus2 == coro::net::recv_status::closed);
+        REQUIRE(pool.available() == 4);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(scheduler, pool));
+}
+
+TEST_CASE("buffer_pool waiting recvs share a single buffer", "[buffer_pool]")
+{
+    constexpr std::size_t waiters   = 4;
+    auto                  scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+    coro::net::buffer_pool pool{scheduler, coro::net::buffer_pool::options{.buffer_size = 64, .buffer_count = 1}};
+
+    auto make_task = [](std::unique_ptr<coro::io_scheduler>& scheduler, coro::net::buffer_pool& pool)
+        -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler, coro::net::tcp::server::options{.port = 8084}};
+
+        std::vector<coro::net::tcp::client> clients{};
+        std::vector<coro::net::tcp::client> peers{};
+        for (std::size_t i = 0; i < waiters + 1; ++i)
+        {
+            clients.emplace_back(scheduler, coro::net::tcp::client::options{.port = 8084});
+            auto cstatus = co_await clients.back().async_connect(1s);
+            REQUIRE(cstatus == coro::net::connect_status::connected);
+            peers.emplace_back(co_await server.async_accept(1s));
+            REQUIRE(peers.back().socket().is_valid());
+
+            auto [sstatus, remaining] = co_await clients.back().async_send(std::to_string(i));
+            REQUIRE(sstatus == coro::net::send_status::ok);
+        }
+
+        // The only buffer is held, every other recv waits for it and passes it on once done.
+        auto [rstatus, held] = co_await peers[0].async_recv(pool, 1s);
+        REQUIRE(rstatus == coro::net::recv_status::ok);
+
+        auto make_recv_task = [](coro::net::tcp::client& peer, coro::net::buffer_pool& pool) -> coro::task<std::string>
+        {
+            auto [rstatus, buffer] = co_await peer.async_recv(pool, 5s);
+            REQUIRE(rstatus == coro::net::recv_status::ok);
+            co_return std::string{buffer.data().data(), buffer.size()};
+        };
+        auto make_release_task = [](std::unique_ptr<coro::io_scheduler>&  scheduler,
+                                    coro::net::buffer_pool::buffer& buffer) -> coro::task<std::string>
+        {
+            co_await scheduler->yield_for(20ms);
+            buffer.release();
+            co_return std::string{};
+        };
+
+        std::vector<coro::task<std::string>> tasks{};
+        for (std::size_t i = 1; i < waiters + 1; ++i)
+        {
+            tasks.emplace_back(make_recv_task(peers[i], pool));
+        }
+        tasks.emplace_back(make_release_task(scheduler, held));
+        auto results = co_await coro::when_all(std::move(tasks));
+        for (std::size_t i = 1; i < waiters + 1; ++i)
+        {
+            REQUIRE(results[i - 1].return_value() == std::to_string(i));
+        }
+        REQUIRE(pool.available() == 1);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(scheduler, pool));
+}
+
+TEST_CASE("buffer_pool rejects more buffers than a provided buffer ring holds", "[buffer_pool]")
+{
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    REQUIRE_THROWS_AS(
+        (coro::net::buffer_pool{
+            scheduler,
+            coro::net::buffer_pool::options{
+                .buffer_size = 64, .buffer_count = coro::net::buffer_pool::max_buffer_count + 1}}),
+        std::runtime_error);
+    coro::net::buffer_pool pool{
+        scheduler,
+        coro::net::buffer_pool::options{.buffer_size = 64, .buffer_count = coro::net::buffer_pool::max_buffer_count}};
+    REQUIRE(pool.available() == coro::net::buffer_pool::max_buffer_count);
+}
+
+TEST_CASE("~buffer_pool", "[buffer_pool]")
+{
+    std::cerr << "[~buffer_pool]\n\n";
+}
+
+#endif // LIBCORO_FEATURE_NETWORKING
@@ -184,6 +184,107 @@ TEST_CASE("tcp_server concurrent polling on the same socket", "[tcp_server]")
     std::cerr << "END tcp_server concurrent polling on the same socket\n";
 }
 
+TEST_CASE("tcp_server async ping server", "[tcp_server]")
+{
+    std::cerr << "BEGIN tcp_server async ping server\n";
+    const std::string client_msg{"Hello from client"};
+    const std::string server_msg{"Reply from server!"};
+
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_client_task = [](std::unique_ptr<coro::io_scheduler>& scheduler,
+                               const std::string&                   client_msg,
+                               const std::string&                   server_msg) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::client client{scheduler};
+
+        auto cstatus = co_await client.async_connect();
+        REQUIRE(cstatus == coro::net::connect_status::connected);
+
+        auto [sstatus, remaining] = co_await client.async_send(client_msg);
+        REQUIRE(sstatus == coro::net::send_status::ok);
+        REQUIRE(remaining.empty());
+
+        // No poll is needed, the recv completes once the server's response arrives.
+        std::string buffer(256, '\0');
+        auto [rstatus, rspan] = co_await client.async_recv(buffer);
+        REQUIRE(rstatus == coro::net::recv_status::ok);
+        REQUIRE(rspan.size() == server_msg.length());
+        buffer.resize(rspan.size());
+        REQUIRE(buffer == server_msg);
+
+        // The server closes the connection after responding.
+        buffer.resize(256);
+        auto [closed_status, closed_span] = co_await client.async_recv(buffer);
+        REQUIRE(closed_status == coro::net::recv_status::closed);
+        REQUIRE(closed_span.empty());
+        co_return;
+    };
+
+    auto make_server_task = [](std::unique_ptr<coro::io_scheduler>& scheduler,
+                               const std::string&                   client_msg,
+                               const std::string&                   server_msg) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler};
+
+        auto client = co_await server.async_accept();
+        REQUIRE(client.socket().is_valid());
+
+        std::string buffer(256, '\0');
+        auto [rstatus, rspan] = co_await client.async_recv(buffer);
+        REQUIRE(rstatus == coro::net::recv_status::ok);
+        REQUIRE(rspan.size() == client_msg.size());
+        buffer.resize(rspan.size());
+        REQUIRE(buffer == client_msg);
+
+        auto [sstatus, remaining] = co_await client.async_send(server_msg);
+        REQUIRE(sstatus == coro::net::send_status::ok);
+        REQUIRE(remaining.empty());
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(
+        make_server_task(scheduler, client_msg, server_msg), make_client_task(scheduler, client_msg, server_msg)));
+    std::cerr << "END tcp_server async ping server\n";
+}
+
+TEST_CASE("tcp_server async operations time out", "[tcp_server]")
+{
+    using namespace std::chrono_literals;
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_task = [](std::unique_ptr<coro::io_scheduler>& scheduler) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler, coro::net::tcp::server::options{.port = 8081}};
+
+        // Nobody connects, the accept must give up after its timeout.
+        auto start    = std::chrono::steady_clock::now();
+        auto rejected = co_await server.async_accept(50ms);
+        REQUIRE_FALSE(rejected.socket().is_valid());
+        REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+
+        coro::net::tcp::client client{scheduler, coro::net::tcp::client::options{.port = 8081}};
+        auto                   cstatus = co_await client.async_connect(1s);
+        REQUIRE(cstatus == coro::net::connect_status::connected);
+        auto accepted = co_await server.async_accept(1s);
+        REQUIRE(accepted.socket().is_valid());
+
+        // The server never sends anything, the recv must give up after its timeout.
+        std::string buffer(64, '\0');
+        auto [rstatus, rspan] = co_await client.async_recv(buffer, 50ms);
+        REQUIRE(rstatus == coro::net::recv_status::timeout);
+        REQUIRE(rspan.empty());
+        co_return;
+    };
+
+    coro::sync_wait(make_task(scheduler));
+}
+
     #ifndef __APPLE__
 // This test is known to not work on kqueue style systems (e.g. apple) because the socket shutdown()
 // call does not properly trigger an EV_EOF flag on the accept socket.
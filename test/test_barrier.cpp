@@ -0,0 +1,186 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+#include <thread>
+
+TEST_CASE("barrier", "[barrier]")
+{
+    std::cerr << "[barrier]\n\n";
+}
+
+TEST_CASE("barrier single phase", "[barrier]")
+{
+    coro::barrier         b{3};
+    std::atomic<uint64_t> arrived{0};
+
+    auto make_task = [](coro::barrier<>& b, std::atomic<uint64_t>& arrived) -> coro::task<uint64_t>
+    {
+        arrived++;
+        co_await b.arrive_and_wait();
+        // Nobody passes the barrier until everyone has arrived.
+        co_return arrived.load();
+    };
+
+    auto t1 = make_task(b, arrived);
+    auto t2 = make_task(b, arrived);
+    auto t3 = make_task(b, arrived);
+
+    t1.resume();
+    t2.resume();
+    REQUIRE_FALSE(t1.is_ready());
+    REQUIRE_FALSE(t2.is_ready());
+    REQUIRE(b.phase() == 0);
+
+    t3.resume();
+    REQUIRE(t1.is_ready());
+    REQUIRE(t2.is_ready());
+    REQUIRE(t3.is_ready());
+    REQUIRE(t1.promise().result() == 3);
+    REQUIRE(t2.promise().result() == 3);
+    REQUIRE(t3.promise().result() == 3);
+    REQUIRE(b.phase() == 1);
+}
+
+TEST_CASE("barrier many phases with completion", "[barrier]")
+{
+    const uint64_t        workers = 4;
+    const uint64_t        phases  = 100;
+    std::atomic<uint64_t> steps{0};
+    uint64_t              completions{0};
+    std::atomic<uint64_t> early{0};
+
+    auto completion = [&]() noexcept
+    {
+        // Runs exactly once per phase after every worker finished the phase's step.
+        if (steps.load() != workers * (completions + 1))
+        {
+            early++;
+        }
+        ++completions;
+    };
+
+    auto          tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    coro::barrier b{static_cast<std::ptrdiff_t>(workers), completion};
+
+    auto make_worker = [&](std::unique_ptr<coro::thread_pool>& tp) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 0; i < phases; ++i)
+        {
+            steps++;
+            co_await b.arrive_and_wait(tp);
+            if (steps.load() < workers * (i + 1))
+            {
+                early++;
+            }
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t i = 0; i < workers; ++i)
+    {
+        tasks.emplace_back(make_worker(tp));
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(early == 0);
+    REQUIRE(completions == phases);
+    REQUIRE(b.phase() == phases);
+}
+
+TEST_CASE("barrier arrive_and_drop", "[barrier]")
+{
+    coro::barrier b{3};
+
+    auto make_dropping_task = [](coro::barrier<>& b) -> coro::task<void>
+    {
+        co_await b.arrive_and_wait();
+        b.arrive_and_drop();
+        co_return;
+    };
+
+    auto make_task = [](coro::barrier<>& b) -> coro::task<void>
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            co_await b.arrive_and_wait();
+        }
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_dropping_task(b), make_task(b), make_task(b)));
+
+    REQUIRE(b.phase() == 3);
+    REQUIRE(b.expected() == 2);
+}
+
+TEST_CASE("barrier arrive_and_wait resumes waiters on executor", "[barrier]")
+{
+    auto            tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::barrier   b{2};
+    std::thread::id waiter_thread{};
+
+    auto make_waiter = [](coro::barrier<>& b, std::thread::id& waiter_thread) -> coro::task<void>
+    {
+        co_await b.arrive_and_wait();
+        waiter_thread = std::this_thread::get_id();
+        co_return;
+    };
+
+    auto waiter = make_waiter(b, waiter_thread);
+    waiter.resume();
+    REQUIRE_FALSE(waiter.is_ready());
+
+    auto make_last = [](std::unique_ptr<coro::thread_pool>& tp, coro::barrier<>& b) -> coro::task<void>
+    {
+        co_await b.arrive_and_wait(tp);
+        co_return;
+    };
+    coro::sync_wait(make_last(tp, b));
+    tp->shutdown();
+
+    REQUIRE(waiter.is_ready());
+    REQUIRE(waiter_thread != std::this_thread::get_id());
+}
+
+TEST_CASE("barrier arrive_and_wait refused by a shutdown executor", "[barrier]")
+{
+    auto          tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::barrier b{2};
+    tp->shutdown();
+
+    auto make_waiter = [](coro::barrier<>& b) -> coro::task<void>
+    {
+        co_await b.arrive_and_wait();
+        co_return;
+    };
+
+    auto waiter = make_waiter(b);
+    waiter.resume();
+    REQUIRE_FALSE(waiter.is_ready());
+
+    auto make_last = [](std::unique_ptr<coro::thread_pool>& tp, coro::barrier<>& b) -> coro::task<void>
+    {
+        co_await b.arrive_and_wait(tp);
+        co_return;
+    };
+    coro::sync_wait(make_last(tp, b));
+
+    // The executor refused the phase's waiters so they were resumed inline instead of being lost.
+    REQUIRE(waiter.is_ready());
+    REQUIRE(b.phase() == 1);
+}
+
+TEST_CASE("barrier rejects a non-positive expected count", "[barrier]")
+{
+    REQUIRE_THROWS_AS(coro::barrier{0}, std::invalid_argument);
+    REQUIRE_THROWS_AS(coro::barrier{-1}, std::invalid_argument);
+}
+
+TEST_CASE("~barrier", "[barrier]")
+{
+    std::cerr << "[~barrier]\n\n";
+}
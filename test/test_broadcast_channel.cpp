@@ -0,0 +1,294 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+
+TEST_CASE("broadcast_channel", "[broadcast_channel]")
+{
+    std::cerr << "[broadcast_channel]\n\n";
+}
+
+TEST_CASE("broadcast_channel every subscriber receives every element", "[broadcast_channel]")
+{
+    const uint64_t                       iterations  = 100;
+    const size_t                         subscribers = 5;
+    coro::broadcast_channel<uint64_t, 8> ch{};
+    auto tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    auto make_subscriber_task = [](std::unique_ptr<coro::thread_pool>&               tp,
+                                   coro::broadcast_channel<uint64_t, 8>::subscriber& sub) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        uint64_t sum{0};
+        uint64_t previous{0};
+        while (true)
+        {
+            auto result = co_await sub.consume();
+            if (!result)
+            {
+                break;
+            }
+            REQUIRE(*result == previous + 1);
+            previous = *result;
+            sum += *result;
+        }
+        co_return sum;
+    };
+
+    auto make_producer_task =
+        [](std::unique_ptr<coro::thread_pool>& tp, coro::broadcast_channel<uint64_t, 8>& ch, uint64_t iterations)
+        -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 1; i <= iterations; ++i)
+        {
+            auto result = co_await ch.produce(i);
+            REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        }
+        ch.shutdown();
+        co_return;
+    };
+
+    // Subscribe before producing so every subscriber observes every element.
+    std::vector<std::unique_ptr<coro::broadcast_channel<uint64_t, 8>::subscriber>> subs{};
+    std::vector<coro::task<uint64_t>>                                             tasks{};
+    for (size_t i = 0; i < subscribers; ++i)
+    {
+        subs.emplace_back(std::make_unique<coro::broadcast_channel<uint64_t, 8>::subscriber>(ch));
+        tasks.emplace_back(make_subscriber_task(tp, *subs.back()));
+    }
+    REQUIRE(ch.subscriber_count() == subscribers);
+
+    auto [sums, produced] =
+        coro::sync_wait(coro::when_all(coro::when_all(std::move(tasks)), make_producer_task(tp, ch, iterations)));
+    (void)produced;
+
+    for (auto& sum : sums.return_value())
+    {
+        REQUIRE(sum.return_value() == iterations * (iterations + 1) / 2);
+    }
+}
+
+TEST_CASE("broadcast_channel drop_oldest skips lagging subscriber", "[broadcast_channel]")
+{
+    coro::broadcast_channel<uint64_t, 4> ch{coro::broadcast_lag_policy::drop_oldest};
+    auto                                 fast = ch.subscribe();
+    auto                                 slow = ch.subscribe();
+
+    auto make_task = [](coro::broadcast_channel<uint64_t, 4>&             ch,
+                        coro::broadcast_channel<uint64_t, 4>::subscriber& fast,
+                        coro::broadcast_channel<uint64_t, 4>::subscriber& slow) -> coro::task<void>
+    {
+        for (uint64_t i = 1; i <= 4; ++i)
+        {
+            co_await ch.produce(i);
+            auto value = co_await fast.consume();
+            REQUIRE(*value == i);
+        }
+
+        // The ring is full for the slow subscriber, these overwrite elements 1 and 2.
+        std::vector<uint64_t> batch{5, 6};
+        auto                  result = co_await ch.produce_range(batch);
+        REQUIRE(result == coro::ring_buffer_result::produce::produced);
+
+        REQUIRE(slow.dropped() == 2);
+        REQUIRE(slow.size() == 4);
+        for (uint64_t expected = 3; expected <= 6; ++expected)
+        {
+            auto value = co_await slow.consume();
+            REQUIRE(*value == expected);
+        }
+
+        REQUIRE(fast.dropped() == 0);
+        REQUIRE(fast.size() == 2);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(ch, fast, slow));
+}
+
+TEST_CASE("broadcast_channel block_producer waits for slowest subscriber", "[broadcast_channel]")
+{
+    coro::broadcast_channel<uint64_t, 2> ch{coro::broadcast_lag_policy::block_producer};
+    auto                                 sub = ch.subscribe();
+    std::atomic<uint64_t>                produced{0};
+
+    auto make_producer_task = [](coro::broadcast_channel<uint64_t, 2>& ch, std::atomic<uint64_t>& produced)
+        -> coro::task<void>
+    {
+        std::vector<uint64_t> batch{1, 2, 3, 4, 5};
+        auto                  result = co_await ch.produce_range(std::move(batch));
+        REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        produced = 5;
+        co_return;
+    };
+
+    auto make_consumer_task = [](coro::broadcast_channel<uint64_t, 2>::subscriber& sub,
+                                 std::atomic<uint64_t>&                            produced) -> coro::task<void>
+    {
+        for (uint64_t i = 1; i <= 5; ++i)
+        {
+            // The producer can never be more than the ring size ahead.
+            REQUIRE(sub.size() <= 2);
+            auto value = co_await sub.consume();
+            REQUIRE(*value == i);
+        }
+        REQUIRE(produced == 5);
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_producer_task(ch, produced), make_consumer_task(sub, produced)));
+}
+
+TEST_CASE("broadcast_channel unsubscribe releases blocked producer", "[broadcast_channel]")
+{
+    coro::broadcast_channel<uint64_t, 1> ch{};
+    auto                                 sub = std::make_unique<coro::broadcast_channel<uint64_t, 1>::subscriber>(ch);
+
+    auto make_producer_task = [](coro::broadcast_channel<uint64_t, 1>& ch) -> coro::task<void>
+    {
+        co_await ch.produce(1);
+        co_await ch.produce(2);
+        co_return;
+    };
+
+    auto make_unsubscribe_task =
+        [](std::unique_ptr<coro::broadcast_channel<uint64_t, 1>::subscriber>& sub) -> coro::task<void>
+    {
+        sub.reset();
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_producer_task(ch), make_unsubscribe_task(sub)));
+    REQUIRE(ch.subscriber_count() == 0);
+}
+
+TEST_CASE("broadcast_channel subscriber only observes elements produced after subscribing", "[broadcast_channel]")
+{
+    coro::broadcast_channel<uint64_t, 4> ch{};
+    auto                                 early = ch.subscribe();
+
+    auto make_task = [](coro::broadcast_channel<uint64_t, 4>&             ch,
+                        coro::broadcast_channel<uint64_t, 4>::subscriber& early) -> coro::task<void>
+    {
+        co_await ch.produce(1);
+
+        coro::broadcast_channel<uint64_t, 4>::subscriber late{ch};
+        co_await ch.produce(2);
+        ch.shutdown();
+
+        auto result = co_await late.consume();
+        REQUIRE(*result == 2);
+        result = co_await late.consume();
+        REQUIRE(result.error() == coro::ring_buffer_result::consume::stopped);
+
+        result = co_await early.consume();
+        REQUIRE(*result == 1);
+        result = co_await early.consume();
+        REQUIRE(*result == 2);
+        result = co_await early.consume();
+        REQUIRE_FALSE(result.has_value());
+        co_return;
+    };
+
+    coro::sync_wait(make_task(ch, early));
+}
+
+TEST_CASE("broadcast_channel multiple producers across threads", "[broadcast_channel]")
+{
+    const uint64_t producers   = 4;
+    const uint64_t iterations  = 5'000;
+    const size_t   subscribers = 3;
+    auto tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    for (auto policy : {coro::broadcast_lag_policy::block_producer, coro::broadcast_lag_policy::drop_oldest})
+    {
+        coro::broadcast_channel<uint64_t, 16> ch{policy};
+
+        // Each element encodes its producer and its position, every producer's elements must arrive in order.
+        auto make_subscriber_task = [](std::unique_ptr<coro::thread_pool>&                  tp,
+                                       coro::broadcast_channel<uint64_t, 16>::subscriber& sub,
+                                       uint64_t producers) -> coro::task<std::pair<uint64_t, bool>>
+        {
+            co_await tp->schedule();
+            std::vector<uint64_t> next(producers, 0);
+            uint64_t              received{0};
+            bool                  ordered{true};
+            while (true)
+            {
+                auto result = co_await sub.consume();
+                if (!result)
+                {
+                    break;
+                }
+                auto producer = *result % producers;
+                auto position = *result / producers;
+                ordered       = ordered && position >= next[producer];
+                next[producer] = position + 1;
+                ++received;
+            }
+            co_return std::pair{received, ordered};
+        };
+
+        auto make_producer_task = [](std::unique_ptr<coro::thread_pool>&      tp,
+                                     coro::broadcast_channel<uint64_t, 16>& ch,
+                                     uint64_t                                producer,
+                                     uint64_t                                producers,
+                                     uint64_t                                iterations) -> coro::task<uint64_t>
+        {
+            co_await tp->schedule();
+            uint64_t produced{0};
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                if (co_await ch.produce(i * producers + producer) == coro::ring_buffer_result::produce::produced)
+                {
+                    ++produced;
+                }
+            }
+            co_return produced;
+        };
+
+        auto make_shutdown_task = [](coro::broadcast_channel<uint64_t, 16>& ch,
+                                     std::vector<coro::task<uint64_t>>      producer_tasks) -> coro::task<uint64_t>
+        {
+            auto     results = co_await coro::when_all(std::move(producer_tasks));
+            uint64_t produced{0};
+            for (auto& t : results)
+            {
+                produced += t.return_value();
+            }
+            ch.shutdown();
+            co_return produced;
+        };
+
+        std::vector<std::unique_ptr<coro::broadcast_channel<uint64_t, 16>::subscriber>> subs{};
+        std::vector<coro::task<std::pair<uint64_t, bool>>>                              tasks{};
+        for (size_t i = 0; i < subscribers; ++i)
+        {
+            subs.emplace_back(std::make_unique<coro::broadcast_channel<uint64_t, 16>::subscriber>(ch));
+            tasks.emplace_back(make_subscriber_task(tp, *subs.back(), producers));
+        }
+
+        std::vector<coro::task<uint64_t>> producer_tasks{};
+        for (uint64_t p = 0; p < producers; ++p)
+        {
+            producer_tasks.emplace_back(make_producer_task(tp, ch, p, producers, iterations));
+        }
+
+        auto [results, produced] = coro::sync_wait(
+            coro::when_all(coro::when_all(std::move(tasks)), make_shutdown_task(ch, std::move(producer_tasks))));
+        REQUIRE(produced.return_value() == producers * iterations);
+
+        for (size_t i = 0; i < subscribers; ++i)
+        {
+            auto [received, ordered] = results.return_value()[i].return_value();
+            REQUIRE(ordered);
+            REQUIRE(received + subs[i]->dropped() == producers * iterations);
+            if (policy == coro::broadcast_lag_policy::block_producer)
+            {
+                REQUIRE(subs[i]->dropped() == 0);
+            }
+        }
+    }
+}
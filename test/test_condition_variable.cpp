@@ -150,6 +150,47 @@ TEST_CASE("wait(lock predicate) 1 waiter notify_one until predicate passes", "[c
     std::cerr << "END condition_variable wait(lock predicate) 1 waiter notify_one until predicate passes\n";
 }
 
+TEST_CASE("wait(lock predicate) move only predicate stored inline", "[condition_variable]")
+{
+    std::cerr << "BEGIN condition_variable wait(lock predicate) move only predicate stored inline\n";
+
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::condition_variable cv{};
+    coro::mutex m{};
+    std::atomic<int64_t> counter{0};
+
+    auto make_waiter = [](coro::condition_variable& cv, coro::mutex& m, std::atomic<int64_t>& counter) -> coro::task<int64_t>
+    {
+        auto lk = co_await m.scoped_lock();
+        // A std::function cannot hold a move only callable, the predicate awaiter stores it as is.
+        auto predicate = [&counter, calls = std::make_unique<int64_t>(0)]() mutable -> bool
+        {
+            ++(*calls);
+            return counter == 3 && *calls == 4;
+        };
+        co_await cv.wait(lk, std::move(predicate));
+        co_return 42;
+    };
+
+    auto make_notifier = [](std::unique_ptr<coro::io_scheduler>& s, coro::condition_variable& cv, std::atomic<int64_t>& counter) -> coro::task<int64_t>
+    {
+        co_await s->yield_for(std::chrono::milliseconds{10});
+        for (size_t i = 0; i < 3; ++i)
+        {
+            counter++;
+            co_await cv.notify_all();
+        }
+        co_return 0;
+    };
+
+    auto results = coro::sync_wait(coro::when_all(make_waiter(cv, m, counter), make_notifier(s, cv, counter)));
+    REQUIRE(std::get<0>(results).return_value() == 42);
+    REQUIRE(std::get<1>(results).return_value() == 0);
+
+    std::cerr << "END condition_variable wait(lock predicate) move only predicate stored inline\n";
+}
+
 TEST_CASE("wait(lock predicate) 1 waiter predicate notify_all until predicate passes", "[condition_variable]")
 {
     std::cerr << "BEGIN condition_variable wait(lock predicate) 1 waiter predicate notify_all until predicate passes\n";
@@ -949,6 +990,36 @@ TEST_CASE("notify_all(executor)", "[condition_variable]")
     std::cerr << "END condition_variable notify_all(executor)\n";
 }
 
+TEST_CASE("notify_all(executor) refused by a shutdown executor", "[condition_variable]")
+{
+    std::cerr << "BEGIN condition_variable notify_all(executor) refused by a shutdown executor\n";
+
+    auto tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    tp->shutdown();
+    coro::condition_variable cv{};
+    coro::mutex m{};
+
+    auto make_waiter = [](coro::condition_variable& cv, coro::mutex& m, int64_t r) -> coro::task<int64_t>
+    {
+        auto lk = co_await m.scoped_lock();
+        co_await cv.wait(lk);
+        co_return r;
+    };
+
+    auto make_notifier = [](std::unique_ptr<coro::thread_pool>& tp, coro::condition_variable& cv) -> coro::task<int64_t>
+    {
+        // The executor refuses the batch so the waiters must be resumed inline instead of being lost.
+        cv.notify_all(tp);
+        co_return 0;
+    };
+
+    auto results = coro::sync_wait(coro::when_all(make_waiter(cv, m, 1), make_waiter(cv, m, 2), make_notifier(tp, cv)));
+    REQUIRE(std::get<0>(results).return_value() == 1);
+    REQUIRE(std::get<1>(results).return_value() == 2);
+
+    std::cerr << "END condition_variable notify_all(executor) refused by a shutdown executor\n";
+}
+
 TEST_CASE("notify_one(executor)", "[condition_variable]")
 {
     std::cerr << "BEGIN condition_variable notify_one(executor)\n";
@@ -1010,6 +1081,85 @@ TEST_CASE("notify_one(executor)", "[condition_variable]")
     std::cerr << "END condition_variable notify_one(executor)\n";
 }
 
+TEST_CASE("wait_for(s lock duration) notify releases the timer immediately", "[condition_variable]")
+{
+    std::cerr << "BEGIN condition_variable wait_for(s lock duration) notify releases the timer immediately\n";
+
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::condition_variable cv{};
+    coro::mutex m{};
+
+    auto make_waiter = [](std::unique_ptr<coro::io_scheduler>& s, coro::condition_variable& cv, coro::mutex& m) -> coro::task<int64_t>
+    {
+        auto lk = co_await m.scoped_lock();
+        auto status = co_await cv.wait_for(s, lk, std::chrono::seconds{30});
+        co_return (status == std::cv_status::no_timeout) ? 1 : -1;
+    };
+
+    auto make_notifier = [](std::unique_ptr<coro::io_scheduler> &s, coro::condition_variable& cv) -> coro::task<int64_t>
+    {
+        co_await s->yield_for(std::chrono::milliseconds{10});
+        co_await cv.notify_one();
+        co_return 0;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = coro::sync_wait(coro::when_all(make_waiter(s, cv, m), make_notifier(s, cv)));
+    REQUIRE(std::get<0>(results).return_value() == 1);
+
+    // Nothing is left waiting on the 30 second timeout.
+    REQUIRE(s->empty());
+    s->shutdown();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds{5});
+
+    std::cerr << "END condition_variable wait_for(s lock duration) notify releases the timer immediately\n";
+}
+
+TEST_CASE("wait_for(s lock duration predicate) many waiters racing notify and timeout", "[condition_variable]")
+{
+    std::cerr << "BEGIN condition_variable wait_for(s lock duration predicate) many waiters racing notify and timeout\n";
+
+    const uint64_t waiters = 100;
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .pool = coro::thread_pool::options{.thread_count = 4}});
+    coro::condition_variable cv{};
+    coro::mutex m{};
+    std::atomic<uint64_t> counter{0};
+
+    auto make_waiter = [](std::unique_ptr<coro::io_scheduler>& s, coro::condition_variable& cv, coro::mutex& m, std::atomic<uint64_t>& counter, uint64_t id) -> coro::task<void>
+    {
+        co_await s->schedule();
+        auto lk = co_await m.scoped_lock();
+        // Half the waiters can never pass their predicate and must time out.
+        co_await cv.wait_for(s, lk, std::chrono::milliseconds{1 + id % 5}, [&counter, id]() -> bool { return id % 2 == 0 && counter > 0; });
+        REQUIRE_FALSE(m.try_lock());
+        co_return;
+    };
+
+    auto make_notifier = [](std::unique_ptr<coro::io_scheduler>& s, coro::condition_variable& cv, std::atomic<uint64_t>& counter) -> coro::task<void>
+    {
+        co_await s->schedule();
+        counter = 1;
+        for (size_t i = 0; i < 20; ++i)
+        {
+            co_await cv.notify_all();
+            co_await s->yield_for(std::chrono::microseconds{250});
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t i = 0; i < waiters; ++i)
+    {
+        tasks.emplace_back(make_waiter(s, cv, m, counter, i));
+    }
+    tasks.emplace_back(make_notifier(s, cv, counter));
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    std::cerr << "END condition_variable wait_for(s lock duration predicate) many waiters racing notify and timeout\n";
+}
+
 #endif
 
 TEST_CASE("~condition_variable", "[condition_variable]")
@@ -294,6 +294,67 @@ TEST_CASE("event fifo single executor", "[event]")
     REQUIRE(counter == 1);
 }
 
+TEST_CASE("event set executor wakes many waiters", "[event]")
+{
+    const uint64_t        count = 10'000;
+    coro::event           e{};
+    auto                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    std::atomic<uint64_t> counter{0};
+
+    auto make_waiter = [](std::unique_ptr<coro::thread_pool>& tp, coro::event& e, std::atomic<uint64_t>& counter)
+        -> coro::task<void>
+    {
+        co_await tp->schedule();
+        co_await e;
+        counter++;
+        co_return;
+    };
+
+    auto make_setter = [](std::unique_ptr<coro::thread_pool>& tp, coro::event& e) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        e.set(tp);
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    tasks.reserve(count + 1);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        tasks.emplace_back(make_waiter(tp, e, counter));
+    }
+    tasks.emplace_back(make_setter(tp, e));
+
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(counter == count);
+}
+
+TEST_CASE("event set executor refused by a shutdown executor", "[event]")
+{
+    coro::event           e{};
+    auto                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    std::atomic<uint64_t> counter{0};
+    tp->shutdown();
+
+    auto make_waiter = [](coro::event& e, std::atomic<uint64_t>& counter) -> coro::task<void>
+    {
+        co_await e;
+        counter++;
+        co_return;
+    };
+
+    auto make_setter = [](std::unique_ptr<coro::thread_pool>& tp, coro::event& e) -> coro::task<void>
+    {
+        // The executor refuses the batch so the waiters must be resumed inline instead of being lost.
+        e.set(tp);
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_waiter(e, counter), make_waiter(e, counter), make_setter(tp, e)));
+    REQUIRE(counter == 2);
+}
+
 TEST_CASE("~event", "[event]")
 {
     std::cerr << "[~event]\n\n";
@@ -21,6 +21,17 @@ TEST_CASE("io_scheduler", "[io_scheduler]")
 using namespace std::chrono_literals;
 using coro::fd_t;
 
+/// Every io notifier backend this build can drive an io_scheduler with, io_uring only falls back to epoll on kernels
+/// without support.
+static const std::vector<coro::io_notifier::backend_t> io_notifier_backends{
+#ifdef LIBCORO_FEATURE_IO_URING
+    coro::io_notifier::backend_t::io_uring,
+    coro::io_notifier::backend_t::epoll
+#else
+    coro::io_notifier::default_backend
+#endif
+};
+
 TEST_CASE("io_scheduler schedule single task", "[io_scheduler]")
 {
     auto s = coro::io_scheduler::make_unique(
@@ -245,6 +256,45 @@ TEST_CASE("io_scheduler separate thread resume", "[io_scheduler]")
     REQUIRE(s2->empty());
 }
 
+TEST_CASE("io_scheduler inline event set executor batch", "[io_scheduler]")
+{
+    const uint64_t count = 1'000;
+    auto           s     = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+                     .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+
+    coro::event           e{};
+    std::atomic<uint64_t> counter{0};
+
+    auto make_waiter = [](std::unique_ptr<coro::io_scheduler>& s, coro::event& e, std::atomic<uint64_t>& counter)
+        -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await e;
+        counter++;
+        co_return;
+    };
+
+    auto make_setter = [](std::unique_ptr<coro::io_scheduler>& s, coro::event& e) -> coro::task<void>
+    {
+        co_await s->schedule();
+        e.set(s, coro::resume_order_policy::fifo);
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        tasks.emplace_back(make_waiter(s, e, counter));
+    }
+    tasks.emplace_back(make_setter(s, e));
+
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+    REQUIRE(counter == count);
+
+    s->shutdown();
+    REQUIRE(s->empty());
+}
+
 TEST_CASE("io_scheduler separate thread resume spawned thread", "[io_scheduler]")
 {
     auto s = coro::io_scheduler::make_unique(
@@ -854,6 +904,659 @@ TEST_CASE("io_scheduler shutdown with background yielding task", "[io_scheduler]
     scheduler->shutdown();
 }
 
+TEST_CASE("timer_wheel expires timers in deadline order across levels", "[io_scheduler]")
+{
+    const auto                epoch = coro::clock::now();
+    coro::detail::timer_wheel wheel{epoch};
+
+    // Deadlines on every level including the overflow list, with two sharing a tick.
+    std::vector<std::chrono::milliseconds> deadlines{
+        0ms, 1ms, 63ms, 64ms, 65ms, 4095ms, 4096ms, 5000ms, 5000ms, 1h, 24h, 24h * 365 * 3};
+    std::vector<std::unique_ptr<coro::detail::poll_info>> infos{};
+    for (auto deadline : deadlines)
+    {
+        infos.emplace_back(std::make_unique<coro::detail::poll_info>());
+        wheel.add(*infos.back(), epoch + deadline);
+        REQUIRE(infos.back()->timer_armed());
+    }
+    REQUIRE(wheel.size() == deadlines.size());
+
+    // A cancelled timer never expires.
+    coro::detail::poll_info cancelled{};
+    wheel.add(cancelled, epoch + 70ms);
+    REQUIRE(wheel.remove(cancelled));
+    REQUIRE_FALSE(wheel.remove(cancelled));
+    REQUIRE_FALSE(cancelled.timer_armed());
+
+    std::vector<coro::detail::poll_info*> expired{};
+    auto                                  now = epoch;
+    while (!wheel.empty())
+    {
+        // The next expiry is never past the earliest remaining deadline.
+        auto next = wheel.next_expiry();
+        REQUIRE(next.has_value());
+        now = std::max(now, next.value());
+        for (auto* pi = wheel.expire(now); pi != nullptr; pi = pi->m_timer_next)
+        {
+            REQUIRE_FALSE(pi->timer_armed());
+            REQUIRE(epoch + deadlines[expired.size()] <= now);
+            expired.emplace_back(pi);
+        }
+    }
+
+    REQUIRE(expired.size() == deadlines.size());
+    for (std::size_t i = 0; i < expired.size(); ++i)
+    {
+        REQUIRE(expired[i] == infos[i].get());
+    }
+    REQUIRE_FALSE(wheel.next_expiry().has_value());
+}
+
+TEST_CASE("timer_wheel expires sub-tick deadlines exactly", "[io_scheduler]")
+{
+    const auto                epoch = coro::clock::now();
+    coro::detail::timer_wheel wheel{epoch};
+
+    // Both deadlines fall within the first tick, and the third one just past it.
+    coro::detail::poll_info early{};
+    coro::detail::poll_info late{};
+    coro::detail::poll_info next_tick{};
+    wheel.add(late, epoch + 750us);
+    wheel.add(early, epoch + 250us);
+    wheel.add(next_tick, epoch + 1100us);
+
+    REQUIRE(wheel.next_expiry() == epoch + 250us);
+    REQUIRE(wheel.expire(epoch + 100us) == nullptr);
+
+    auto* expired = wheel.expire(epoch + 250us);
+    REQUIRE(expired == &early);
+    REQUIRE(expired->m_timer_next == nullptr);
+    REQUIRE(late.timer_armed());
+    REQUIRE(wheel.next_expiry() == epoch + 750us);
+
+    expired = wheel.expire(epoch + 900us);
+    REQUIRE(expired == &late);
+    REQUIRE(expired->m_timer_next == nullptr);
+    REQUIRE(wheel.next_expiry() == epoch + 1100us);
+
+    REQUIRE(wheel.expire(epoch + 1050us) == nullptr);
+    REQUIRE(wheel.expire(epoch + 1100us) == &next_tick);
+    REQUIRE(wheel.empty());
+}
+
+TEST_CASE("io_scheduler poll timeouts cancelled by their event", "[io_scheduler]")
+{
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    std::array<coro::fd_t, 2> trigger_fds{};
+    REQUIRE(::pipe(trigger_fds.data()) == 0);
+
+    auto make_poll_task = [](coro::io_scheduler& scheduler, coro::fd_t fd) -> coro::task<coro::poll_status>
+    {
+        co_await scheduler.schedule();
+        co_return co_await scheduler.poll(fd, coro::poll_op::read, 10s);
+    };
+
+    auto make_trigger_task = [](coro::io_scheduler& scheduler, coro::fd_t fd) -> coro::task<void>
+    {
+        co_await scheduler.schedule();
+        const uint64_t value{42};
+        REQUIRE(::write(fd, &value, sizeof(value)) == sizeof(value));
+        co_return;
+    };
+
+    // Each poll's long timeout is removed when its event wins, the timeouts must not keep the scheduler busy.
+    for (int i = 0; i < 8; ++i)
+    {
+        auto results = coro::sync_wait(coro::when_all(
+            make_poll_task(*scheduler, trigger_fds[0]), make_trigger_task(*scheduler, trigger_fds[1])));
+        REQUIRE(std::get<0>(results).return_value() == coro::poll_status::event);
+
+        uint64_t value{0};
+        REQUIRE(::read(trigger_fds[0], &value, sizeof(value)) == sizeof(value));
+    }
+
+    auto yield_task = [](coro::io_scheduler& scheduler) -> coro::task<void>
+    {
+        co_await scheduler.schedule();
+        co_await scheduler.yield_for(5ms);
+        co_return;
+    };
+    auto start = std::chrono::steady_clock::now();
+    coro::sync_wait(yield_task(*scheduler));
+    REQUIRE(std::chrono::steady_clock::now() - start >= 5ms);
+
+    scheduler->shutdown();
+    REQUIRE(scheduler->empty());
+
+    ::close(trigger_fds[0]);
+    ::close(trigger_fds[1]);
+}
+
+TEST_CASE("io_scheduler poll and yield operations are lazy", "[io_scheduler]")
+{
+    static_assert(coro::concepts::awaiter<coro::io_scheduler::poll_operation>);
+    static_assert(coro::concepts::awaiter<coro::io_scheduler::yield_operation>);
+
+    auto scheduler = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    std::array<coro::fd_t, 2> trigger_fds{};
+    REQUIRE(::pipe(trigger_fds.data()) == 0);
+
+    {
+        // Nothing is watched or armed until the operations are co_await'ed.
+        [[maybe_unused]] auto poll_operation  = scheduler->poll(trigger_fds[0], coro::poll_op::read, 10ms);
+        [[maybe_unused]] auto yield_operation = scheduler->yield_for(10ms);
+        REQUIRE(scheduler->empty());
+    }
+    std::this_thread::sleep_for(20ms);
+    REQUIRE(scheduler->empty());
+
+    auto make_poll_task = [](coro::io_scheduler& scheduler, coro::fd_t fd) -> coro::task<coro::poll_status>
+    {
+        co_await scheduler.schedule();
+        auto poll_operation = scheduler.poll(fd, coro::poll_op::read, 10ms);
+        co_await scheduler.yield_for(20ms);
+        // The timeout only starts once the poll is co_await'ed.
+        auto start  = std::chrono::steady_clock::now();
+        auto status = co_await poll_operation;
+        REQUIRE(std::chrono::steady_clock::now() - start >= 10ms);
+        co_return status;
+    };
+
+    REQUIRE(coro::sync_wait(make_poll_task(*scheduler, trigger_fds[0])) == coro::poll_status::timeout);
+
+    scheduler->shutdown();
+    REQUIRE(scheduler->empty());
+
+    ::close(trigger_fds[0]);
+    ::close(trigger_fds[1]);
+}
+
+TEST_CASE("io_scheduler registered fd latches readiness", "[io_scheduler]")
+{
+    for (auto backend : io_notifier_backends)
+    {
+        auto scheduler = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .pool = coro::thread_pool::options{.thread_count = 1}, .backend = backend});
+
+        std::array<coro::fd_t, 2> fds{};
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds.data()) == 0);
+
+        auto make_task = [](coro::io_scheduler& scheduler, coro::fd_t fd, coro::fd_t peer) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            auto registered = scheduler.register_fd(fd);
+            REQUIRE(registered.fd() == fd);
+
+            // Nothing to read yet, but the socket is writable straight away.
+            auto status = co_await scheduler.poll(registered, coro::poll_op::read, 10ms);
+            REQUIRE(status == coro::poll_status::timeout);
+            status = co_await scheduler.poll(registered, coro::poll_op::write, 1000ms);
+            REQUIRE(status == coro::poll_status::event);
+
+            const char value{'x'};
+            REQUIRE(::write(peer, &value, sizeof(value)) == sizeof(value));
+            status = co_await scheduler.poll(registered, coro::poll_op::read, 1000ms);
+            REQUIRE(status == coro::poll_status::event);
+
+            // The readiness is latched until the read would block and it is cleared.
+            status = co_await scheduler.poll(registered, coro::poll_op::read, 1000ms);
+            REQUIRE(status == coro::poll_status::event);
+            char buffer[8];
+            REQUIRE(::read(fd, buffer, sizeof(buffer)) == 1);
+            REQUIRE(::read(fd, buffer, sizeof(buffer)) == -1);
+            registered.clear(coro::poll_op::read);
+            status = co_await scheduler.poll(registered, coro::poll_op::read, 10ms);
+            REQUIRE(status == coro::poll_status::timeout);
+
+            // A reader and a writer wait on the registration concurrently and are woken independently.
+            auto make_reader_task = [](coro::io_scheduler& scheduler, coro::io_scheduler::registered_fd& registered)
+                -> coro::task<coro::poll_status>
+            { co_return co_await scheduler.poll(registered, coro::poll_op::read, 1000ms); };
+            auto make_writer_task = [](coro::io_scheduler& scheduler, coro::io_scheduler::registered_fd& registered)
+                -> coro::task<coro::poll_status>
+            { co_return co_await scheduler.poll(registered, coro::poll_op::write, 1000ms); };
+            auto make_trigger_task = [](coro::io_scheduler& scheduler, coro::fd_t peer) -> coro::task<void>
+            {
+                co_await scheduler.yield_for(10ms);
+                const char value{'y'};
+                REQUIRE(::write(peer, &value, sizeof(value)) == sizeof(value));
+            };
+
+            auto results = co_await coro::when_all(
+                make_reader_task(scheduler, registered),
+                make_writer_task(scheduler, registered),
+                make_trigger_task(scheduler, peer));
+            REQUIRE(std::get<0>(results).return_value() == coro::poll_status::event);
+            REQUIRE(std::get<1>(results).return_value() == coro::poll_status::event);
+
+            // The peer hanging up wakes a reader even without any data to read.
+            REQUIRE(::read(fd, buffer, sizeof(buffer)) == 1);
+            registered.clear(coro::poll_op::read);
+            ::shutdown(peer, SHUT_WR);
+            status = co_await scheduler.poll(registered, coro::poll_op::read, 1000ms);
+            REQUIRE(status != coro::poll_status::timeout);
+            REQUIRE(::read(fd, buffer, sizeof(buffer)) == 0);
+            co_return;
+        };
+
+        coro::sync_wait(make_task(*scheduler, fds[0], fds[1]));
+
+        scheduler->shutdown();
+        REQUIRE(scheduler->empty());
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+TEST_CASE("io_scheduler poll reader and writer on the same fd", "[io_scheduler]")
+{
+    for (auto backend : io_notifier_backends)
+    {
+        auto scheduler = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .pool = coro::thread_pool::options{.thread_count = 1}, .backend = backend});
+
+        std::array<coro::fd_t, 2> fds{};
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds.data()) == 0);
+
+        // Fill the socket so both directions have to wait.
+        std::array<char, 4096> buffer{};
+        while (::write(fds[0], buffer.data(), buffer.size()) > 0) {}
+
+        auto make_poll_task = [](coro::io_scheduler& scheduler, coro::fd_t fd, coro::poll_op op)
+            -> coro::task<std::pair<coro::poll_status, std::chrono::steady_clock::time_point>>
+        {
+            co_await scheduler.schedule();
+            auto status = co_await scheduler.poll(fd, op, 5000ms);
+            co_return {status, std::chrono::steady_clock::now()};
+        };
+
+        auto make_peer_task = [](coro::io_scheduler& scheduler, coro::fd_t peer) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            // The writer is woken first by draining the peer, the reader must keep waiting until the peer writes.
+            co_await scheduler.yield_for(20ms);
+            std::array<char, 4096> buffer{};
+            while (::read(peer, buffer.data(), buffer.size()) > 0) {}
+            co_await scheduler.yield_for(50ms);
+            REQUIRE(::write(peer, buffer.data(), 1) == 1);
+        };
+
+        auto results = coro::sync_wait(coro::when_all(
+            make_poll_task(*scheduler, fds[0], coro::poll_op::read),
+            make_poll_task(*scheduler, fds[0], coro::poll_op::write),
+            make_peer_task(*scheduler, fds[1])));
+
+        auto [read_status, read_time]   = std::get<0>(results).return_value();
+        auto [write_status, write_time] = std::get<1>(results).return_value();
+        REQUIRE(read_status == coro::poll_status::event);
+        REQUIRE(write_status == coro::poll_status::event);
+        REQUIRE(write_time < read_time);
+
+        // The peer shutting down its write side only closes the read direction, a writer keeps waiting until the
+        // peer drains the socket.
+        while (::write(fds[0], buffer.data(), buffer.size()) > 0) {}
+        auto make_half_close_task = [](coro::io_scheduler& scheduler, coro::fd_t peer) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            co_await scheduler.yield_for(10ms);
+            REQUIRE(::shutdown(peer, SHUT_WR) == 0);
+            co_await scheduler.yield_for(50ms);
+            std::array<char, 4096> buffer{};
+            while (::read(peer, buffer.data(), buffer.size()) > 0) {}
+        };
+        auto start              = std::chrono::steady_clock::now();
+        auto half_close_results = coro::sync_wait(coro::when_all(
+            make_poll_task(*scheduler, fds[0], coro::poll_op::write), make_half_close_task(*scheduler, fds[1])));
+        auto [half_close_status, half_close_time] = std::get<0>(half_close_results).return_value();
+        REQUIRE(half_close_status == coro::poll_status::event);
+        REQUIRE(half_close_time - start >= 50ms);
+
+        scheduler->shutdown();
+        REQUIRE(scheduler->empty());
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+TEST_CASE("io_scheduler perform keeps waiting while the operation would block", "[io_scheduler]")
+{
+    for (auto backend : io_notifier_backends)
+    {
+        auto scheduler = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .pool = coro::thread_pool::options{.thread_count = 1}, .backend = backend});
+
+        // Both descriptors refer to the same socket, the first byte wakes both receives but only one gets it.
+        std::array<coro::fd_t, 2> fds{};
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds.data()) == 0);
+        auto duplicate = ::dup(fds[0]);
+        REQUIRE(duplicate >= 0);
+
+        auto make_recv_task =
+            [](coro::io_scheduler& scheduler, coro::fd_t fd, std::chrono::milliseconds timeout) -> coro::task<int64_t>
+        {
+            co_await scheduler.schedule();
+            char c{0};
+            co_return co_await scheduler.perform(
+                coro::detail::io_operation{
+                    .m_opcode = coro::detail::io_operation::opcode_t::recv,
+                    .m_fd     = fd,
+                    .m_buffer = static_cast<void*>(&c),
+                    .m_length = 1},
+                timeout);
+        };
+
+        auto make_peer_task = [](coro::io_scheduler& scheduler, coro::fd_t peer) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            char c{'x'};
+            co_await scheduler.yield_for(20ms);
+            REQUIRE(::write(peer, &c, 1) == 1);
+            co_await scheduler.yield_for(50ms);
+            REQUIRE(::write(peer, &c, 1) == 1);
+        };
+
+        auto results = coro::sync_wait(coro::when_all(
+            make_recv_task(*scheduler, fds[0], 5000ms),
+            make_recv_task(*scheduler, duplicate, 5000ms),
+            make_peer_task(*scheduler, fds[1])));
+        REQUIRE(std::get<0>(results).return_value() == 1);
+        REQUIRE(std::get<1>(results).return_value() == 1);
+
+        REQUIRE(coro::sync_wait(make_recv_task(*scheduler, fds[0], 20ms)) == -ETIMEDOUT);
+
+        scheduler->shutdown();
+        REQUIRE(scheduler->empty());
+
+        ::close(duplicate);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+#if defined(__linux__)
+TEST_CASE("io_scheduler fixed and adaptive event batch sizes", "[io_scheduler]")
+{
+    // io_uring reaps every completion per wait, the batch options only apply to epoll.
+    constexpr std::size_t pipe_count{32};
+
+    struct batch_case
+    {
+        std::size_t              batch_size;
+        std::size_t              max_batch_size;
+        std::vector<std::size_t> expected_batches;
+    };
+
+    for (const auto& [batch_size, max_batch_size, expected_batches] : {
+             // A max not above the size keeps the batch fixed.
+             batch_case{4, 4, {4, 4, 4, 4, 4, 4, 4, 4}},
+             batch_case{4, 2, {4, 4, 4, 4, 4, 4, 4, 4}},
+             // Full batches double the batch up to the max.
+             batch_case{1, 64, {1, 2, 4, 8, 16, 1}},
+             batch_case{2, 8, {2, 4, 8, 8, 8, 2}}})
+    {
+        coro::detail::io_notifier_epoll notifier{};
+        notifier.resize_event_batch(batch_size, max_batch_size);
+
+        std::vector<std::array<coro::fd_t, 2>> pipes(pipe_count);
+        std::vector<std::unique_ptr<coro::detail::poll_info>> polls{};
+        for (auto& fds : pipes)
+        {
+            REQUIRE(::pipe(fds.data()) == 0);
+            polls.emplace_back(std::make_unique<coro::detail::poll_info>(fds[0], coro::poll_op::read));
+            REQUIRE(notifier.watch(*polls.back()));
+
+            // Every pipe is readable before the first wait so each wait has more events ready than a batch holds.
+            const char value{'x'};
+            REQUIRE(::write(fds[1], &value, sizeof(value)) == sizeof(value));
+        }
+
+        std::vector<std::size_t>                                            batches{};
+        std::vector<std::pair<coro::detail::poll_info*, coro::poll_status>> ready{};
+        for (std::size_t total{0}; total < pipe_count;)
+        {
+            ready.clear();
+            notifier.next_events(ready, 1000ms);
+            REQUIRE_FALSE(ready.empty());
+            batches.emplace_back(ready.size());
+            total += ready.size();
+        }
+        REQUIRE(batches == expected_batches);
+
+        for (auto& fds : pipes)
+        {
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+    }
+
+    // End to end through the scheduler on the epoll backend.
+    auto scheduler = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .pool                 = coro::thread_pool::options{.thread_count = 1},
+        .event_batch_size     = 1,
+        .max_event_batch_size = 64,
+        .backend              = coro::io_notifier::backend_t::epoll});
+
+    std::vector<std::array<coro::fd_t, 2>> pipes(pipe_count);
+    for (auto& fds : pipes)
+    {
+        REQUIRE(::pipe(fds.data()) == 0);
+    }
+
+    std::atomic<std::size_t> events{0};
+    auto make_poll_task = [](coro::io_scheduler& scheduler, coro::fd_t fd, std::atomic<std::size_t>& events)
+        -> coro::task<void>
+    {
+        co_await scheduler.schedule();
+        auto status = co_await scheduler.poll(fd, coro::poll_op::read, 5000ms);
+        if (status == coro::poll_status::event)
+        {
+            events.fetch_add(1, std::memory_order::release);
+        }
+        co_return;
+    };
+    auto make_trigger_task = [](coro::io_scheduler& scheduler, std::vector<std::array<coro::fd_t, 2>>& pipes)
+        -> coro::task<void>
+    {
+        co_await scheduler.yield_for(20ms);
+        const char value{'x'};
+        for (auto& fds : pipes)
+        {
+            REQUIRE(::write(fds[1], &value, sizeof(value)) == sizeof(value));
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (auto& fds : pipes)
+    {
+        tasks.emplace_back(make_poll_task(*scheduler, fds[0], events));
+    }
+    tasks.emplace_back(make_trigger_task(*scheduler, pipes));
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(events.load(std::memory_order::acquire) == pipe_count);
+
+    scheduler->shutdown();
+    for (auto& fds : pipes)
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+#endif
+
+TEST_CASE("io_scheduler busy poll", "[io_scheduler]")
+{
+    for (auto execution_strategy : {coro::io_scheduler::execution_strategy_t::process_tasks_inline,
+                                    coro::io_scheduler::execution_strategy_t::process_tasks_on_thread_pool})
+    {
+        auto scheduler = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+            .pool               = coro::thread_pool::options{.thread_count = 1},
+            .execution_strategy = execution_strategy,
+            .busy_poll_budget   = 2ms});
+
+        std::array<coro::fd_t, 2> trigger_fds{};
+        REQUIRE(::pipe(trigger_fds.data()) == 0);
+
+        auto make_poll_task = [](coro::io_scheduler& scheduler, coro::fd_t fd) -> coro::task<coro::poll_status>
+        {
+            co_await scheduler.schedule();
+            co_return co_await scheduler.poll(fd, coro::poll_op::read, 1000ms);
+        };
+        auto make_trigger_task = [](coro::io_scheduler& scheduler, coro::fd_t fd) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            // Long enough for the event loop to give up spinning and block, the write has to wake it up.
+            co_await scheduler.yield_for(20ms);
+            const uint64_t value{42};
+            REQUIRE(::write(fd, &value, sizeof(value)) == sizeof(value));
+            co_return;
+        };
+        auto make_schedule_task = [](coro::io_scheduler& scheduler) -> coro::task<std::size_t>
+        {
+            std::size_t scheduled{0};
+            for (std::size_t i = 0; i < 100; ++i)
+            {
+                co_await scheduler.schedule();
+                ++scheduled;
+            }
+            co_return scheduled;
+        };
+
+        auto results = coro::sync_wait(coro::when_all(
+            make_poll_task(*scheduler, trigger_fds[0]),
+            make_trigger_task(*scheduler, trigger_fds[1]),
+            make_schedule_task(*scheduler)));
+        REQUIRE(std::get<0>(results).return_value() == coro::poll_status::event);
+        REQUIRE(std::get<2>(results).return_value() == 100);
+
+        // Scheduling from outside the event loop after it went idle must still wake it.
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(coro::sync_wait(make_schedule_task(*scheduler)) == 100);
+
+        // Shutting down with a yield and a poll still pending must wait for them rather than spin forever.
+        uint64_t drained{0};
+        REQUIRE(::read(trigger_fds[0], &drained, sizeof(drained)) == sizeof(drained));
+        std::atomic<std::size_t> completed{0};
+        auto make_pending_yield_task = [](coro::io_scheduler& scheduler, std::atomic<std::size_t>& completed)
+            -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            co_await scheduler.yield_for(100ms);
+            completed.fetch_add(1, std::memory_order::release);
+            co_return;
+        };
+        auto make_pending_poll_task =
+            [](coro::io_scheduler& scheduler, coro::fd_t fd, std::atomic<std::size_t>& completed) -> coro::task<void>
+        {
+            co_await scheduler.schedule();
+            auto status = co_await scheduler.poll(fd, coro::poll_op::read, 100ms);
+            REQUIRE(status == coro::poll_status::timeout);
+            completed.fetch_add(1, std::memory_order::release);
+            co_return;
+        };
+        REQUIRE(scheduler->spawn_detached(make_pending_yield_task(*scheduler, completed)));
+        REQUIRE(scheduler->spawn_detached(make_pending_poll_task(*scheduler, trigger_fds[0], completed)));
+        std::this_thread::sleep_for(10ms);
+
+        auto start = std::chrono::steady_clock::now();
+        scheduler->shutdown();
+        REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+        REQUIRE(completed.load(std::memory_order::acquire) == 2);
+        REQUIRE(scheduler->empty());
+
+        ::close(trigger_fds[0]);
+        ::close(trigger_fds[1]);
+    }
+}
+
+#ifdef LIBCORO_FEATURE_IO_URING
+TEST_CASE("io_notifier_uring discards cancelled polls", "[io_scheduler]")
+{
+    using backend_t = coro::detail::io_notifier_uring::backend_t;
+
+    for (auto preferred : {backend_t::io_uring, backend_t::epoll})
+    {
+        coro::detail::io_notifier_uring notifier{preferred};
+        if (preferred == backend_t::epoll)
+        {
+            REQUIRE(notifier.backend() == backend_t::epoll);
+        }
+
+        std::array<coro::fd_t, 2>                                           trigger_fds{};
+        std::vector<std::pair<coro::detail::poll_info*, coro::poll_status>> ready{};
+        REQUIRE(::pipe(trigger_fds.data()) == 0);
+
+        {
+            // A poll that lost to its timeout is removed, its completion must never be reported.
+            coro::detail::poll_info cancelled{trigger_fds[0], coro::poll_op::read};
+            REQUIRE(notifier.watch(cancelled));
+            REQUIRE(notifier.unwatch(cancelled));
+        }
+
+        const uint64_t value{42};
+        REQUIRE(::write(trigger_fds[1], &value, sizeof(value)) == sizeof(value));
+        notifier.next_events(ready, 50ms);
+        REQUIRE(ready.empty());
+
+        coro::detail::poll_info pi{trigger_fds[0], coro::poll_op::read};
+        REQUIRE(notifier.watch(pi));
+        notifier.next_events(ready, 1000ms);
+        REQUIRE(ready.size() == 1);
+        REQUIRE(ready[0].first == &pi);
+        REQUIRE(ready[0].second == coro::poll_status::event);
+        if (notifier.backend() == backend_t::epoll)
+        {
+            notifier.unwatch(pi);
+        }
+
+        ::close(trigger_fds[0]);
+        ::close(trigger_fds[1]);
+    }
+}
+TEST_CASE("io_scheduler backend option", "[io_scheduler]")
+{
+    using backend_t = coro::io_notifier::backend_t;
+
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .pool = coro::thread_pool::options{.thread_count = 1}, .backend = backend_t::epoll});
+    REQUIRE(s->notifier().backend() == backend_t::epoll);
+
+    std::array<coro::fd_t, 2> trigger_fds{};
+    REQUIRE(::pipe(trigger_fds.data()) == 0);
+
+    auto make_poll_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::fd_t fd) -> coro::task<coro::poll_status>
+    {
+        co_await s->schedule();
+        co_await s->yield_for(5ms);
+        co_return co_await s->poll(fd, coro::poll_op::read, 1000ms);
+    };
+
+    auto make_write_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::fd_t fd) -> coro::task<void>
+    {
+        co_await s->schedule_after(20ms);
+        const uint64_t value{42};
+        REQUIRE(::write(fd, &value, sizeof(value)) == sizeof(value));
+        co_return;
+    };
+
+    auto [status, written] =
+        coro::sync_wait(coro::when_all(make_poll_task(s, trigger_fds[0]), make_write_task(s, trigger_fds[1])));
+    (void)written;
+    REQUIRE(status.return_value() == coro::poll_status::event);
+
+    s->shutdown();
+    ::close(trigger_fds[0]);
+    ::close(trigger_fds[1]);
+}
+#endif
+
 TEST_CASE("~io_scheduler", "[io_scheduler]")
 {
     std::cerr << "[~io_scheduler]\n\n";
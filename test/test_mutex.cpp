@@ -142,6 +142,249 @@ TEST_CASE("mutex lock", "[mutex]")
     coro::sync_wait(make_task(m));
 }
 
+TEST_CASE("mutex fifo resume order", "[mutex]")
+{
+    coro::mutex           m{coro::resume_order_policy::fifo};
+    std::vector<uint64_t> order{};
+
+    auto make_waiter_task = [](coro::mutex& m, std::vector<uint64_t>& order, uint64_t id) -> coro::task<void>
+    {
+        auto lk = co_await m.scoped_lock();
+        order.emplace_back(id);
+        co_return;
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        co_await m.lock();
+
+        // Every waiter suspends in id order while the lock is held.
+        std::vector<coro::task<void>> waiters{};
+        for (uint64_t i = 1; i <= 5; ++i)
+        {
+            waiters.emplace_back(make_waiter_task(m, order, i));
+            waiters.back().resume();
+        }
+
+        m.unlock();
+        REQUIRE(order == std::vector<uint64_t>{1, 2, 3, 4, 5});
+        REQUIRE(m.try_lock());
+        m.unlock();
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+}
+
+TEST_CASE("mutex lifo resume order", "[mutex]")
+{
+    coro::mutex           m{};
+    std::vector<uint64_t> order{};
+
+    auto make_waiter_task = [](coro::mutex& m, std::vector<uint64_t>& order, uint64_t id) -> coro::task<void>
+    {
+        auto lk = co_await m.scoped_lock();
+        order.emplace_back(id);
+        co_return;
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        co_await m.lock();
+
+        std::vector<coro::task<void>> waiters{};
+        for (uint64_t i = 1; i <= 5; ++i)
+        {
+            waiters.emplace_back(make_waiter_task(m, order, i));
+            waiters.back().resume();
+        }
+
+        m.unlock();
+        REQUIRE(order == std::vector<uint64_t>{5, 4, 3, 2, 1});
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+}
+
+TEST_CASE("mutex unlock onto executor", "[mutex]")
+{
+    auto             tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::mutex      m{coro::resume_order_policy::fifo};
+    coro::event      waiter_resumed{};
+    std::thread::id  unlocker_thread{};
+    std::thread::id  waiter_thread{};
+    coro::task<void> waiter{};
+
+    auto make_waiter_task = [&]() -> coro::task<void>
+    {
+        auto lk       = co_await m.scoped_lock();
+        waiter_thread = std::this_thread::get_id();
+        waiter_resumed.set();
+        co_return;
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        auto lk = co_await m.scoped_lock();
+
+        waiter = make_waiter_task();
+        waiter.resume();
+        REQUIRE_FALSE(waiter.is_ready());
+
+        // The waiter must not run on this thread, unlock returns before it acquires the lock.
+        unlocker_thread = std::this_thread::get_id();
+        lk.unlock(tp);
+        co_await waiter_resumed;
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+    tp->shutdown();
+
+    REQUIRE(waiter.is_ready());
+    REQUIRE(waiter_thread != unlocker_thread);
+    REQUIRE(m.try_lock());
+    m.unlock(tp);
+    REQUIRE(m.try_lock());
+}
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+TEST_CASE("mutex try_lock_for timeout", "[mutex]")
+{
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::mutex m{};
+
+    auto make_holder_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::mutex& m) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await m.lock();
+        co_await s->yield_for(std::chrono::milliseconds{50});
+        m.unlock();
+        co_return;
+    };
+
+    auto make_timed_out_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::mutex& m) -> coro::task<bool>
+    {
+        co_await s->schedule();
+        auto acquired = co_await m.try_lock_for(s, std::chrono::milliseconds{5});
+        co_return acquired;
+    };
+
+    auto make_acquire_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::mutex& m) -> coro::task<bool>
+    {
+        co_await s->schedule();
+        auto acquired = co_await m.try_lock_for(s, std::chrono::seconds{5});
+        if (acquired)
+        {
+            m.unlock();
+        }
+        co_return acquired;
+    };
+
+    auto [holder, timed_out, acquired] = coro::sync_wait(
+        coro::when_all(make_holder_task(s, m), make_timed_out_task(s, m), make_acquire_task(s, m)));
+    (void)holder;
+
+    REQUIRE_FALSE(timed_out.return_value());
+    REQUIRE(acquired.return_value());
+
+    // The abandoned waiter was skipped and freed by the unlock.
+    REQUIRE(m.try_lock());
+    m.unlock();
+}
+
+TEST_CASE("mutex try_lock_for timed out waiter outlives its io_scheduler", "[mutex]")
+{
+    coro::mutex m{};
+    REQUIRE(m.try_lock());
+
+    {
+        auto s = coro::io_scheduler::make_unique(
+            coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+        auto make_timed_out_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::mutex& m) -> coro::task<bool>
+        {
+            co_await s->schedule();
+            auto acquired = co_await m.try_lock_for(s, std::chrono::milliseconds{5});
+            co_return acquired;
+        };
+
+        REQUIRE_FALSE(coro::sync_wait(make_timed_out_task(s, m)));
+    }
+
+    // The abandoned node is still queued, skipping it must not touch the destroyed io_scheduler.
+    m.unlock();
+    REQUIRE(m.try_lock());
+
+    // A second abandoned node is never reached by an unlock, the mutex frees it on destruction.
+    {
+        auto s = coro::io_scheduler::make_unique(
+            coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+        auto make_timed_out_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::mutex& m) -> coro::task<bool>
+        {
+            co_await s->schedule();
+            auto acquired = co_await m.try_lock_for(s, std::chrono::milliseconds{5});
+            co_return acquired;
+        };
+
+        REQUIRE_FALSE(coro::sync_wait(make_timed_out_task(s, m)));
+    }
+}
+
+TEST_CASE("mutex try_lock_for many waiters racing unlock and timeout", "[mutex]")
+{
+    auto s = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 4}});
+    coro::mutex           m{};
+    std::atomic<uint64_t> acquired{0};
+    std::atomic<uint64_t> timed_out{0};
+    std::atomic<uint64_t> holders{0};
+    std::atomic<uint64_t> overlaps{0};
+
+    auto make_task = [&](uint64_t id) -> coro::task<void>
+    {
+        co_await s->schedule();
+        for (uint64_t i = 0; i < 50; ++i)
+        {
+            auto locked = co_await m.try_lock_for(s, std::chrono::microseconds{(id % 5) * 100});
+            if (locked)
+            {
+                if (holders.fetch_add(1) != 0)
+                {
+                    overlaps++;
+                }
+                acquired++;
+                std::this_thread::sleep_for(std::chrono::microseconds{20});
+                holders.fetch_sub(1);
+                m.unlock();
+            }
+            else
+            {
+                timed_out++;
+            }
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t id = 0; id < 20; ++id)
+    {
+        tasks.emplace_back(make_task(id));
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(overlaps == 0);
+    REQUIRE(acquired + timed_out == 20 * 50);
+    REQUIRE(m.try_lock());
+    m.unlock();
+}
+
+#endif
+
 TEST_CASE("~mutex", "[mutex]")
 {
     std::cerr << "[~mutex]\n\n";
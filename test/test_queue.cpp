@@ -261,6 +261,92 @@ TEST_CASE("queue shutdown_drain non-empty consumer shutdown", "[queue]")
     std::cerr << "END queue issue-401\n";
 }
 
+TEST_CASE("queue push_range pop_batch", "[queue]")
+{
+    coro::queue<uint64_t> q{};
+
+    std::vector<uint64_t> input{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    REQUIRE(coro::sync_wait(q.push_range(input)) == coro::queue_produce_result::produced);
+    REQUIRE(q.size() == input.size());
+
+    std::array<uint64_t, 4> output{};
+    auto                    result = coro::sync_wait(q.pop_batch(output));
+    REQUIRE(result);
+    REQUIRE(result.value() == 4);
+    REQUIRE(output == std::array<uint64_t, 4>{1, 2, 3, 4});
+
+    std::vector<uint64_t> rest(16);
+    result = coro::sync_wait(q.pop_batch(rest));
+    REQUIRE(result);
+    REQUIRE(result.value() == 6);
+    for (uint64_t i = 0; i < 6; ++i)
+    {
+        REQUIRE(rest[i] == i + 5);
+    }
+    REQUIRE(q.empty());
+
+    coro::sync_wait(q.shutdown());
+    REQUIRE(coro::sync_wait(q.push_range(input)) == coro::queue_produce_result::stopped);
+    result = coro::sync_wait(q.pop_batch(output));
+    REQUIRE_FALSE(result);
+    REQUIRE(result.error() == coro::queue_consume_result::stopped);
+}
+
+TEST_CASE("queue push_range hands elements to waiters", "[queue]")
+{
+    const uint64_t        WAITERS = 5;
+    coro::queue<uint64_t> q{};
+    auto                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::queue<uint64_t>& q) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        std::array<uint64_t, 1> output{};
+        auto                    result = co_await q.pop_batch(output);
+        if (!result)
+        {
+            co_return 0;
+        }
+        co_return output[0];
+    };
+
+    auto make_producer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::queue<uint64_t>& q) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        // Let all of the consumers suspend on the empty queue.
+        while (tp->queue_size() > 0)
+        {
+            co_await tp->yield();
+        }
+
+        std::vector<uint64_t> input{};
+        for (uint64_t i = 1; i <= WAITERS * 2; ++i)
+        {
+            input.emplace_back(i);
+        }
+        co_await q.push_range(std::move(input));
+        co_return 0;
+    };
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    for (uint64_t i = 0; i < WAITERS; ++i)
+    {
+        tasks.emplace_back(make_consumer_task(tp, q));
+    }
+    tasks.emplace_back(make_producer_task(tp, q));
+
+    auto     results = coro::sync_wait(coro::when_all(std::move(tasks)));
+    uint64_t sum{0};
+    for (auto& r : results)
+    {
+        sum += r.return_value();
+    }
+
+    // Every waiter received exactly one of the first elements, the remaining elements are queued.
+    REQUIRE(sum == 15);
+    REQUIRE(q.size() == WAITERS);
+}
+
 TEST_CASE("~queue", "[queue]")
 {
     std::cerr << "[~queue]\n\n";
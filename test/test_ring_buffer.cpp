@@ -437,6 +437,136 @@ TEST_CASE("ring_buffer shutdown_drain non-empty consumer shutdown", "[ring_buffe
     std::cerr << "END ring_buffer issue-401\n";
 }
 
+TEST_CASE("ring_buffer produce_range consume_batch", "[ring_buffer]")
+{
+    const size_t                    iterations = 1'000;
+    coro::ring_buffer<uint64_t, 16> rb{};
+    auto tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+
+    auto make_producer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::ring_buffer<uint64_t, 16>& rb) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        std::vector<uint64_t> batch{};
+        for (uint64_t i = 1; i <= iterations; ++i)
+        {
+            batch.emplace_back(i);
+            // Produce batches larger than the ring buffer so the producer must suspend mid batch.
+            if (batch.size() == 40)
+            {
+                auto result = co_await rb.produce_range(batch);
+                REQUIRE(result == coro::ring_buffer_result::produce::produced);
+                batch.clear();
+            }
+        }
+        auto result = co_await rb.produce_range(std::move(batch));
+        REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        co_return;
+    };
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::ring_buffer<uint64_t, 16>& rb) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        std::array<uint64_t, 8> output{};
+        uint64_t                expected_next{1};
+        while (expected_next <= iterations)
+        {
+            auto result = co_await rb.consume_batch(output);
+            REQUIRE(result);
+            REQUIRE(result.value() > 0);
+            for (size_t i = 0; i < result.value(); ++i)
+            {
+                REQUIRE(output[i] == expected_next);
+                ++expected_next;
+            }
+        }
+        co_return expected_next - 1;
+    };
+
+    auto results = coro::sync_wait(coro::when_all(make_consumer_task(tp, rb), make_producer_task(tp, rb)));
+    REQUIRE(std::get<0>(results).return_value() == iterations);
+    REQUIRE(rb.empty());
+
+    coro::sync_wait(rb.shutdown());
+    std::array<uint64_t, 2> input{1, 2};
+    REQUIRE(coro::sync_wait(rb.produce_range(input)) == coro::ring_buffer_result::produce::stopped);
+    auto result = coro::sync_wait(rb.consume_batch(input));
+    REQUIRE_FALSE(result);
+    REQUIRE(result.error() == coro::ring_buffer_result::consume::stopped);
+}
+
+TEST_CASE("ring_buffer single slot many producers many consumers", "[ring_buffer]")
+{
+    // A single slot ring buffer is the tightest case for the slot sequence numbers, every produce fills
+    // the ring buffer and every consume empties it.
+    const uint64_t                 iterations = 10'000;
+    const size_t                   producers  = 4;
+    coro::ring_buffer<uint64_t, 1> rb{};
+    auto tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    auto make_producer_task =
+        [](std::unique_ptr<coro::thread_pool>& tp, coro::ring_buffer<uint64_t, 1>& rb, uint64_t iterations)
+        -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 1; i <= iterations; ++i)
+        {
+            auto result = co_await rb.produce(i);
+            REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        }
+        co_return;
+    };
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::ring_buffer<uint64_t, 1>& rb)
+        -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        uint64_t sum{0};
+        while (true)
+        {
+            auto result = co_await rb.consume();
+            if (!result)
+            {
+                break;
+            }
+            sum += *result;
+        }
+        co_return sum;
+    };
+
+    auto make_shutdown_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                                 coro::ring_buffer<uint64_t, 1>&     rb,
+                                 std::vector<coro::task<void>>       producer_tasks) -> coro::task<void>
+    {
+        co_await coro::when_all(std::move(producer_tasks));
+        co_await rb.shutdown_drain(tp);
+        co_return;
+    };
+
+    std::vector<coro::task<void>> producer_tasks{};
+    for (size_t i = 0; i < producers; ++i)
+    {
+        producer_tasks.emplace_back(make_producer_task(tp, rb, iterations));
+    }
+
+    std::vector<coro::task<uint64_t>> consumer_tasks{};
+    for (size_t i = 0; i < producers; ++i)
+    {
+        consumer_tasks.emplace_back(make_consumer_task(tp, rb));
+    }
+
+    auto [sums, shutdown] = coro::sync_wait(
+        coro::when_all(coro::when_all(std::move(consumer_tasks)), make_shutdown_task(tp, rb, std::move(producer_tasks))));
+    (void)shutdown;
+
+    uint64_t total{0};
+    for (auto& sum : sums.return_value())
+    {
+        total += sum.return_value();
+    }
+    REQUIRE(total == producers * iterations * (iterations + 1) / 2);
+    REQUIRE(rb.empty());
+}
+
 TEST_CASE("~ring_buffer", "[ring_buffer]")
 {
     std::cerr << "[~ring_buffer]\n\n";
@@ -0,0 +1,285 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+
+TEST_CASE("select", "[select]")
+{
+    std::cerr << "[select]\n\n";
+}
+
+TEST_CASE("select element already available", "[select]")
+{
+    coro::queue<uint64_t>    q1{};
+    coro::queue<std::string> q2{};
+
+    auto make_task = [](coro::queue<uint64_t>& q1, coro::queue<std::string>& q2) -> coro::task<void>
+    {
+        co_await q2.push("hello");
+
+        auto result = co_await coro::select(q1, q2);
+        REQUIRE(result.index() == 1);
+        REQUIRE(std::get<1>(result).value() == "hello");
+
+        co_await q1.push(42);
+        result = co_await coro::select(q1, q2);
+        REQUIRE(result.index() == 0);
+        REQUIRE(std::get<0>(result).value() == 42);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(q1, q2));
+    REQUIRE(q1.empty());
+    REQUIRE(q2.empty());
+}
+
+TEST_CASE("select suspends until a queue is pushed to", "[select]")
+{
+    coro::queue<uint64_t> q1{};
+    coro::queue<uint64_t> q2{};
+    coro::queue<uint64_t> q3{};
+
+    auto make_select_task =
+        [](coro::queue<uint64_t>& q1, coro::queue<uint64_t>& q2, coro::queue<uint64_t>& q3) -> coro::task<std::size_t>
+    {
+        auto result = co_await coro::select(q1, q2, q3);
+        REQUIRE(result.index() == 1);
+        REQUIRE(std::get<1>(result).value() == 7);
+        co_return result.index();
+    };
+
+    auto make_push_task = [](coro::queue<uint64_t>& q2) -> coro::task<void>
+    {
+        co_await q2.push(7);
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_select_task(q1, q2, q3), make_push_task(q2)));
+
+    // The waiters on the other queues were removed, pushing to them now stores the elements.
+    auto make_push_remaining_task = [](coro::queue<uint64_t>& q1, coro::queue<uint64_t>& q3) -> coro::task<void>
+    {
+        co_await q1.push(1);
+        co_await q3.push(3);
+        co_return;
+    };
+    coro::sync_wait(make_push_remaining_task(q1, q3));
+    REQUIRE(q1.size() == 1);
+    REQUIRE(q2.empty());
+    REQUIRE(q3.size() == 1);
+}
+
+TEST_CASE("select reports stopped queue", "[select]")
+{
+    coro::queue<uint64_t> q1{};
+    coro::queue<uint64_t> q2{};
+
+    auto make_select_task = [](coro::queue<uint64_t>& q1, coro::queue<uint64_t>& q2) -> coro::task<void>
+    {
+        auto result = co_await coro::select(q1, q2);
+        REQUIRE(result.index() == 0);
+        REQUIRE(std::get<0>(result).error() == coro::queue_consume_result::stopped);
+        co_return;
+    };
+
+    auto make_shutdown_task = [](coro::queue<uint64_t>& q1) -> coro::task<void>
+    {
+        co_await q1.shutdown();
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_select_task(q1, q2), make_shutdown_task(q1)));
+}
+
+TEST_CASE("select many producers every element consumed exactly once", "[select]")
+{
+    const uint64_t iterations = 10'000;
+    auto           tp         = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    coro::queue<uint64_t> q1{};
+    coro::queue<uint64_t> q2{};
+
+    auto make_producer_task =
+        [](std::unique_ptr<coro::thread_pool>& tp, coro::queue<uint64_t>& q, uint64_t iterations) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 1; i <= iterations; ++i)
+        {
+            co_await q.push(i);
+        }
+        co_return;
+    };
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                                 coro::queue<uint64_t>&              q1,
+                                 coro::queue<uint64_t>&              q2,
+                                 uint64_t                            iterations) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        uint64_t sum{0};
+        for (uint64_t i = 0; i < iterations * 2; ++i)
+        {
+            auto result = co_await coro::select(q1, q2);
+            if (result.index() == 0)
+            {
+                sum += std::get<0>(result).value();
+            }
+            else
+            {
+                sum += std::get<1>(result).value();
+            }
+        }
+        co_return sum;
+    };
+
+    auto [sum, p1, p2] = coro::sync_wait(coro::when_all(
+        make_consumer_task(tp, q1, q2, iterations),
+        make_producer_task(tp, q1, iterations),
+        make_producer_task(tp, q2, iterations)));
+    (void)p1;
+    (void)p2;
+
+    REQUIRE(sum.return_value() == iterations * (iterations + 1));
+    REQUIRE(q1.empty());
+    REQUIRE(q2.empty());
+}
+
+TEST_CASE("select ring_buffer and queue", "[select]")
+{
+    coro::ring_buffer<uint64_t, 4> rb{};
+    coro::queue<std::string>       q{};
+
+    auto make_select_task = [](coro::ring_buffer<uint64_t, 4>& rb, coro::queue<std::string>& q) -> coro::task<void>
+    {
+        co_await q.push("hello");
+        auto result = co_await coro::select(rb, q);
+        REQUIRE(result.index() == 1);
+        REQUIRE(std::get<1>(result).value() == "hello");
+
+        // Suspends until the ring buffer produces.
+        result = co_await coro::select(rb, q);
+        REQUIRE(result.index() == 0);
+        REQUIRE(std::get<0>(result).value() == 42);
+        co_return;
+    };
+
+    auto make_produce_task = [](coro::ring_buffer<uint64_t, 4>& rb) -> coro::task<void>
+    {
+        auto result = co_await rb.produce(42);
+        REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_select_task(rb, q), make_produce_task(rb)));
+    REQUIRE(rb.empty());
+    REQUIRE(q.empty());
+
+    // The waiter on the queue was removed, pushing to it now stores the element.
+    coro::sync_wait(q.push("world"));
+    REQUIRE(q.size() == 1);
+}
+
+TEST_CASE("select reports stopped ring_buffer", "[select]")
+{
+    coro::ring_buffer<uint64_t, 2> rb{};
+    coro::queue<uint64_t>          q{};
+
+    auto make_select_task = [](coro::ring_buffer<uint64_t, 2>& rb, coro::queue<uint64_t>& q) -> coro::task<void>
+    {
+        auto result = co_await coro::select(q, rb);
+        REQUIRE(result.index() == 1);
+        REQUIRE(std::get<1>(result).error() == coro::ring_buffer_result::consume::stopped);
+        co_return;
+    };
+
+    auto make_shutdown_task = [](coro::ring_buffer<uint64_t, 2>& rb) -> coro::task<void>
+    {
+        co_await rb.shutdown();
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_select_task(rb, q), make_shutdown_task(rb)));
+}
+
+TEST_CASE("select ring_buffer competing with a plain consumer", "[select]")
+{
+    const uint64_t iterations = 10'000;
+    auto           tp         = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    coro::ring_buffer<uint64_t, 16> rb{};
+    coro::queue<uint64_t>           q{};
+    std::atomic<uint64_t>           sum{0};
+    std::atomic<uint64_t>           consumed{0};
+
+    auto make_producer_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                                 coro::ring_buffer<uint64_t, 16>&    rb,
+                                 coro::queue<uint64_t>&              q,
+                                 uint64_t                            iterations) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 1; i <= iterations; ++i)
+        {
+            co_await rb.produce(i);
+            co_await q.push(i);
+        }
+        co_return;
+    };
+
+    // Both consumers stop once every element has been accounted for, the ring buffer is then shutdown to wake them.
+    auto make_select_task = [&](std::unique_ptr<coro::thread_pool>& tp) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        while (true)
+        {
+            auto result = co_await coro::select(rb, q);
+            if (result.index() == 0)
+            {
+                if (!std::get<0>(result).has_value())
+                {
+                    break;
+                }
+                sum += std::get<0>(result).value();
+            }
+            else
+            {
+                sum += std::get<1>(result).value();
+            }
+
+            if (++consumed == iterations * 2)
+            {
+                co_await rb.shutdown();
+                break;
+            }
+        }
+        co_return;
+    };
+
+    auto make_consumer_task = [&](std::unique_ptr<coro::thread_pool>& tp) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        while (true)
+        {
+            auto result = co_await rb.consume();
+            if (!result)
+            {
+                break;
+            }
+            sum += result.value();
+
+            if (++consumed == iterations * 2)
+            {
+                co_await rb.shutdown();
+                break;
+            }
+        }
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(
+        make_producer_task(tp, rb, q, iterations), make_select_task(tp), make_consumer_task(tp)));
+
+    REQUIRE(consumed == iterations * 2);
+    REQUIRE(sum == iterations * (iterations + 1));
+    REQUIRE(q.empty());
+}
@@ -284,6 +284,264 @@ TEST_CASE("semaphore max()", "[semaphore]")
     std::cerr << "END semaphore max()\n";
 }
 
+TEST_CASE("semaphore acquire and release counted", "[semaphore]")
+{
+    coro::semaphore<8> s{8};
+
+    auto make_task = [](coro::semaphore<8>& s) -> coro::task<void>
+    {
+        auto result = co_await s.acquire(5);
+        REQUIRE(result == coro::semaphore_acquire_result::acquired);
+        REQUIRE(s.value() == 3);
+        REQUIRE_FALSE(s.try_acquire(4));
+        REQUIRE(s.try_acquire(3));
+        REQUIRE(s.value() == 0);
+
+        co_await s.release(8);
+        REQUIRE(s.value() == 8);
+
+        // Releasing past max() is clamped.
+        co_await s.release(4);
+        REQUIRE(s.value() == 8);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(s));
+
+    REQUIRE_THROWS_AS(coro::sync_wait(s.acquire(9)), std::invalid_argument);
+    REQUIRE_THROWS_AS(coro::sync_wait(s.acquire(-1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(s.try_acquire(9), std::invalid_argument);
+    REQUIRE_THROWS_AS(s.try_acquire(-1), std::invalid_argument);
+    REQUIRE_THROWS_AS(coro::sync_wait(s.release(0)), std::invalid_argument);
+    REQUIRE_THROWS_AS(coro::sync_wait(s.release(-1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(coro::sync_wait(s.release(9)), std::invalid_argument);
+    REQUIRE(s.value() == 8);
+}
+
+TEST_CASE("semaphore large acquire is not starved by smaller acquires", "[semaphore]")
+{
+    coro::semaphore<4>    s{4};
+    coro::event           holder_release{};
+    std::vector<uint64_t> order{};
+
+    auto make_holder_task = [](coro::semaphore<4>& s, coro::event& e, std::vector<uint64_t>& order) -> coro::task<void>
+    {
+        co_await s.acquire(3);
+        order.emplace_back(1);
+        co_await e;
+        co_await s.release(3);
+        co_return;
+    };
+
+    auto make_large_task = [](coro::semaphore<4>& s, std::vector<uint64_t>& order) -> coro::task<void>
+    {
+        co_await s.acquire(4);
+        order.emplace_back(2);
+        co_await s.release(4);
+        co_return;
+    };
+
+    auto make_small_task = [](coro::semaphore<4>& s, std::vector<uint64_t>& order) -> coro::task<void>
+    {
+        // There is a resource available but the large acquire is queued first.
+        REQUIRE(s.value() == 1);
+        REQUIRE_FALSE(s.try_acquire());
+        co_await s.acquire(1);
+        order.emplace_back(3);
+        co_await s.release(1);
+        co_return;
+    };
+
+    auto make_release_task = [](coro::event& e) -> coro::task<void>
+    {
+        e.set();
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(
+        make_holder_task(s, holder_release, order),
+        make_large_task(s, order),
+        make_small_task(s, order),
+        make_release_task(holder_release)));
+
+    REQUIRE(order == std::vector<uint64_t>{1, 2, 3});
+    REQUIRE(s.value() == 4);
+}
+
+TEST_CASE("semaphore counted acquire many threads", "[semaphore]")
+{
+    const uint64_t        iterations = 1'000;
+    coro::semaphore<16>   s{16};
+    std::atomic<int64_t>  in_use{0};
+    std::atomic<uint64_t> violations{0};
+    auto                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+
+    auto make_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                        coro::semaphore<16>&                s,
+                        std::atomic<int64_t>&               in_use,
+                        std::atomic<uint64_t>&              violations,
+                        std::ptrdiff_t                      count,
+                        uint64_t                            iterations) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            co_await s.acquire(count);
+            if (in_use.fetch_add(count) + count > 16)
+            {
+                violations++;
+            }
+            in_use.fetch_sub(count);
+            co_await s.release(count);
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (std::ptrdiff_t count : {1, 3, 5, 16, 2, 7})
+    {
+        tasks.emplace_back(make_task(tp, s, in_use, violations, count, iterations));
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(violations == 0);
+    REQUIRE(s.value() == 16);
+}
+
+#ifdef LIBCORO_FEATURE_NETWORKING
+
+TEST_CASE("semaphore try_acquire_for timeout unblocks smaller waiters", "[semaphore]")
+{
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::semaphore<4> sem{4};
+    std::atomic<bool>  holder_released{false};
+
+    auto make_holder_task =
+        [](std::unique_ptr<coro::io_scheduler>& s, coro::semaphore<4>& sem, std::atomic<bool>& holder_released)
+        -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await sem.acquire(3);
+        co_await s->yield_for(std::chrono::milliseconds{100});
+        holder_released = true;
+        co_await sem.release(3);
+        co_return;
+    };
+
+    auto make_large_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::semaphore<4>& sem)
+        -> coro::task<coro::semaphore_acquire_result>
+    {
+        co_await s->schedule();
+        auto result = co_await sem.try_acquire_for(s, std::chrono::milliseconds{10}, 4);
+        co_return result;
+    };
+
+    auto make_small_task =
+        [](std::unique_ptr<coro::io_scheduler>& s, coro::semaphore<4>& sem, std::atomic<bool>& holder_released)
+        -> coro::task<bool>
+    {
+        co_await s->schedule();
+        // Queued behind the large acquire, it is granted as soon as the large acquire times out.
+        auto result = co_await sem.acquire(1);
+        REQUIRE(result == coro::semaphore_acquire_result::acquired);
+        auto before_release = !holder_released.load();
+        co_await sem.release(1);
+        co_return before_release;
+    };
+
+    auto [holder, large, small] = coro::sync_wait(coro::when_all(
+        make_holder_task(s, sem, holder_released), make_large_task(s, sem), make_small_task(s, sem, holder_released)));
+    (void)holder;
+
+    REQUIRE(large.return_value() == coro::semaphore_acquire_result::timeout);
+    REQUIRE(small.return_value());
+    REQUIRE(sem.value() == 4);
+    REQUIRE(coro::to_string(coro::semaphore_acquire_result::timeout) == "timeout");
+}
+
+TEST_CASE("semaphore try_acquire_for acquired before timeout", "[semaphore]")
+{
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::semaphore<2> sem{0};
+
+    auto make_waiter_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::semaphore<2>& sem)
+        -> coro::task<coro::semaphore_acquire_result>
+    {
+        co_await s->schedule();
+        auto result = co_await sem.try_acquire_for(s, std::chrono::seconds{30}, 2);
+        co_return result;
+    };
+
+    auto make_release_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::semaphore<2>& sem) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await sem.release(2);
+        co_return;
+    };
+
+    auto start              = std::chrono::steady_clock::now();
+    auto [waiter, released] = coro::sync_wait(coro::when_all(make_waiter_task(s, sem), make_release_task(s, sem)));
+    (void)released;
+
+    REQUIRE(waiter.return_value() == coro::semaphore_acquire_result::acquired);
+    REQUIRE(sem.value() == 0);
+
+    // The timer was disarmed when the resources were granted, shutdown does not wait on it.
+    s->shutdown();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds{5});
+}
+
+TEST_CASE("semaphore try_acquire_for many waiters racing release and timeout", "[semaphore]")
+{
+    auto s = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 4}});
+    coro::semaphore<2>    sem{2};
+    std::atomic<uint64_t> acquired{0};
+    std::atomic<uint64_t> timed_out{0};
+    std::atomic<int64_t>  in_use{0};
+    std::atomic<uint64_t> violations{0};
+
+    auto make_task = [&](uint64_t id) -> coro::task<void>
+    {
+        co_await s->schedule();
+        for (uint64_t i = 0; i < 50; ++i)
+        {
+            auto result = co_await sem.try_acquire_for(s, std::chrono::microseconds{(id % 5) * 100});
+            if (result == coro::semaphore_acquire_result::acquired)
+            {
+                if (in_use.fetch_add(1) >= 2)
+                {
+                    violations++;
+                }
+                acquired++;
+                std::this_thread::sleep_for(std::chrono::microseconds{20});
+                in_use.fetch_sub(1);
+                co_await sem.release();
+            }
+            else
+            {
+                timed_out++;
+            }
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t id = 0; id < 20; ++id)
+    {
+        tasks.emplace_back(make_task(id));
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(violations == 0);
+    REQUIRE(acquired + timed_out == 20 * 50);
+    REQUIRE(sem.value() == 2);
+}
+
+#endif
+
 TEST_CASE("~semaphore", "[semaphore]")
 {
     std::cerr << "[~semaphore]\n\n";
@@ -194,6 +194,198 @@ TEST_CASE("mutex single waiter not locked shared shared scope lock", "[shared_mu
     coro::sync_wait(m.unlock());
 }
 
+TEST_CASE("shared_mutex readers do not suspend without a writer", "[shared_mutex]")
+{
+    auto                                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::shared_mutex<coro::thread_pool> m{tp};
+
+    auto make_reader_task = [](coro::shared_mutex<coro::thread_pool>& m) -> coro::task<void>
+    {
+        // Every acquisition and release completes inline on this thread, nothing is scheduled on the pool.
+        for (size_t i = 0; i < 100; ++i)
+        {
+            co_await m.lock_shared();
+        }
+        REQUIRE_FALSE(m.try_lock());
+        for (size_t i = 0; i < 100; ++i)
+        {
+            co_await m.unlock_shared();
+        }
+        REQUIRE(m.try_lock());
+        co_await m.unlock();
+        co_return;
+    };
+
+    coro::sync_wait(make_reader_task(m));
+}
+
+TEST_CASE("shared_mutex writer waits for fast path readers", "[shared_mutex]")
+{
+    auto                                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::shared_mutex<coro::thread_pool> m{tp};
+    std::atomic<bool>                     acquired{false};
+
+    coro::sync_wait(m.lock_shared());
+
+    auto make_writer_task = [](std::unique_ptr<coro::thread_pool>&    tp,
+                               coro::shared_mutex<coro::thread_pool>& m,
+                               std::atomic<bool>&                     acquired) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        co_await m.lock();
+        acquired = true;
+        co_await m.unlock();
+        co_return;
+    };
+    REQUIRE(tp->spawn_detached(make_writer_task(tp, m, acquired)));
+
+    // Once the writer is waiting new readers are turned away so it cannot be starved.
+    while (m.try_lock_shared())
+    {
+        coro::sync_wait(m.unlock_shared());
+        std::this_thread::yield();
+    }
+    REQUIRE_FALSE(acquired);
+
+    // The final reader hands the lock to the writer.
+    coro::sync_wait(m.unlock_shared());
+    tp->shutdown();
+    REQUIRE(acquired);
+
+    REQUIRE(m.try_lock_shared());
+    coro::sync_wait(m.unlock_shared());
+    REQUIRE(m.try_lock());
+    coro::sync_wait(m.unlock());
+}
+
+TEST_CASE("shared_mutex slow path readers with a free internal mutex", "[shared_mutex]")
+{
+    auto                                  tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    coro::shared_mutex<coro::thread_pool> m{tp};
+    coro::event                           writer_locked{};
+    coro::event                           writer_release{};
+    std::atomic<bool>                     reader_acquired{false};
+
+    coro::sync_wait(m.lock_shared());
+
+    auto make_writer_task = [](std::unique_ptr<coro::thread_pool>&    tp,
+                               coro::shared_mutex<coro::thread_pool>& m,
+                               coro::event&                           writer_locked,
+                               coro::event&                           writer_release) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        co_await m.lock();
+        writer_locked.set();
+        co_await writer_release;
+        co_await m.unlock();
+        co_return;
+    };
+    REQUIRE(tp->spawn_detached(make_writer_task(tp, m, writer_locked, writer_release)));
+
+    while (m.try_lock_shared())
+    {
+        coro::sync_wait(m.unlock_shared());
+        std::this_thread::yield();
+    }
+
+    // The final reader takes the slow path to hand the lock to the writer, nothing holds the internal mutex
+    // so the hand over completes within the unlock.
+    coro::sync_wait(m.unlock_shared());
+    coro::sync_wait(writer_locked);
+
+    // A reader arriving while the writer holds the lock takes the slow path, again with the internal mutex free.
+    auto make_reader_task = [](coro::shared_mutex<coro::thread_pool>& m, std::atomic<bool>& reader_acquired)
+        -> coro::task<void>
+    {
+        co_await m.lock_shared();
+        reader_acquired = true;
+        co_await m.unlock_shared();
+        co_return;
+    };
+    auto make_release_task = [](coro::event& writer_release, std::atomic<bool>& reader_acquired) -> coro::task<void>
+    {
+        REQUIRE_FALSE(reader_acquired);
+        writer_release.set();
+        co_return;
+    };
+    coro::sync_wait(coro::when_all(
+        make_reader_task(m, reader_acquired), make_release_task(writer_release, reader_acquired)));
+    REQUIRE(reader_acquired);
+
+    tp->shutdown();
+    REQUIRE(m.try_lock());
+    coro::sync_wait(m.unlock());
+}
+
+TEST_CASE("shared_mutex readers and writers never overlap", "[shared_mutex]")
+{
+    const size_t iterations = 1'000;
+    auto         tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    coro::shared_mutex<coro::thread_pool> m{tp};
+    std::atomic<int64_t>                  readers{0};
+    std::atomic<int64_t>                  writers{0};
+    std::atomic<bool>                     overlapped{false};
+
+    auto make_reader_task = [](std::unique_ptr<coro::thread_pool>&    tp,
+                               coro::shared_mutex<coro::thread_pool>& m,
+                               std::atomic<int64_t>&                  readers,
+                               std::atomic<int64_t>&                  writers,
+                               std::atomic<bool>&                     overlapped,
+                               size_t                                 iterations) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            co_await m.lock_shared();
+            readers.fetch_add(1);
+            if (writers.load() != 0)
+            {
+                overlapped = true;
+            }
+            readers.fetch_sub(1);
+            co_await m.unlock_shared();
+        }
+        co_return;
+    };
+
+    auto make_writer_task = [](std::unique_ptr<coro::thread_pool>&    tp,
+                               coro::shared_mutex<coro::thread_pool>& m,
+                               std::atomic<int64_t>&                  readers,
+                               std::atomic<int64_t>&                  writers,
+                               std::atomic<bool>&                     overlapped,
+                               size_t                                 iterations) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (size_t i = 0; i < iterations / 10; ++i)
+        {
+            co_await m.lock();
+            if (writers.fetch_add(1) != 0 || readers.load() != 0)
+            {
+                overlapped = true;
+            }
+            writers.fetch_sub(1);
+            co_await m.unlock();
+            co_await tp->yield();
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        tasks.emplace_back(make_reader_task(tp, m, readers, writers, overlapped, iterations));
+    }
+    for (size_t i = 0; i < 2; ++i)
+    {
+        tasks.emplace_back(make_writer_task(tp, m, readers, writers, overlapped, iterations));
+    }
+
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+    REQUIRE_FALSE(overlapped);
+    REQUIRE(m.try_lock());
+    coro::sync_wait(m.unlock());
+}
+
 #ifdef LIBCORO_FEATURE_NETWORKING
 TEST_CASE("mutex many shared and exclusive waiters interleaved", "[shared_mutex]")
 {
@@ -286,6 +478,136 @@ TEST_CASE("mutex many shared and exclusive waiters interleaved", "[shared_mutex]
 
     coro::sync_wait(coro::when_all(make_shared_tasks_task(s, m, read_value), make_exclusive_task(s, m, read_value)));
 }
+
+TEST_CASE("shared_mutex try_lock_for timeout lets queued readers in", "[shared_mutex]")
+{
+    auto s = coro::io_scheduler::make_unique(coro::io_scheduler::options{
+        .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::shared_mutex<coro::io_scheduler> m{s};
+    std::atomic<bool>                      reader_released{false};
+
+    auto make_reader_task = [](std::unique_ptr<coro::io_scheduler>&    s,
+                               coro::shared_mutex<coro::io_scheduler>& m,
+                               std::atomic<bool>&                      reader_released) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await m.lock_shared();
+        co_await s->yield_for(std::chrono::milliseconds{100});
+        reader_released = true;
+        co_await m.unlock_shared();
+        co_return;
+    };
+
+    auto make_writer_task = [](std::unique_ptr<coro::io_scheduler>&    s,
+                               coro::shared_mutex<coro::io_scheduler>& m) -> coro::task<bool>
+    {
+        co_await s->schedule();
+        auto locked = co_await m.try_lock_for(s, std::chrono::milliseconds{10});
+        co_return locked;
+    };
+
+    auto make_queued_reader_task = [](std::unique_ptr<coro::io_scheduler>&    s,
+                                      coro::shared_mutex<coro::io_scheduler>& m,
+                                      std::atomic<bool>&                      reader_released) -> coro::task<bool>
+    {
+        co_await s->schedule();
+        // Queued behind the writer, it joins the first reader once the writer gives up.
+        auto locked = co_await m.try_lock_shared_for(s, std::chrono::seconds{5});
+        auto before_release = locked && !reader_released.load();
+        co_await m.unlock_shared();
+        co_return before_release;
+    };
+
+    auto [reader, writer, queued_reader] = coro::sync_wait(coro::when_all(
+        make_reader_task(s, m, reader_released),
+        make_writer_task(s, m),
+        make_queued_reader_task(s, m, reader_released)));
+    (void)reader;
+
+    REQUIRE_FALSE(writer.return_value());
+    REQUIRE(queued_reader.return_value());
+
+    // The reader fast path is open again and the writer can now take the lock.
+    REQUIRE(m.try_lock_shared());
+    coro::sync_wait(m.unlock_shared());
+
+    auto make_lock_task = [](std::unique_ptr<coro::io_scheduler>& s, coro::shared_mutex<coro::io_scheduler>& m)
+        -> coro::task<bool>
+    {
+        auto locked = co_await m.try_lock_for(s, std::chrono::milliseconds{10});
+        if (locked)
+        {
+            co_await m.unlock();
+        }
+        co_return locked;
+    };
+    REQUIRE(coro::sync_wait(make_lock_task(s, m)));
+}
+
+TEST_CASE("shared_mutex try_lock_for many waiters racing unlock and timeout", "[shared_mutex]")
+{
+    auto s = coro::io_scheduler::make_unique(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 4}});
+    coro::shared_mutex<coro::io_scheduler> m{s};
+    std::atomic<uint64_t>                  acquired{0};
+    std::atomic<uint64_t>                  timed_out{0};
+    std::atomic<uint64_t>                  writers{0};
+    std::atomic<uint64_t>                  readers{0};
+    std::atomic<uint64_t>                  overlaps{0};
+
+    auto make_task = [&](uint64_t id) -> coro::task<void>
+    {
+        co_await s->schedule();
+        auto timeout = std::chrono::microseconds{(id % 5) * 100};
+        for (uint64_t i = 0; i < 50; ++i)
+        {
+            // Every third waiter is a writer so timed out writers keep unblocking queued readers.
+            if (id % 3 == 0)
+            {
+                if (co_await m.try_lock_for(s, timeout))
+                {
+                    if (writers.fetch_add(1) != 0 || readers.load() != 0)
+                    {
+                        overlaps++;
+                    }
+                    acquired++;
+                    std::this_thread::sleep_for(std::chrono::microseconds{20});
+                    writers.fetch_sub(1);
+                    co_await m.unlock();
+                    continue;
+                }
+            }
+            else if (co_await m.try_lock_shared_for(s, timeout))
+            {
+                readers.fetch_add(1);
+                if (writers.load() != 0)
+                {
+                    overlaps++;
+                }
+                acquired++;
+                std::this_thread::sleep_for(std::chrono::microseconds{20});
+                readers.fetch_sub(1);
+                co_await m.unlock_shared();
+                continue;
+            }
+            timed_out++;
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (uint64_t id = 0; id < 20; ++id)
+    {
+        tasks.emplace_back(make_task(id));
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(overlaps == 0);
+    REQUIRE(acquired + timed_out == 20 * 50);
+    REQUIRE(m.try_lock());
+    coro::sync_wait(m.unlock());
+}
+
 #endif // #ifdef LIBCORO_FEATURE_NETWORKING
 
 TEST_CASE("~shared_mutex", "[shared_mutex]")
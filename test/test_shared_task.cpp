@@ -0,0 +1,127 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+#include <string>
+
+TEST_CASE("shared_task", "[shared_task]")
+{
+    std::cerr << "[shared_task]\n\n";
+}
+
+TEST_CASE("shared_task many awaiters run the work once", "[shared_task]")
+{
+    coro::event e{};
+    uint64_t    runs{0};
+
+    auto make_shared = [](coro::event& e, uint64_t& runs) -> coro::shared_task<std::string>
+    {
+        ++runs;
+        co_await e;
+        co_return "hello";
+    };
+
+    auto make_awaiter = [](coro::shared_task<std::string> shared) -> coro::task<std::string>
+    {
+        const auto& value = co_await shared;
+        co_return value;
+    };
+
+    auto shared = make_shared(e, runs);
+
+    std::vector<coro::task<std::string>> awaiters{};
+    for (int i = 0; i < 5; ++i)
+    {
+        awaiters.emplace_back(make_awaiter(shared));
+        awaiters.back().resume();
+    }
+    REQUIRE(runs == 1);
+    REQUIRE_FALSE(shared.is_ready());
+
+    e.set();
+    REQUIRE(shared.is_ready());
+    for (auto& awaiter : awaiters)
+    {
+        REQUIRE(awaiter.is_ready());
+        REQUIRE(awaiter.promise().result() == "hello");
+    }
+
+    // Awaiting a completed shared_task returns the result without running it again.
+    auto late = make_awaiter(shared);
+    late.resume();
+    REQUIRE(late.is_ready());
+    REQUIRE(late.promise().result() == "hello");
+    REQUIRE(runs == 1);
+}
+
+TEST_CASE("shared_task exception is rethrown to every awaiter", "[shared_task]")
+{
+    auto make_shared = []() -> coro::shared_task<void>
+    {
+        throw std::runtime_error{"failed"};
+        co_return;
+    };
+
+    auto make_awaiter = [](coro::shared_task<void> shared) -> coro::task<bool>
+    {
+        try
+        {
+            co_await shared;
+        }
+        catch (const std::runtime_error&)
+        {
+            co_return true;
+        }
+        co_return false;
+    };
+
+    auto shared              = make_shared();
+    auto [first, second]     = coro::sync_wait(coro::when_all(make_awaiter(shared), make_awaiter(shared)));
+    REQUIRE(first.return_value());
+    REQUIRE(second.return_value());
+}
+
+TEST_CASE("shared_task awaited concurrently from many threads", "[shared_task]")
+{
+    const uint64_t        awaiters = 1'000;
+    auto                  tp       = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    std::atomic<uint64_t> runs{0};
+
+    auto make_shared = [](std::unique_ptr<coro::thread_pool>& tp, std::atomic<uint64_t>& runs)
+        -> coro::shared_task<uint64_t>
+    {
+        co_await tp->yield();
+        ++runs;
+        co_return 42;
+    };
+
+    auto make_awaiter = [](std::unique_ptr<coro::thread_pool>& tp, coro::shared_task<uint64_t> shared)
+        -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        co_return co_await shared;
+    };
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    {
+        auto shared = make_shared(tp, runs);
+        for (uint64_t i = 0; i < awaiters; ++i)
+        {
+            tasks.emplace_back(make_awaiter(tp, shared));
+        }
+        // The awaiters own the shared_task once this copy is dropped.
+    }
+
+    auto results = coro::sync_wait(coro::when_all(std::move(tasks)));
+    REQUIRE(runs == 1);
+    for (const auto& result : results)
+    {
+        REQUIRE(result.return_value() == 42);
+    }
+}
+
+TEST_CASE("~shared_task", "[shared_task]")
+{
+    std::cerr << "[~shared_task]\n\n";
+}
@@ -0,0 +1,124 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+TEST_CASE("single_flight", "[single_flight]")
+{
+    std::cerr << "[single_flight]\n\n";
+}
+
+TEST_CASE("single_flight de-duplicates concurrent calls per key", "[single_flight]")
+{
+    const uint64_t                            callers = 500;
+    auto                                      tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 4});
+    coro::single_flight<std::string, uint64_t> flights{};
+    coro::event                               backend_ready{};
+    std::atomic<uint64_t>                     backend_calls{0};
+    std::atomic<uint64_t>                     joined{0};
+
+    auto fetch = [&](std::string key) -> coro::task<uint64_t>
+    {
+        ++backend_calls;
+        co_await backend_ready;
+        co_return key.size();
+    };
+
+    auto make_caller = [&](std::string key) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        ++joined;
+        auto work = [&fetch, key]() { return fetch(key); };
+        co_return co_await flights.run(key, work);
+    };
+
+    auto make_release = [&]() -> coro::task<void>
+    {
+        // Wait until every caller joined the two flights before the backend responds.
+        co_await tp->schedule();
+        while (joined.load() != callers)
+        {
+            co_await tp->yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        backend_ready.set(tp);
+        co_return;
+    };
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    for (uint64_t i = 0; i < callers; ++i)
+    {
+        tasks.emplace_back(make_caller((i % 2 == 0) ? "even" : "odd-key"));
+    }
+
+    auto [results, released] = coro::sync_wait(coro::when_all(coro::when_all(std::move(tasks)), make_release()));
+    (void)released;
+
+    uint64_t i{0};
+    for (const auto& result : results.return_value())
+    {
+        REQUIRE(result.return_value() == ((i++ % 2 == 0) ? 4 : 7));
+    }
+    REQUIRE(backend_calls == 2);
+    REQUIRE(flights.size() == 0);
+}
+
+TEST_CASE("single_flight starts new work once the flight completes", "[single_flight]")
+{
+    coro::single_flight<int, int> flights{};
+    int                           calls{0};
+
+    auto make_task = [](coro::single_flight<int, int>& flights, int& calls) -> coro::task<void>
+    {
+        auto work = [&calls]() -> coro::task<int> { co_return ++calls; };
+
+        auto first = co_await flights.run(1, work);
+        REQUIRE(first == 1);
+        REQUIRE(flights.size() == 0);
+
+        auto second = co_await flights.run(1, work);
+        REQUIRE(second == 2);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(flights, calls));
+    REQUIRE(calls == 2);
+}
+
+TEST_CASE("single_flight forgets the key when the work throws", "[single_flight]")
+{
+    coro::single_flight<int, void> flights{};
+
+    auto make_task = [](coro::single_flight<int, void>& flights) -> coro::task<void>
+    {
+        auto work = []() -> coro::task<void>
+        {
+            throw std::runtime_error{"backend unavailable"};
+            co_return;
+        };
+
+        bool thrown{false};
+        try
+        {
+            co_await flights.run(1, work);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+        REQUIRE(flights.size() == 0);
+        co_return;
+    };
+
+    coro::sync_wait(make_task(flights));
+}
+
+TEST_CASE("~single_flight", "[single_flight]")
+{
+    std::cerr << "[~single_flight]\n\n";
+}
@@ -0,0 +1,193 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+
+TEST_CASE("spsc_channel", "[spsc_channel]")
+{
+    std::cerr << "[spsc_channel]\n\n";
+}
+
+TEST_CASE("spsc_channel single element", "[spsc_channel]")
+{
+    const size_t                    iterations = 10;
+    coro::spsc_channel<uint64_t, 1> ch{};
+
+    std::vector<uint64_t> output{};
+
+    auto make_producer_task = [](coro::spsc_channel<uint64_t, 1>& ch, size_t iterations) -> coro::task<void>
+    {
+        for (size_t i = 1; i <= iterations; ++i)
+        {
+            auto result = co_await ch.produce(i);
+            REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        }
+        co_return;
+    };
+
+    auto make_consumer_task =
+        [](coro::spsc_channel<uint64_t, 1>& ch, size_t iterations, std::vector<uint64_t>& output) -> coro::task<void>
+    {
+        for (size_t i = 1; i <= iterations; ++i)
+        {
+            auto expected = co_await ch.consume();
+            output.emplace_back(std::move(*expected));
+        }
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_producer_task(ch, iterations), make_consumer_task(ch, iterations, output)));
+
+    REQUIRE(output.size() == iterations);
+    for (size_t i = 1; i <= iterations; ++i)
+    {
+        REQUIRE(output[i - 1] == i);
+    }
+
+    REQUIRE(ch.empty());
+}
+
+TEST_CASE("spsc_channel try_produce try_consume", "[spsc_channel]")
+{
+    coro::spsc_channel<std::string, 2> ch{};
+
+    REQUIRE(ch.try_consume() == std::nullopt);
+
+    std::string a{"a"};
+    REQUIRE(ch.try_produce(a));
+    REQUIRE(ch.try_produce(std::string{"b"}));
+
+    std::string c{"c"};
+    REQUIRE_FALSE(ch.try_produce(std::move(c)));
+    // The element is not moved from when the channel is full.
+    REQUIRE(c == "c");
+    REQUIRE(ch.size() == 2);
+
+    REQUIRE(ch.try_consume() == "a");
+    REQUIRE(ch.try_consume() == "b");
+    REQUIRE(ch.try_consume() == std::nullopt);
+    REQUIRE(ch.empty());
+}
+
+TEST_CASE("spsc_channel producer and consumer on separate threads", "[spsc_channel]")
+{
+    const size_t                     iterations = 1'000'000;
+    coro::spsc_channel<uint64_t, 64> ch{};
+
+    auto producer_tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+    auto consumer_tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+
+    auto make_producer_task =
+        [](std::unique_ptr<coro::thread_pool>& tp, coro::spsc_channel<uint64_t, 64>& ch, size_t iterations)
+        -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (size_t i = 1; i <= iterations; ++i)
+        {
+            auto result = co_await ch.produce(i);
+            if (result != coro::ring_buffer_result::produce::produced)
+            {
+                break;
+            }
+        }
+        ch.shutdown();
+        co_return;
+    };
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp,
+                                 coro::spsc_channel<uint64_t, 64>&   ch) -> coro::task<std::pair<uint64_t, bool>>
+    {
+        co_await tp->schedule();
+        uint64_t expected_value{1};
+        bool     in_order{true};
+        while (true)
+        {
+            auto result = co_await ch.consume();
+            if (!result)
+            {
+                break;
+            }
+            in_order &= (*result == expected_value);
+            ++expected_value;
+        }
+        co_return std::pair<uint64_t, bool>{expected_value - 1, in_order};
+    };
+
+    auto [produced, consumed] = coro::sync_wait(
+        coro::when_all(make_producer_task(producer_tp, ch, iterations), make_consumer_task(consumer_tp, ch)));
+    (void)produced;
+
+    auto [count, in_order] = consumed.return_value();
+    REQUIRE(count == iterations);
+    REQUIRE(in_order);
+    REQUIRE(ch.empty());
+}
+
+TEST_CASE("spsc_channel shutdown drains remaining elements", "[spsc_channel]")
+{
+    coro::spsc_channel<uint64_t, 4> ch{};
+
+    auto make_producer_task = [](coro::spsc_channel<uint64_t, 4>& ch) -> coro::task<void>
+    {
+        for (uint64_t i = 1; i <= 3; ++i)
+        {
+            auto result = co_await ch.produce(i);
+            REQUIRE(result == coro::ring_buffer_result::produce::produced);
+        }
+        ch.shutdown();
+
+        auto result = co_await ch.produce(4);
+        REQUIRE(result == coro::ring_buffer_result::produce::stopped);
+        co_return;
+    };
+
+    auto make_consumer_task = [](coro::spsc_channel<uint64_t, 4>& ch) -> coro::task<uint64_t>
+    {
+        uint64_t sum{0};
+        while (true)
+        {
+            auto result = co_await ch.consume();
+            if (!result)
+            {
+                REQUIRE(result.error() == coro::ring_buffer_result::consume::stopped);
+                break;
+            }
+            sum += *result;
+        }
+        co_return sum;
+    };
+
+    coro::sync_wait(make_producer_task(ch));
+    REQUIRE(ch.is_shutdown());
+
+    auto sum = coro::sync_wait(make_consumer_task(ch));
+    REQUIRE(sum == 6);
+}
+
+TEST_CASE("spsc_channel shutdown wakes suspended consumer", "[spsc_channel]")
+{
+    coro::spsc_channel<uint64_t, 4> ch{};
+    auto                            tp = coro::thread_pool::make_unique(coro::thread_pool::options{.thread_count = 1});
+
+    auto make_consumer_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::spsc_channel<uint64_t, 4>& ch)
+        -> coro::task<bool>
+    {
+        co_await tp->schedule();
+        auto result = co_await ch.consume();
+        co_return !result.has_value() && result.error() == coro::ring_buffer_result::consume::stopped;
+    };
+
+    auto make_shutdown_task = [](std::unique_ptr<coro::thread_pool>& tp, coro::spsc_channel<uint64_t, 4>& ch)
+        -> coro::task<void>
+    {
+        co_await tp->schedule();
+        ch.shutdown();
+        co_return;
+    };
+
+    auto [stopped, shutdown] =
+        coro::sync_wait(coro::when_all(make_consumer_task(tp, ch), make_shutdown_task(tp, ch)));
+    (void)shutdown;
+    REQUIRE(stopped.return_value());
+}